@@ -129,6 +129,22 @@ namespace pp
 		{
 			return get<void(unsigned char*)>(17)(ptr);
 		}
+
+		const char *stats_name(cell index) const
+		{
+			return get<const char*(cell index)>(18)(index);
+		}
+
+		// The values are the number of live objects, the peak number, allocations and frees since the last reset, and the approximate number of bytes
+		cell stats_get(const char *name, cell *values, cell size) const
+		{
+			return get<cell(const char *name, cell *values, cell size)>(19)(name, values, size);
+		}
+
+		void stats_reset() const
+		{
+			return get<void()>(20)();
+		}
 	};
 
 	class tag_table : public api_table
@@ -9,6 +9,7 @@
 #include "modules/strings.h"
 #include "modules/variants.h"
 #include "modules/containers.h"
+#include "modules/spatial.h"
 #include "modules/tags.h"
 #include "modules/debug.h"
 #include "modules/expressions.h"
@@ -19,6 +20,8 @@
 #include <list>
 #include <limits>
 #include <cstdlib>
+#include <chrono>
+#include <algorithm>
 
 logprintf_t logprintf;
 extern void *pAMXFunctions;
@@ -73,9 +76,14 @@ PLUGIN_EXPORT void PLUGIN_CALL Unload() noexcept
 	map_pool.clear();
 	linked_list_pool.clear();
 	pool_pool.clear();
+	heap_pool.clear();
+	deque_pool.clear();
+	bitset_pool.clear();
+	spatial_pool.clear();
 	expression_pool.clear();
 	iter_pool.clear();
 	tasks::clear();
+	strings::clear_interned();
 	strings::pool.clear();
 	
 	if(!isenv("PAWNPLUS_NO_AMX_HOOKS"))
@@ -111,6 +119,8 @@ PLUGIN_EXPORT int PLUGIN_CALL AmxUnload(AMX *amx) noexcept
 void pp_tick()
 {
 	tasks::tick();
+	gc_continue();
+	map_rehash_tick(map_rehash_slots);
 	Threads::SyncThreads();
 }
 
@@ -122,17 +132,111 @@ PLUGIN_EXPORT void PLUGIN_CALL ProcessTick() noexcept
 
 std::list<void(*)()> gc_list;
 
+size_t gc_max_objects = 0;
+size_t gc_max_time = 0;
+size_t map_rehash_slots = 65536;
+
+template <class ObjType>
+static bool gc_step(object_pool<ObjType> &pool, size_t &budget, const std::chrono::steady_clock::time_point &deadline)
+{
+	// the clock is checked only once per batch
+	constexpr size_t batch_size = 64;
+	while(pool.pending_size() > 0)
+	{
+		if(budget == 0)
+		{
+			return false;
+		}
+		budget -= pool.collect_pending(std::min(budget, batch_size));
+		if(gc_max_time != 0 && std::chrono::steady_clock::now() >= deadline)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static void gc_set_collecting(bool collecting)
+{
+	variants::pool.set_collecting(collecting);
+	handle_pool.set_collecting(collecting);
+	expression_pool.set_collecting(collecting);
+	iter_pool.set_collecting(collecting);
+	strings::pool.set_collecting(collecting);
+}
+
+static size_t gc_pending()
+{
+	return variants::pool.pending_size() + handle_pool.pending_size() + expression_pool.pending_size() + iter_pool.pending_size() + strings::pool.pending_size();
+}
+
+// Objects released by the destroyed ones are destroyed in the same pass, even if their pool was already visited
+static void gc_run(size_t budget)
+{
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(gc_max_time);
+	gc_set_collecting(true);
+	while(gc_pending() > 0)
+	{
+		if(!(gc_step(variants::pool, budget, deadline) &&
+			gc_step(handle_pool, budget, deadline) &&
+			gc_step(expression_pool, budget, deadline) &&
+			gc_step(iter_pool, budget, deadline) &&
+			gc_step(strings::pool, budget, deadline)))
+		{
+			break;
+		}
+	}
+	gc_set_collecting(false);
+}
+
+// Destroys the local objects of a pool immediately, before the next pool is cleared
+template <class ObjType>
+static void gc_clear(object_pool<ObjType> &pool)
+{
+	pool.clear_tmp();
+	pool.collect_pending(std::numeric_limits<size_t>::max());
+}
+
+static void gc_clear_all()
+{
+	gc_set_collecting(true);
+	do{
+		gc_clear(variants::pool);
+		gc_clear(handle_pool);
+		gc_clear(expression_pool);
+		gc_clear(iter_pool);
+		gc_clear(strings::pool);
+	}while(gc_pending() > 0);
+	gc_set_collecting(false);
+}
+
 void gc_collect()
 {
-	variants::pool.clear_tmp();
-	handle_pool.clear_tmp();
-	expression_pool.clear_tmp();
-	iter_pool.clear_tmp();
-	strings::pool.clear_tmp();
+	if(gc_max_objects == 0 && gc_max_time == 0)
+	{
+		gc_clear_all();
+	}else{
+		variants::pool.clear_tmp();
+		handle_pool.clear_tmp();
+		expression_pool.clear_tmp();
+		iter_pool.clear_tmp();
+		strings::pool.clear_tmp();
+	}
 	for(const auto &it : gc_list)
 	{
 		it();
 	}
+	gc_continue();
+}
+
+void gc_continue()
+{
+	gc_run(gc_max_objects != 0 ? gc_max_objects : std::numeric_limits<size_t>::max());
+}
+
+void gc_finish()
+{
+	gc_clear_all();
 }
 
 void *gc_register(void(*func)())
@@ -48,7 +48,13 @@ bool isenv(const char *env_var);
 
 void pp_tick();
 
+extern size_t gc_max_objects;
+extern size_t gc_max_time;
+extern size_t map_rehash_slots;
+
 void gc_collect();
+void gc_continue();
+void gc_finish();
 void *gc_register(void(*func)());
 void gc_unregister(void *id);
 
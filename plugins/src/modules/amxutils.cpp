@@ -2,7 +2,7 @@
 #include "errors.h"
 #include <cstring>
 
-aux::shared_id_set_pool<amx_var_info> amx_var_pool;
+aux::slot_map_pool<amx_var_info> amx_var_pool;
 
 cell amx_var_info::free()
 {
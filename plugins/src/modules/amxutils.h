@@ -2,7 +2,7 @@
 #define AMXUTILS_H_INCLUDED
 
 #include "amxinfo.h"
-#include "utils/shared_id_set_pool.h"
+#include "utils/slot_map_pool.h"
 #include "sdk/amx/amx.h"
 
 struct fork_info_extra : public amx::extra
@@ -16,7 +16,7 @@ struct fork_info_extra : public amx::extra
 	}
 };
 
-class amx_var_info
+class amx_var_info : public aux::slot_map_hook
 {
 	amx::handle _amx;
 	cell _addr;
@@ -49,7 +49,7 @@ public:
 	bool fill(unsigned char value);
 };
 
-extern aux::shared_id_set_pool<amx_var_info> amx_var_pool;
+extern aux::slot_map_pool<amx_var_info> amx_var_pool;
 
 inline void amx_encode_value(cell *str, char signature, ucell value)
 {
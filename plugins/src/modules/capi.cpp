@@ -7,6 +7,7 @@
 #include "strings.h"
 #include "tasks.h"
 #include "serialize.h"
+#include "stats.h"
 #include "errors.h"
 #include "natives.h"
 
@@ -155,6 +156,35 @@ static func_ptr main_functions[] = {
 	{
 		delete[] ptr;
 	},
+	+[]/*stats_name*/(cell index) -> const char*
+	{
+		if(index < 0)
+		{
+			return nullptr;
+		}
+		return stats::name(static_cast<size_t>(index));
+	},
+	+[]/*stats_get*/(const char *name, cell *values, cell size) -> cell
+	{
+		size_t index;
+		if(!stats::find(name, index))
+		{
+			return 0;
+		}
+		auto value = stats::get(index);
+		const size_t fields[] = {value.live, value.peak, value.allocations, value.frees, value.bytes};
+		cell count = 0;
+		for(size_t field : fields)
+		{
+			if(count >= size) break;
+			values[count++] = static_cast<cell>(field);
+		}
+		return count;
+	},
+	+[]/*stats_reset*/() -> void
+	{
+		stats::reset();
+	},
 	nullptr
 };
 
@@ -598,7 +628,9 @@ using const_string_ptr = typename std::remove_reference<typename object_pool<str
 static func_ptr string_functions[] = {
 	+[]/*new_string*/() -> void*
 	{
-		return &strings::pool.add();
+		auto &obj = strings::pool.add();
+		strings::pool.pin(obj);
+		return &obj;
 	},
 	+[]/*delete_string*/(void *str) -> void
 	{
@@ -613,6 +645,7 @@ static func_ptr string_functions[] = {
 		string_ptr ptr;
 		if(strings::pool.get_by_id(id, ptr))
 		{
+			strings::pool.pin(*ptr);
 			return ptr;
 		}
 		return nullptr;
@@ -664,7 +697,9 @@ using const_variant_ptr = typename std::remove_reference<typename object_pool<dy
 static func_ptr variant_functions[] = {
 	+[]/*new_variant*/() -> void*
 	{
-		return &variants::pool.add();
+		auto &obj = variants::pool.add();
+		variants::pool.pin(obj);
+		return &obj;
 	},
 	+[]/*delete_variant*/(void *var) -> void
 	{
@@ -679,6 +714,7 @@ static func_ptr variant_functions[] = {
 		variant_ptr ptr;
 		if(variants::pool.get_by_id(id, ptr))
 		{
+			variants::pool.pin(*ptr);
 			return ptr;
 		}
 		return nullptr;
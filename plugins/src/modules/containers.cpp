@@ -1,51 +1,71 @@
 #include "containers.h"
-
-aux::shared_id_set_pool<list_t> list_pool;
-aux::shared_id_set_pool<map_t> map_pool;
-aux::shared_id_set_pool<linked_list_t> linked_list_pool;
-aux::shared_id_set_pool<pool_t> pool_pool;
+#include "tag_ops.h"
+#include "expressions.h"
+#include "utils/radix_sort.h"
+
+#include <algorithm>
+
+aux::slot_map_pool<list_t> list_pool;
+aux::slot_map_pool<map_t> map_pool;
+aux::slot_map_pool<linked_list_t> linked_list_pool;
+aux::slot_map_pool<pool_t> pool_pool;
+aux::slot_map_pool<heap_t> heap_pool;
+aux::slot_map_pool<deque_t> deque_pool;
+aux::slot_map_pool<bitset_t> bitset_pool;
 object_pool<dyn_iterator> iter_pool;
 object_pool<handle_t> handle_pool;
 
 void list_t::push_back(dyn_object &&value)
 {
-	bool invalidate = data.size() == data.capacity();
-	data.push_back(std::move(value));
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	bool invalidate = data().size() == data().capacity();
+	data().push_back(std::move(value));
 	if(invalidate)
 	{
 		++revision;
 	}
+	inserted(before, copies);
 }
 
 void list_t::push_back(const dyn_object &value)
 {
-	bool invalidate = data.size() == data.capacity();
-	data.push_back(value);
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	bool invalidate = data().size() == data().capacity();
+	data().push_back(value);
 	if(invalidate)
 	{
 		++revision;
 	}
+	inserted(before, copies);
 }
 
 auto list_t::insert(iterator position, dyn_object &&value) -> iterator
 {
-	bool invalidate = position == data.end() ? data.size() == data.capacity() : true;
-	auto it = data.insert(position, std::move(value));
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	bool invalidate = position == data().end() ? data().size() == data().capacity() : true;
+	auto it = data().insert(position, std::move(value));
 	if(invalidate)
 	{
 		++revision;
 	}
+	inserted(before, copies);
 	return it;
 }
 
 auto list_t::insert(iterator position, const dyn_object &value) -> iterator
 {
-	bool invalidate = position == data.end() ? data.size() == data.capacity() : true;
-	auto it = data.insert(position, value);
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	bool invalidate = position == data().end() ? data().size() == data().capacity() : true;
+	auto it = data().insert(position, value);
 	if(invalidate)
 	{
 		++revision;
 	}
+	inserted(before, copies);
 	return it;
 }
 
@@ -69,10 +89,27 @@ bool list_t::insert_dyn(iterator position, const std::type_info &type, const voi
 	return false;
 }
 
+bool list_t::clone_is_copy() const
+{
+	if(clone_copies < 0)
+	{
+		clone_copies = 1;
+		for(const auto &obj : data())
+		{
+			if(!obj.clone_is_copy())
+			{
+				clone_copies = 0;
+				break;
+			}
+		}
+	}
+	return clone_copies != 0;
+}
+
 void list_t::resize(size_t count)
 {
-	bool invalidate = count < data.size() || count > data.capacity();
-	data.resize(count);
+	bool invalidate = count < data().size() || count > data().capacity();
+	data().resize(count);
 	if(invalidate)
 	{
 		++revision;
@@ -81,102 +118,436 @@ void list_t::resize(size_t count)
 
 void list_t::resize(size_t count, const dyn_object &value)
 {
-	bool invalidate = count < data.size() || count > data.capacity();
-	data.resize(count, value);
+	bool invalidate = count < data().size() || count > data().capacity();
+	data().resize(count, value);
 	if(invalidate)
 	{
 		++revision;
 	}
 }
 
+// The returned tag is null if the value is not a plain cell
+static tag_ptr plain_cell_tag(const dyn_object &value)
+{
+	if(value.is_cell() && dyn_object::plain_tag(value.get_tag()))
+	{
+		return value.get_tag();
+	}
+	return nullptr;
+}
+
+cell list_t::find(const dyn_object &value, size_t index) const
+{
+	const auto &list = data();
+	if(tag_ptr tag = plain_cell_tag(value))
+	{
+		cell raw = *value.begin();
+		for(size_t i = index; i < list.size(); i++)
+		{
+			const auto &obj = list[i];
+			if(obj.is_plain_cell(tag) ? obj.cell_equals(raw) : obj == value)
+			{
+				return static_cast<cell>(i);
+			}
+		}
+		return -1;
+	}
+	for(size_t i = index; i < list.size(); i++)
+	{
+		if(list[i] == value)
+		{
+			return static_cast<cell>(i);
+		}
+	}
+	return -1;
+}
+
+cell list_t::find_last(const dyn_object &value, cell index) const
+{
+	const auto &list = data();
+	if(tag_ptr tag = plain_cell_tag(value))
+	{
+		cell raw = *value.begin();
+		for(; index >= 0; index--)
+		{
+			const auto &obj = list[index];
+			if(obj.is_plain_cell(tag) ? obj.cell_equals(raw) : obj == value)
+			{
+				return index;
+			}
+		}
+		return -1;
+	}
+	for(; index >= 0; index--)
+	{
+		if(list[index] == value)
+		{
+			return index;
+		}
+	}
+	return -1;
+}
+
+size_t list_t::count(const dyn_object &value) const
+{
+	const auto &list = data();
+	if(tag_ptr tag = plain_cell_tag(value))
+	{
+		cell raw = *value.begin();
+		size_t result = 0;
+		for(const auto &obj : list)
+		{
+			if(obj.is_plain_cell(tag) ? obj.cell_equals(raw) : obj == value)
+			{
+				result++;
+			}
+		}
+		return result;
+	}
+	return std::count(list.begin(), list.end(), value);
+}
+
+// Keys of cells that are ordered as unsigned integers
+static bool radix_key_kind(tag_ptr tag, bool &is_float)
+{
+	switch(tag->get_ops().get_tag_uid())
+	{
+		case tags::tag_cell:
+		case tags::tag_char:
+			is_float = false;
+			return true;
+		case tags::tag_float:
+			is_float = true;
+			return true;
+		default:
+			return false;
+	}
+}
+
+static uint32_t radix_key(cell value, bool is_float)
+{
+	uint32_t bits = static_cast<uint32_t>(value);
+	if(!is_float)
+	{
+		return bits ^ 0x80000000u;
+	}
+	if((bits << 1) == 0)
+	{
+		// both zeros are equal
+		return 0x80000000u;
+	}
+	return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+// Sorts the list by its cells if all elements have the same tag of cell, char or Float, keeping the order of equal elements
+bool list_t::radix_sort(cell offset, cell size, bool reverse)
+{
+	const auto &list = static_cast<const list_t*>(this)->data();
+	if(list.size() < 2)
+	{
+		return true;
+	}
+	tag_ptr tag = list[0].get_tag();
+	bool is_float;
+	if(!radix_key_kind(tag, is_float))
+	{
+		return false;
+	}
+	bool cells = list[0].is_cell();
+	if(cells)
+	{
+		if(offset != 0 || (size != -1 && size != 1))
+		{
+			return false;
+		}
+		size = 1;
+	}else if(size <= 0)
+	{
+		// the keys of arrays could have different lengths
+		return false;
+	}
+
+	std::vector<uint32_t> keys;
+	keys.reserve(list.size() * size);
+	for(const auto &obj : list)
+	{
+		if(obj.get_tag() != tag || obj.is_cell() != cells || (!cells && obj.get_rank() != 1))
+		{
+			return false;
+		}
+		for(cell i = 0; i < size; i++)
+		{
+			cell index = offset + i;
+			const cell *addr = obj.get_cell_addr(&index, 1);
+			if(!addr)
+			{
+				return false;
+			}
+			keys.push_back(radix_key(*addr, is_float));
+		}
+	}
+
+	// sorting the reversed list and reversing the result matches sorting through reverse iterators
+	std::vector<size_t> order(list.size());
+	for(size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = reverse ? order.size() - 1 - i : i;
+	}
+	aux::radix_sort(order, keys, size);
+	if(reverse)
+	{
+		std::reverse(order.begin(), order.end());
+	}
+
+	auto &elements = data();
+	if(cells)
+	{
+		std::vector<cell> values;
+		values.reserve(order.size());
+		for(size_t pos : order)
+		{
+			values.push_back(*elements[pos].begin());
+		}
+		for(size_t i = 0; i < values.size(); i++)
+		{
+			*elements[i].begin() = values[i];
+		}
+	}else{
+		std::vector<dyn_object> values;
+		values.reserve(order.size());
+		for(size_t pos : order)
+		{
+			values.push_back(std::move(elements[pos]));
+		}
+		for(size_t i = 0; i < values.size(); i++)
+		{
+			elements[i] = std::move(values[i]);
+		}
+	}
+	return true;
+}
+
+// Whether the elements are compared without calling any code in scripts or accessing other objects
+bool list_t::pure_order() const
+{
+	for(const auto &obj : data())
+	{
+		switch(obj.get_tag()->get_ops().get_tag_uid())
+		{
+			case tags::tag_cell:
+			case tags::tag_bool:
+			case tags::tag_char:
+			case tags::tag_float:
+			case tags::tag_signed:
+			case tags::tag_unsigned:
+				break;
+			default:
+				return false;
+		}
+	}
+	return true;
+}
+
 
+void map_t::check_key(const dyn_object &key)
+{
+	bool matches;
+	switch(kind)
+	{
+		case key_kind::cell:
+			matches = key.is_cell() && key.get_tag()->uid == tags::tag_cell;
+			break;
+		case key_kind::string:
+			matches = key.is_array() && key.get_rank() == 1 && key.get_tag()->uid == tags::tag_char;
+			break;
+		default:
+			return;
+	}
+	if(!matches)
+	{
+		// the hashes are the same, so only the lookup changes
+		kind = key_kind::generic;
+	}
+}
 
 dyn_object &map_t::operator[](const dyn_object &key)
 {
-	bool invalidate = data.size() == data.capacity();
-	auto pair = data.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
-	if(pair.second && invalidate)
+	check_key(key);
+	bool invalidate = insert_invalidates();
+	auto pair = data().emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+	if(pair.second)
 	{
-		++revision;
+		inserted_new(invalidate);
 	}
 	return pair.first->second;
 }
 
 dyn_object &map_t::operator[](dyn_object &&key)
 {
-	bool invalidate = data.size() == data.capacity();
-	auto pair = data.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
-	if(pair.second && invalidate)
+	check_key(key);
+	bool invalidate = insert_invalidates();
+	auto pair = data().emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+	if(pair.second)
 	{
-		++revision;
+		inserted_new(invalidate);
 	}
 	return pair.first->second;
 }
 
 auto map_t::insert(const dyn_object &key, dyn_object const &value) -> std::pair<iterator, bool>
 {
-	bool invalidate = data.size() == data.capacity();
-	auto pair = data.emplace(key, value);
-	if(pair.second && invalidate)
+	auto before = clone_copies;
+	bool copies = key.clone_is_copy() && value.clone_is_copy();
+	check_key(key);
+	bool invalidate = insert_invalidates();
+	auto pair = data().emplace(key, value);
+	if(pair.second)
 	{
-		++revision;
+		inserted_new(invalidate);
 	}
+	inserted(before, copies || !pair.second);
 	return pair;
 }
 
 auto map_t::insert(const dyn_object &key, dyn_object &&value) -> std::pair<iterator, bool>
 {
-	bool invalidate = data.size() == data.capacity();
-	auto pair = data.emplace(key, std::move(value));
-	if(pair.second && invalidate)
+	auto before = clone_copies;
+	bool copies = key.clone_is_copy() && value.clone_is_copy();
+	check_key(key);
+	bool invalidate = insert_invalidates();
+	auto pair = data().emplace(key, std::move(value));
+	if(pair.second)
 	{
-		++revision;
+		inserted_new(invalidate);
 	}
+	inserted(before, copies || !pair.second);
 	return pair;
 }
 
 auto map_t::insert(dyn_object &&key, const dyn_object &value) -> std::pair<iterator, bool>
 {
-	bool invalidate = data.size() == data.capacity();
-	auto pair = data.emplace(std::move(key), value);
-	if(pair.second && invalidate)
+	auto before = clone_copies;
+	bool copies = key.clone_is_copy() && value.clone_is_copy();
+	check_key(key);
+	bool invalidate = insert_invalidates();
+	auto pair = data().emplace(std::move(key), value);
+	if(pair.second)
 	{
-		++revision;
+		inserted_new(invalidate);
 	}
+	inserted(before, copies || !pair.second);
 	return pair;
 }
 
 auto map_t::insert(dyn_object &&key, dyn_object &&value) -> std::pair<iterator, bool>
 {
-	bool invalidate = data.size() == data.capacity();
-	auto pair = data.emplace(std::move(key), std::move(value));
-	if(pair.second && invalidate)
+	auto before = clone_copies;
+	bool copies = key.clone_is_copy() && value.clone_is_copy();
+	check_key(key);
+	bool invalidate = insert_invalidates();
+	auto pair = data().emplace(std::move(key), std::move(value));
+	if(pair.second)
 	{
-		++revision;
+		inserted_new(invalidate);
 	}
+	inserted(before, copies || !pair.second);
 	return pair;
 }
 
 auto map_t::find(const dyn_object &key) -> iterator
 {
-	return data.find(key);
+	return data().find(key);
 }
 
 auto map_t::find(const dyn_object &key) const -> const_iterator
 {
-	return data.find(key);
+	return data().find(key);
 }
 
+// Only erasing from an ordered map moves the other elements
 size_t map_t::erase(const dyn_object &key)
 {
-	size_t size = data.erase(key);
-	++revision;
+	size_t size = data().erase(key);
+	if(size > 0 && ordered())
+	{
+		++revision;
+	}
 	return size;
 }
 
 auto map_t::erase(iterator position) -> iterator
 {
-	return collection_base<aux::hybrid_map<dyn_object, dyn_object>>::erase(position);
+	auto it = data().erase(position);
+	if(ordered())
+	{
+		++revision;
+	}
+	return it;
+}
+
+auto map_t::find_cell(cell key) -> iterator
+{
+	return data().find_hashed(dyn_object::hash_cell(key), [=](const dyn_object &obj)
+	{
+		return obj.cell_equals(key);
+	});
+}
+
+auto map_t::find_cell(cell key) const -> const_iterator
+{
+	return data().find_hashed(dyn_object::hash_cell(key), [=](const dyn_object &obj)
+	{
+		return obj.cell_equals(key);
+	});
+}
+
+auto map_t::find_string(const cell *str, cell size) -> iterator
+{
+	return data().find_hashed(dyn_object::hash_string(str, size), [=](const dyn_object &obj)
+	{
+		return obj.string_equals(str, size);
+	});
+}
+
+auto map_t::find_string(const cell *str, cell size) const -> const_iterator
+{
+	return data().find_hashed(dyn_object::hash_string(str, size), [=](const dyn_object &obj)
+	{
+		return obj.string_equals(str, size);
+	});
+}
+
+bool map_t::clone_is_copy() const
+{
+	if(clone_copies < 0)
+	{
+		clone_copies = 1;
+		for(const auto &pair : data())
+		{
+			if(!pair.first.clone_is_copy() || !pair.second.clone_is_copy())
+			{
+				clone_copies = 0;
+				break;
+			}
+		}
+	}
+	return clone_copies != 0;
+}
+
+auto map_t::detach(iterator position) -> iterator
+{
+	if(shared())
+	{
+		// the order of elements is not preserved in the copy
+		if(position == shared_end())
+		{
+			return data().end();
+		}
+		const dyn_object &key = position->first;
+		return data().find(key);
+	}
+	clone_copies = -1;
+	return position;
 }
 
 bool map_t::insert_dyn(iterator position, const std::type_info &type, void *value, iterator &result)
@@ -189,44 +560,72 @@ bool map_t::insert_dyn(iterator position, const std::type_info &type, const void
 	return false;
 }
 
+// Ids of the maps that were grown incrementally and may not be finished yet
+static std::vector<cell> rehashing_maps;
+
+void map_t::queue_rehash()
+{
+	cell id = map_pool.get_id(this);
+	if(id != 0 && std::find(rehashing_maps.begin(), rehashing_maps.end(), id) == rehashing_maps.end())
+	{
+		rehashing_maps.push_back(id);
+	}
+}
+
+// Maps that were grown incrementally are finished between ticks, so later insertions don't have to
+void map_rehash_tick(size_t budget)
+{
+	if(budget == 0)
+	{
+		return;
+	}
+	auto it = rehashing_maps.begin();
+	while(it != rehashing_maps.end())
+	{
+		std::shared_ptr<map_t> map;
+		if(map_pool.get_by_id(*it, map) && map->rehash_step(budget))
+		{
+			++it;
+		}else{
+			it = rehashing_maps.erase(it);
+		}
+	}
+}
+
 
 
 dyn_object &linked_list_t::operator[](size_t index)
 {
-	auto it = data.begin();
-	std::advance(it, index);
-	return **it;
+	return *data()[index];
 }
 
 const dyn_object &linked_list_t::operator[](size_t index) const
 {
-	auto it = data.begin();
-	std::advance(it, index);
-	return **it;
+	return *data()[index];
 }
 
 void linked_list_t::push_back(dyn_object &&value)
 {
-	data.push_back(std::make_shared<dyn_object>(std::move(value)));
+	data().push_back(std::make_shared<dyn_object>(std::move(value)));
 	++revision;
 }
 
 void linked_list_t::push_back(const dyn_object &value)
 {
-	data.push_back(std::make_shared<dyn_object>(value));
+	data().push_back(std::make_shared<dyn_object>(value));
 	++revision;
 }
 
 auto linked_list_t::insert(iterator position, dyn_object &&value) -> iterator
 {
-	auto it = data.insert(position, std::make_shared<dyn_object>(std::move(value)));
+	auto it = data().insert(position, std::make_shared<dyn_object>(std::move(value)));
 	++revision;
 	return it;
 }
 
 auto linked_list_t::insert(iterator position, const dyn_object &value) -> iterator
 {
-	auto it = data.insert(position, std::make_shared<dyn_object>(value));
+	auto it = data().insert(position, std::make_shared<dyn_object>(value));
 	++revision;
 	return it;
 }
@@ -255,7 +654,7 @@ bool linked_list_t::insert_dyn(iterator position, const std::type_info &type, co
 
 void pool_t::resize(size_t newsize)
 {
-	if(data.resize(newsize))
+	if(data().resize(newsize))
 	{
 		++revision;
 	}
@@ -263,100 +662,369 @@ void pool_t::resize(size_t newsize)
 
 size_t pool_t::push_back(dyn_object &&value)
 {
-	if(data.push_back(std::move(value)))
+	if(data().push_back(std::move(value)))
 	{
 		++revision;
 	}
-	return data.get_last_set();
+	return data().get_last_set();
 }
 
 size_t pool_t::push_back(const dyn_object &value)
 {
-	if(data.push_back(value))
+	if(data().push_back(value))
 	{
 		++revision;
 	}
-	return data.get_last_set();
+	return data().get_last_set();
 }
 
 
 
-bool dyn_iterator::expired() const
+bool heap_t::less(const dyn_object &a, const dyn_object &b) const
 {
-	return true;
+	if(comparator)
+	{
+		expression::args_type args;
+		args.push_back(std::cref(a));
+		args.push_back(std::cref(b));
+		return comparator->execute_bool(args, expression::exec_info());
+	}
+	return a < b;
 }
 
-bool dyn_iterator::valid() const
+void heap_t::swap_nodes(size_t a, size_t b)
 {
-	return false;
+	auto &nodes = data();
+	std::swap(nodes[a], nodes[b]);
+	nodes[a]->index = a;
+	nodes[b]->index = b;
 }
 
-bool dyn_iterator::empty() const
+size_t heap_t::sift_up(size_t index)
 {
-	return !valid();
+	auto &nodes = data();
+	while(index > 0)
+	{
+		size_t parent = (index - 1) / 2;
+		if(!less(nodes[index]->value, nodes[parent]->value))
+		{
+			break;
+		}
+		swap_nodes(index, parent);
+		index = parent;
+	}
+	return index;
 }
 
-bool dyn_iterator::move_next()
+size_t heap_t::sift_down(size_t index)
 {
-	return false;
+	auto &nodes = data();
+	size_t count = nodes.size();
+	while(true)
+	{
+		size_t child = index * 2 + 1;
+		if(child >= count)
+		{
+			break;
+		}
+		if(child + 1 < count && less(nodes[child + 1]->value, nodes[child]->value))
+		{
+			++child;
+		}
+		if(!less(nodes[child]->value, nodes[index]->value))
+		{
+			break;
+		}
+		swap_nodes(index, child);
+		index = child;
+	}
+	return index;
 }
 
-bool dyn_iterator::move_previous()
+size_t heap_t::restore(size_t index)
 {
-	return false;
+	size_t moved = sift_up(index);
+	if(moved == index)
+	{
+		moved = sift_down(index);
+	}
+	return moved;
 }
 
-bool dyn_iterator::set_to_first()
+void heap_t::copy_nodes()
 {
-	return false;
+	for(auto &node : data())
+	{
+		node = std::make_shared<heap_node>(*node);
+	}
 }
 
-bool dyn_iterator::set_to_last()
+size_t heap_t::push(dyn_object &&value)
 {
-	return false;
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	auto &nodes = data();
+	nodes.push_back(std::make_shared<heap_node>(std::move(value), nodes.size()));
+	++revision;
+	inserted(before, copies);
+	return sift_up(nodes.size() - 1);
 }
 
-bool dyn_iterator::reset()
+size_t heap_t::push(const dyn_object &value)
 {
-	return false;
+	return push(dyn_object(value));
 }
 
-bool dyn_iterator::erase(bool stay)
+dyn_object heap_t::remove(size_t index)
 {
-	return false;
+	auto &nodes = data();
+	auto node = std::move(nodes[index]);
+	if(index != nodes.size() - 1)
+	{
+		nodes[index] = std::move(nodes.back());
+		nodes[index]->index = index;
+		nodes.pop_back();
+		++revision;
+		restore(index);
+	}else{
+		nodes.pop_back();
+		++revision;
+	}
+	return std::move(node->value);
 }
 
-bool dyn_iterator::can_reset() const
+size_t heap_t::update(size_t index, dyn_object &&value)
 {
-	return false;
+	data()[index]->value = std::move(value);
+	++revision;
+	return restore(index);
 }
 
-bool dyn_iterator::can_insert() const
+bool heap_t::clone_is_copy() const
 {
-	return false;
+	if(clone_copies < 0)
+	{
+		clone_copies = 1;
+		for(const auto &node : data())
+		{
+			if(!node->value.clone_is_copy())
+			{
+				clone_copies = 0;
+				break;
+			}
+		}
+	}
+	return clone_copies != 0;
 }
 
-bool dyn_iterator::can_erase() const
+
+
+void deque_t::push_back(dyn_object &&value)
 {
-	return false;
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	bool invalidate = data().size() == data().capacity();
+	data().push_back(std::move(value));
+	if(invalidate)
+	{
+		++revision;
+	}
+	inserted(before, copies);
 }
 
-std::unique_ptr<dyn_iterator> dyn_iterator::clone() const
+void deque_t::push_back(const dyn_object &value)
 {
-	return std::make_unique<dyn_iterator>();
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	bool invalidate = data().size() == data().capacity();
+	data().push_back(value);
+	if(invalidate)
+	{
+		++revision;
+	}
+	inserted(before, copies);
 }
 
-std::shared_ptr<dyn_iterator> dyn_iterator::clone_shared() const
+// Adding an element at the front shifts the index of every other element
+void deque_t::push_front(dyn_object &&value)
 {
-	return std::make_shared<dyn_iterator>();
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	data().push_front(std::move(value));
+	++revision;
+	inserted(before, copies);
 }
 
-size_t dyn_iterator::get_hash() const
+void deque_t::push_front(const dyn_object &value)
 {
-	return 0;
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	data().push_front(value);
+	++revision;
+	inserted(before, copies);
 }
 
-bool dyn_iterator::operator==(const dyn_iterator &obj) const
+dyn_object deque_t::pop_back()
+{
+	auto &buffer = data();
+	dyn_object value = std::move(buffer.back());
+	buffer.pop_back();
+	++revision;
+	return value;
+}
+
+dyn_object deque_t::pop_front()
+{
+	auto &buffer = data();
+	dyn_object value = std::move(buffer.front());
+	buffer.pop_front();
+	++revision;
+	return value;
+}
+
+auto deque_t::insert(iterator position, dyn_object &&value) -> iterator
+{
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	bool invalidate = position == data().end() ? data().size() == data().capacity() : true;
+	auto it = data().insert(position, std::move(value));
+	if(invalidate)
+	{
+		++revision;
+	}
+	inserted(before, copies);
+	return it;
+}
+
+auto deque_t::insert(iterator position, const dyn_object &value) -> iterator
+{
+	auto before = clone_copies;
+	bool copies = value.clone_is_copy();
+	bool invalidate = position == data().end() ? data().size() == data().capacity() : true;
+	auto it = data().insert(position, value);
+	if(invalidate)
+	{
+		++revision;
+	}
+	inserted(before, copies);
+	return it;
+}
+
+bool deque_t::insert_dyn(iterator position, const std::type_info &type, void *value, iterator &result)
+{
+	if(type == typeid(dyn_object))
+	{
+		result = insert(position, std::move(*reinterpret_cast<dyn_object*>(value)));
+		return true;
+	}
+	return false;
+}
+
+bool deque_t::insert_dyn(iterator position, const std::type_info &type, const void *value, iterator &result)
+{
+	if(type == typeid(dyn_object))
+	{
+		result = insert(position, *reinterpret_cast<const dyn_object*>(value));
+		return true;
+	}
+	return false;
+}
+
+bool deque_t::clone_is_copy() const
+{
+	if(clone_copies < 0)
+	{
+		clone_copies = 1;
+		for(const auto &obj : data())
+		{
+			if(!obj.clone_is_copy())
+			{
+				clone_copies = 0;
+				break;
+			}
+		}
+	}
+	return clone_copies != 0;
+}
+
+
+
+bool dyn_iterator::expired() const
+{
+	return true;
+}
+
+bool dyn_iterator::valid() const
+{
+	return false;
+}
+
+bool dyn_iterator::empty() const
+{
+	return !valid();
+}
+
+bool dyn_iterator::move_next()
+{
+	return false;
+}
+
+bool dyn_iterator::move_previous()
+{
+	return false;
+}
+
+bool dyn_iterator::set_to_first()
+{
+	return false;
+}
+
+bool dyn_iterator::set_to_last()
+{
+	return false;
+}
+
+bool dyn_iterator::reset()
+{
+	return false;
+}
+
+bool dyn_iterator::erase(bool stay)
+{
+	return false;
+}
+
+bool dyn_iterator::can_reset() const
+{
+	return false;
+}
+
+bool dyn_iterator::can_insert() const
+{
+	return false;
+}
+
+bool dyn_iterator::can_erase() const
+{
+	return false;
+}
+
+std::unique_ptr<dyn_iterator> dyn_iterator::clone() const
+{
+	return std::make_unique<dyn_iterator>();
+}
+
+std::shared_ptr<dyn_iterator> dyn_iterator::clone_shared() const
+{
+	return std::make_shared<dyn_iterator>();
+}
+
+size_t dyn_iterator::get_hash() const
+{
+	return 0;
+}
+
+bool dyn_iterator::operator==(const dyn_iterator &obj) const
 {
 	return false;
 }
@@ -389,6 +1057,10 @@ bool list_iterator_t::extract_dyn(const std::type_info &type, void *value) const
 	{
 		if(type == typeid(value_type*))
 		{
+			if(auto source = lock_same())
+			{
+				detach(*source);
+			}
 			*reinterpret_cast<value_type**>(value) = &*_position;
 			return true;
 		}else if(type == typeid(const value_type*))
@@ -399,9 +1071,9 @@ bool list_iterator_t::extract_dyn(const std::type_info &type, void *value) const
 		{
 			if(auto source = lock_same())
 			{
-				if(_position != source->end())
+				if(_position != source->shared_end())
 				{
-					auto fake_pair = std::make_shared<std::pair<const dyn_object, dyn_object>>(std::pair<const dyn_object, dyn_object>(dyn_object(static_cast<cell>(std::distance(source->begin(), _position)), tags::find_tag(tags::tag_cell)), *_position));
+					auto fake_pair = std::make_shared<std::pair<const dyn_object, dyn_object>>(std::pair<const dyn_object, dyn_object>(dyn_object(static_cast<cell>(std::distance(source->shared_begin(), _position)), tags::find_tag(tags::tag_cell)), *_position));
 					*reinterpret_cast<std::shared_ptr<const std::pair<const dyn_object, dyn_object>>*>(value) = std::move(fake_pair);
 					return true;
 				}
@@ -687,6 +1359,10 @@ bool pool_iterator_t::extract_dyn(const std::type_info &type, void *value) const
 	{
 		if(type == typeid(value_type*))
 		{
+			if(auto source = lock_same())
+			{
+				detach(*source);
+			}
 			*reinterpret_cast<value_type**>(value) = &*_position;
 			return true;
 		}else if(type == typeid(const value_type*))
@@ -697,7 +1373,7 @@ bool pool_iterator_t::extract_dyn(const std::type_info &type, void *value) const
 		{
 			if(auto source = lock_same())
 			{
-				if(_position != source->end())
+				if(_position != source->shared_end())
 				{
 					auto fake_pair = std::make_shared<std::pair<const dyn_object, dyn_object>>(std::pair<const dyn_object, dyn_object>(dyn_object(source->index_of(_position), tags::find_tag(tags::tag_cell)), *_position));
 					*reinterpret_cast<std::shared_ptr<const std::pair<const dyn_object, dyn_object>>*>(value) = std::move(fake_pair);
@@ -708,3 +1384,512 @@ bool pool_iterator_t::extract_dyn(const std::type_info &type, void *value) const
 	}
 	return false;
 }
+
+bool deque_iterator_t::extract_dyn(const std::type_info &type, void *value) const
+{
+	if(_state == state::at_element && valid())
+	{
+		if(type == typeid(value_type*))
+		{
+			if(auto source = lock_same())
+			{
+				detach(*source);
+			}
+			*reinterpret_cast<value_type**>(value) = &*_position;
+			return true;
+		}else if(type == typeid(const value_type*))
+		{
+			*reinterpret_cast<const value_type**>(value) = &*_position;
+			return true;
+		}else if(type == typeid(std::shared_ptr<const std::pair<const dyn_object, dyn_object>>))
+		{
+			if(auto source = lock_same())
+			{
+				if(_position != source->shared_end())
+				{
+					auto fake_pair = std::make_shared<std::pair<const dyn_object, dyn_object>>(std::pair<const dyn_object, dyn_object>(dyn_object(static_cast<cell>(std::distance(source->shared_begin(), _position)), tags::find_tag(tags::tag_cell)), *_position));
+					*reinterpret_cast<std::shared_ptr<const std::pair<const dyn_object, dyn_object>>*>(value) = std::move(fake_pair);
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+std::shared_ptr<heap_node> heap_iterator_t::current(const heap_t &source) const
+{
+	if(auto node = _current.lock())
+	{
+		if(node->index < source.size() && source.node_at(node->index) == node)
+		{
+			return node;
+		}
+	}
+	return nullptr;
+}
+
+bool heap_iterator_t::update(dyn_object &&value)
+{
+	if(auto source = _source.lock())
+	{
+		if(auto node = current(*source))
+		{
+			source->update(node->index, std::move(value));
+			_before = false;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool heap_iterator_t::expired() const
+{
+	return _source.expired();
+}
+
+bool heap_iterator_t::valid() const
+{
+	if(auto source = _source.lock())
+	{
+		return current(*source) != nullptr;
+	}
+	return false;
+}
+
+bool heap_iterator_t::empty() const
+{
+	if(auto source = _source.lock())
+	{
+		return _before || !current(*source);
+	}
+	return false;
+}
+
+bool heap_iterator_t::move_next()
+{
+	if(auto source = _source.lock())
+	{
+		if(auto node = current(*source))
+		{
+			if(_before)
+			{
+				_before = false;
+				return true;
+			}
+			size_t index = node->index + 1;
+			if(index < source->size())
+			{
+				_current = source->node_at(index);
+				return true;
+			}
+			_current.reset();
+		}
+	}
+	return false;
+}
+
+bool heap_iterator_t::move_previous()
+{
+	if(auto source = _source.lock())
+	{
+		if(auto node = current(*source))
+		{
+			_before = false;
+			if(node->index > 0)
+			{
+				_current = source->node_at(node->index - 1);
+				return true;
+			}
+			_current.reset();
+		}
+	}
+	return false;
+}
+
+bool heap_iterator_t::set_to_first()
+{
+	if(auto source = _source.lock())
+	{
+		_before = false;
+		if(source->size() > 0)
+		{
+			_current = source->node_at(0);
+			return true;
+		}
+		_current.reset();
+	}
+	return false;
+}
+
+bool heap_iterator_t::set_to_last()
+{
+	if(auto source = _source.lock())
+	{
+		_before = false;
+		if(source->size() > 0)
+		{
+			_current = source->node_at(source->size() - 1);
+			return true;
+		}
+		_current.reset();
+	}
+	return false;
+}
+
+bool heap_iterator_t::reset()
+{
+	if(auto source = _source.lock())
+	{
+		_current.reset();
+		_before = false;
+		return true;
+	}
+	return false;
+}
+
+size_t heap_iterator_t::get_hash() const
+{
+	if(auto source = _source.lock())
+	{
+		if(auto node = current(*source))
+		{
+			return std::hash<heap_node*>()(node.get());
+		}else{
+			return std::hash<heap_t*>()(source.get());
+		}
+	}
+	return 0;
+}
+
+// The last element takes the place of the removed one, so the remaining elements may be visited in a different order
+bool heap_iterator_t::erase(bool stay)
+{
+	if(auto source = _source.lock())
+	{
+		if(auto node = current(*source))
+		{
+			if(!_before)
+			{
+				size_t index = node->index;
+				source->remove(index);
+				if(index < source->size())
+				{
+					_current = source->node_at(index);
+					_before = stay;
+				}else{
+					_current.reset();
+				}
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+bool heap_iterator_t::can_reset() const
+{
+	return !_source.expired();
+}
+
+bool heap_iterator_t::can_erase() const
+{
+	return valid();
+}
+
+bool heap_iterator_t::can_insert() const
+{
+	return !_source.expired();
+}
+
+std::unique_ptr<dyn_iterator> heap_iterator_t::clone() const
+{
+	return std::make_unique<heap_iterator_t>(*this);
+}
+
+std::shared_ptr<dyn_iterator> heap_iterator_t::clone_shared() const
+{
+	return std::make_shared<heap_iterator_t>(*this);
+}
+
+bool heap_iterator_t::operator==(const dyn_iterator &obj) const
+{
+	auto other = dynamic_cast<const heap_iterator_t*>(&obj);
+	if(other != nullptr)
+	{
+		return !_source.owner_before(other->_source) && !other->_source.owner_before(_source) && !_current.owner_before(other->_current) && !other->_current.owner_before(_current) && _before == other->_before;
+	}
+	return false;
+}
+
+// The elements cannot be modified in place, since that would break the order of the heap
+bool heap_iterator_t::extract_dyn(const std::type_info &type, void *value) const
+{
+	if(!_before)
+	{
+		if(auto source = _source.lock())
+		{
+			if(auto node = current(*source))
+			{
+				if(type == typeid(const dyn_object*))
+				{
+					*reinterpret_cast<const dyn_object**>(value) = &node->value;
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+bool heap_iterator_t::insert_dyn(const std::type_info &type, void *value)
+{
+	if(auto source = _source.lock())
+	{
+		if(type == typeid(dyn_object))
+		{
+			_current = source->node_at(source->push(std::move(*reinterpret_cast<dyn_object*>(value))));
+			_before = false;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool heap_iterator_t::insert_dyn(const std::type_info &type, const void *value)
+{
+	if(auto source = _source.lock())
+	{
+		if(type == typeid(dyn_object))
+		{
+			_current = source->node_at(source->push(*reinterpret_cast<const dyn_object*>(value)));
+			_before = false;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool bitset_iterator_t::move_to(const bitset_t &source, bitset_t::const_iterator it)
+{
+	if(it != source.cend())
+	{
+		_current = dyn_object(static_cast<cell>(*it), tags::find_tag(tags::tag_cell));
+		_state = state::at_element;
+		return true;
+	}
+	_state = state::outside;
+	return false;
+}
+
+bool bitset_iterator_t::expired() const
+{
+	return _source.expired();
+}
+
+bool bitset_iterator_t::valid() const
+{
+	if(auto source = _source.lock())
+	{
+		return _state != state::outside;
+	}
+	return false;
+}
+
+bool bitset_iterator_t::empty() const
+{
+	if(auto source = _source.lock())
+	{
+		return _state != state::at_element || !source->contains(_current.get_cell(0));
+	}
+	return false;
+}
+
+bool bitset_iterator_t::move_next()
+{
+	if(auto source = _source.lock())
+	{
+		if(_state == state::before_element)
+		{
+			_state = state::at_element;
+			return true;
+		}
+		if(_state == state::outside)
+		{
+			return false;
+		}
+		ucell value = _current.get_cell(0);
+		if(value == static_cast<ucell>(-1))
+		{
+			_state = state::outside;
+			return false;
+		}
+		return move_to(*source, source->lower_bound(value + 1));
+	}
+	return false;
+}
+
+bool bitset_iterator_t::move_previous()
+{
+	if(auto source = _source.lock())
+	{
+		if(_state == state::outside)
+		{
+			return false;
+		}
+		auto it = source->lower_bound(_current.get_cell(0));
+		if(it == source->cbegin())
+		{
+			_state = state::outside;
+			return false;
+		}
+		return move_to(*source, --it);
+	}
+	return false;
+}
+
+bool bitset_iterator_t::set_to_first()
+{
+	if(auto source = _source.lock())
+	{
+		return move_to(*source, source->cbegin());
+	}
+	return false;
+}
+
+bool bitset_iterator_t::set_to_last()
+{
+	if(auto source = _source.lock())
+	{
+		if(source->size() > 0)
+		{
+			return move_to(*source, --source->cend());
+		}
+		_state = state::outside;
+	}
+	return false;
+}
+
+bool bitset_iterator_t::reset()
+{
+	if(auto source = _source.lock())
+	{
+		_state = state::outside;
+		return true;
+	}
+	return false;
+}
+
+size_t bitset_iterator_t::get_hash() const
+{
+	if(auto source = _source.lock())
+	{
+		if(_state != state::outside)
+		{
+			return std::hash<cell>()(_current.get_cell(0));
+		}else{
+			return std::hash<bitset_t*>()(source.get());
+		}
+	}
+	return 0;
+}
+
+bool bitset_iterator_t::erase(bool stay)
+{
+	if(auto source = _source.lock())
+	{
+		if(_state == state::at_element)
+		{
+			cell value = _current.get_cell(0);
+			source->remove(value);
+			if(move_to(*source, source->lower_bound(value)) && stay)
+			{
+				_state = state::before_element;
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+bool bitset_iterator_t::can_reset() const
+{
+	return !_source.expired();
+}
+
+bool bitset_iterator_t::can_erase() const
+{
+	if(auto source = _source.lock())
+	{
+		return _state == state::at_element;
+	}
+	return false;
+}
+
+bool bitset_iterator_t::can_insert() const
+{
+	return !_source.expired();
+}
+
+std::unique_ptr<dyn_iterator> bitset_iterator_t::clone() const
+{
+	return std::make_unique<bitset_iterator_t>(*this);
+}
+
+std::shared_ptr<dyn_iterator> bitset_iterator_t::clone_shared() const
+{
+	return std::make_shared<bitset_iterator_t>(*this);
+}
+
+bool bitset_iterator_t::operator==(const dyn_iterator &obj) const
+{
+	auto other = dynamic_cast<const bitset_iterator_t*>(&obj);
+	if(other != nullptr)
+	{
+		if(_source.owner_before(other->_source) || other->_source.owner_before(_source) || _state != other->_state)
+		{
+			return false;
+		}
+		return _state == state::outside || _current.get_cell(0) == other->_current.get_cell(0);
+	}
+	return false;
+}
+
+bool bitset_iterator_t::extract_dyn(const std::type_info &type, void *value) const
+{
+	if(_state == state::at_element)
+	{
+		if(auto source = _source.lock())
+		{
+			if(type == typeid(const dyn_object*) && source->contains(_current.get_cell(0)))
+			{
+				*reinterpret_cast<const dyn_object**>(value) = &_current;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool bitset_iterator_t::insert_dyn(const std::type_info &type, void *value)
+{
+	return insert_dyn(type, const_cast<const void*>(value));
+}
+
+bool bitset_iterator_t::insert_dyn(const std::type_info &type, const void *value)
+{
+	if(auto source = _source.lock())
+	{
+		if(type == typeid(dyn_object))
+		{
+			const auto &obj = *reinterpret_cast<const dyn_object*>(value);
+			if(obj.is_cell())
+			{
+				cell id = obj.get_cell(0);
+				source->add(id);
+				return move_to(*source, source->lower_bound(id));
+			}
+		}
+	}
+	return false;
+}
@@ -3,9 +3,12 @@
 
 #include "objects/object_pool.h"
 #include "objects/dyn_object.h"
-#include "utils/shared_id_set_pool.h"
+#include "utils/slot_map_pool.h"
 #include "utils/hybrid_map.h"
+#include "utils/indexed_list.h"
 #include "utils/hybrid_pool.h"
+#include "utils/ring_buffer.h"
+#include "utils/roaring_bitmap.h"
 #include "fixes/linux.h"
 
 #include "sdk/amx/amx.h"
@@ -20,16 +23,52 @@
 #include <iterator>
 
 template <class Type>
-class collection_base
+class collection_base : public aux::slot_map_hook
 {
+	std::shared_ptr<Type> storage;
+
 protected:
-	Type data;
 	int revision = 0;
+	// Whether cloning the elements is the same as copying them: 1 if it is, 0 if not, -1 if unknown.
+	// Any mutable access to the elements makes it unknown, but insertions update it instead.
+	mutable signed char clone_copies = 1;
+
+	// The storage may be shared with a clone until one of them is modified
+	Type &data()
+	{
+		if(storage.use_count() > 1)
+		{
+			storage = std::make_shared<Type>(*storage);
+			++revision;
+		}
+		clone_copies = -1;
+		return *storage;
+	}
+
+	// Called after inserting an element, with the state from before the insertion
+	void inserted(signed char before, bool copies)
+	{
+		clone_copies = copies ? before : 0;
+	}
+
+	const Type &data() const
+	{
+		return *storage;
+	}
+
+	// The current storage, without copying it if it is shared
+	Type &shared_data()
+	{
+		return *storage;
+	}
 
-	collection_base() = default;
+	collection_base() : storage(std::make_shared<Type>())
+	{
+
+	}
 
 	template <class... Args>
-	collection_base(Args&&... args) : data(std::forward<Args>(args)...)
+	collection_base(Args&&... args) : storage(std::make_shared<Type>(std::forward<Args>(args)...)), clone_copies(-1)
 	{
 
 	}
@@ -41,50 +80,139 @@ public:
 	typedef typename Type::const_reference const_reference;
 	typedef typename Type::value_type value_type;
 
+	collection_base(const collection_base<Type> &obj) : storage(std::make_shared<Type>(*obj.storage)), revision(obj.revision), clone_copies(obj.clone_copies)
+	{
+
+	}
+
+	collection_base(collection_base<Type> &&obj) : storage(std::move(obj.storage)), revision(obj.revision), clone_copies(obj.clone_copies)
+	{
+		obj.storage = std::make_shared<Type>();
+		++obj.revision;
+		obj.clone_copies = 1;
+	}
+
+	collection_base<Type> &operator=(const collection_base<Type> &obj)
+	{
+		if(this != &obj)
+		{
+			storage = std::make_shared<Type>(*obj.storage);
+			revision = obj.revision;
+			clone_copies = obj.clone_copies;
+		}
+		return *this;
+	}
+
+	collection_base<Type> &operator=(collection_base<Type> &&obj)
+	{
+		if(this != &obj)
+		{
+			storage = std::move(obj.storage);
+			revision = obj.revision;
+			clone_copies = obj.clone_copies;
+			obj.storage = std::make_shared<Type>();
+			++obj.revision;
+			obj.clone_copies = 1;
+		}
+		return *this;
+	}
+
 	iterator begin()
 	{
-		return data.begin();
+		return data().begin();
 	}
 
 	iterator end()
 	{
-		return data.end();
+		return data().end();
+	}
+
+	const_iterator begin() const
+	{
+		return data().begin();
+	}
+
+	const_iterator end() const
+	{
+		return data().end();
 	}
 
 	const_iterator cbegin() const
 	{
-		return data.cbegin();
+		return data().cbegin();
 	}
 
 	const_iterator cend() const
 	{
-		return data.cend();
+		return data().cend();
+	}
+
+	// Positions in the current storage, without copying it if it is shared.
+	// The elements must not be modified through them without calling detach first.
+	iterator shared_begin()
+	{
+		return storage->begin();
+	}
+
+	iterator shared_end()
+	{
+		return storage->end();
+	}
+
+	bool shared() const
+	{
+		return storage.use_count() > 1;
+	}
+
+	// Copies the storage if it is shared and returns the same position in the copy
+	iterator detach(iterator position)
+	{
+		if(shared())
+		{
+			auto index = std::distance(storage->begin(), position);
+			position = data().begin();
+			std::advance(position, index);
+		}
+		clone_copies = -1;
+		return position;
+	}
+
+	// Makes the collection use the storage of another one until either of them is modified
+	void share(const collection_base<Type> &obj)
+	{
+		if(this != &obj)
+		{
+			storage = obj.storage;
+			clone_copies = obj.clone_copies;
+			++revision;
+		}
 	}
 
 	size_t size() const
 	{
-		return data.size();
+		return data().size();
 	}
 
 	void clear()
 	{
-		if(data.size() > 0)
+		if(size() > 0)
 		{
-			data.clear();
+			data().clear();
 			++revision;
 		}
+		clone_copies = 1;
 	}
 
 	iterator erase(iterator position)
 	{
-		auto it = data.erase(position);
+		auto it = data().erase(position);
 		++revision;
 		return it;
 	}
 
 	iterator erase(iterator first, iterator last)
 	{
-		auto it = data.erase(first, last);
+		auto it = data().erase(first, last);
 		++revision;
 		return it;
 	}
@@ -92,7 +220,7 @@ public:
 	template <class InputIterator>
 	void insert(InputIterator first, InputIterator last)
 	{
-		data.insert(first, last);
+		data().insert(first, last);
 		++revision;
 	}
 
@@ -101,9 +229,17 @@ public:
 		return revision;
 	}
 
+	// Whether the element at a position was not erased since the position was obtained.
+	// Collections whose erasures move other elements change the revision instead.
+	bool alive(const iterator &position) const
+	{
+		return true;
+	}
+
 	void swap(collection_base<Type> &other)
 	{
-		std::swap(data, other.data);
+		std::swap(storage, other.storage);
+		std::swap(clone_copies, other.clone_copies);
 		++revision;
 		++other.revision;
 	}
@@ -111,12 +247,12 @@ public:
 	Type &get_data()
 	{
 		++revision;
-		return data;
+		return data();
 	}
 
 	const Type &get_data() const
 	{
-		return data;
+		return data();
 	}
 };
 
@@ -126,19 +262,19 @@ public:
 	typedef typename std::vector<dyn_object>::reverse_iterator reverse_iterator;
 	reverse_iterator rbegin()
 	{
-		return data.rbegin();
+		return data().rbegin();
 	}
 	reverse_iterator rend()
 	{
-		return data.rend();
+		return data().rend();
 	}
 	dyn_object &operator[](size_t index)
 	{
-		return data[index];
+		return data()[index];
 	}
 	const dyn_object &operator[](size_t index) const
 	{
-		return data[index];
+		return data()[index];
 	}
 	void push_back(dyn_object &&value);
 	void push_back(const dyn_object &value);
@@ -146,34 +282,105 @@ public:
 	iterator insert(iterator position, const dyn_object &value);
 	bool insert_dyn(iterator position, const std::type_info &type, void *value, iterator &result);
 	bool insert_dyn(iterator position, const std::type_info &type, const void *value, iterator &result);
+	bool clone_is_copy() const;
 
 	template <class InputIterator>
 	void insert(iterator position, InputIterator first, InputIterator last)
 	{
-		data.insert(position, first, last);
+		data().insert(position, first, last);
 		++revision;
 	}
 
 	void resize(size_t count);
 	void resize(size_t count, const dyn_object &value);
+	cell find(const dyn_object &value, size_t index) const;
+	cell find_last(const dyn_object &value, cell index) const;
+	size_t count(const dyn_object &value) const;
+	bool radix_sort(cell offset, cell size, bool reverse);
+	bool pure_order() const;
 
 	void reserve(size_t count)
 	{
-		if(count > data.capacity())
+		if(count > data().capacity())
 		{
 			++revision;
 		}
-		data.reserve(count);
+		data().reserve(count);
 	}
 
 	size_t capacity() const
 	{
-		return data.capacity();
+		return data().capacity();
 	}
 };
 
 class map_t : public collection_base<aux::hybrid_map<dyn_object, dyn_object>>
 {
+public:
+	// While all keys are of the selected kind, they can be found without constructing them
+	enum class key_kind
+	{
+		generic,
+		cell,
+		string
+	};
+
+private:
+	key_kind kind = key_kind::generic;
+	int layout = 0;
+
+	// The iterators belong to the original map, so the number is not copied
+	struct counter
+	{
+		int value = 0;
+
+		counter() = default;
+
+		counter(const counter&) noexcept
+		{
+
+		}
+
+		counter &operator=(const counter&) noexcept
+		{
+			return *this;
+		}
+	};
+	counter iterators;
+
+	void check_key(const dyn_object &key);
+
+	// Adds the map to the maps whose rehash is continued between ticks
+	void queue_rehash();
+
+	void check_rehash()
+	{
+		if(shared_data().rehashing())
+		{
+			queue_rehash();
+		}
+	}
+
+	// Inserting into a table being rehashed moves some of its old elements
+	bool insert_invalidates() const
+	{
+		return !ordered() && (data().size() == data().capacity() || data().rehashing());
+	}
+
+	// Called after inserting a new element. Inserting into an ordered map moves the elements
+	// between the nodes of the tree, but their keys stay the same, so they can be found again.
+	void inserted_new(bool invalidate)
+	{
+		if(invalidate)
+		{
+			++revision;
+			check_rehash();
+		}else if(ordered())
+		{
+			++layout;
+		}
+	}
+
 public:
 	map_t() = default;
 
@@ -182,6 +389,11 @@ public:
 
 	}
 
+	map_t(bool ordered, key_kind kind) : collection_base<aux::hybrid_map<dyn_object, dyn_object>>(ordered), kind(kind)
+	{
+
+	}
+
 	dyn_object &operator[](const dyn_object &key);
 	dyn_object &operator[](dyn_object &&key);
 	std::pair<iterator, bool> insert(const dyn_object &key, const dyn_object &value);
@@ -192,19 +404,91 @@ public:
 	const_iterator find(const dyn_object &key) const;
 	size_t erase(const dyn_object &key);
 	iterator erase(iterator position);
+	iterator detach(iterator position);
+	bool clone_is_copy() const;
+	iterator find_cell(cell key);
+	const_iterator find_cell(cell key) const;
+	iterator find_string(const cell *str, cell size);
+	const_iterator find_string(const cell *str, cell size) const;
 	bool insert_dyn(iterator position, const std::type_info &type, void *value, iterator &result);
 	bool insert_dyn(iterator position, const std::type_info &type, const void *value, iterator &result);
 
 	template <class InputIterator>
 	void insert(InputIterator first, InputIterator last)
 	{
-		data.insert(first, last);
+		if(kind != key_kind::generic)
+		{
+			for(auto it = first; it != last; ++it)
+			{
+				check_key(it->first);
+			}
+		}
+		data().insert(first, last);
 		++revision;
+		check_rehash();
+	}
+
+	// The kind of keys that can be passed to find_cell or find_string
+	key_kind lookup_kind() const
+	{
+		return ordered() ? key_kind::generic : kind;
+	}
+
+	key_kind get_key_kind() const
+	{
+		return kind;
+	}
+
+	// Changed when elements are moved without invalidating their iterators
+	int get_layout() const
+	{
+		return layout;
+	}
+
+	iterator shared_find(const dyn_object &key)
+	{
+		return shared_data().find(key);
+	}
+
+	// Only for ordered maps; the end is returned otherwise
+	iterator shared_lower_bound(const dyn_object &key)
+	{
+		return shared_data().lower_bound(key);
+	}
+
+	iterator shared_upper_bound(const dyn_object &key)
+	{
+		return shared_data().upper_bound(key);
+	}
+
+	void swap(map_t &other)
+	{
+		collection_base<aux::hybrid_map<dyn_object, dyn_object>>::swap(other);
+		std::swap(kind, other.kind);
+		check_rehash();
+		other.check_rehash();
+	}
+
+	void share(const map_t &obj)
+	{
+		collection_base<aux::hybrid_map<dyn_object, dyn_object>>::share(obj);
+		check_rehash();
+	}
+
+	// Called by the iterators of the map when they are created or destroyed
+	void add_iterator()
+	{
+		++iterators.value;
+	}
+
+	void remove_iterator()
+	{
+		--iterators.value;
 	}
 
 	void set_ordered(bool ordered)
 	{
-		if(data.set_ordered(ordered))
+		if(this->ordered() != ordered && data().set_ordered(ordered))
 		{
 			++revision;
 		}
@@ -212,22 +496,58 @@ public:
 
 	bool ordered() const
 	{
-		return data.is_ordered();
+		return data().is_ordered();
 	}
 
 	void reserve(size_t count)
 	{
-		data.reserve(count);
+		data().reserve(count);
 		++revision;
+		check_rehash();
 	}
 
 	size_t capacity() const
 	{
-		return data.capacity();
+		return data().capacity();
+	}
+
+	size_t memory_size() const
+	{
+		return data().memory_size();
+	}
+
+	// Erasing from an unordered map doesn't move the other elements, so their iterators are kept
+	bool alive(const iterator &position) const
+	{
+		return data().alive(position);
+	}
+
+	// Moves more elements of a table that is being grown, returning false once it is finished.
+	// The moved elements would be skipped or visited twice by the iterators of the map,
+	// so nothing is moved while there are any; later insertions still finish the rehash.
+	bool rehash_step(size_t budget)
+	{
+		if(!shared_data().rehashing())
+		{
+			return false;
+		}
+		if(iterators.value > 0)
+		{
+			return true;
+		}
+		if(shared())
+		{
+			// the copy has all elements in one table, and the other map continues with the old one
+			auto copies = clone_copies;
+			data();
+			clone_copies = copies;
+			return false;
+		}
+		return shared_data().rehash_step(budget);
 	}
 };
 
-class linked_list_t : public collection_base<std::list<std::shared_ptr<dyn_object>>>
+class linked_list_t : public collection_base<aux::indexed_list<std::shared_ptr<dyn_object>>>
 {
 public:
 	dyn_object &operator[](size_t index);
@@ -242,9 +562,19 @@ public:
 	template <class InputIterator>
 	void insert(iterator position, InputIterator first, InputIterator last)
 	{
-		data.insert(position, first, last);
+		data().insert(position, first, last);
 		++revision;
 	}
+
+	iterator iter_at(size_t index)
+	{
+		return data().iter_at(index);
+	}
+
+	size_t memory_size() const
+	{
+		return data().memory_size();
+	}
 };
 
 class pool_t : public collection_base<aux::hybrid_pool<dyn_object, 4>>
@@ -259,19 +589,35 @@ public:
 
 	dyn_object &operator[](size_t index)
 	{
-		return data[index];
+		return data()[index];
 	}
 	const dyn_object &operator[](size_t index) const
 	{
-		return data[index];
+		return data()[index];
 	}
 	iterator find(size_t index)
 	{
-		return data.find(index);
+		return data().find(index);
 	}
 	iterator insert_or_set(size_t index, dyn_object &&value)
 	{
-		return data.insert_or_set(index, std::move(value));
+		if(index >= data().size())
+		{
+			// the storage may be reallocated
+			++revision;
+		}
+		return data().insert_or_set(index, std::move(value));
+	}
+
+	// Erasing doesn't move the other elements, so their iterators are kept
+	iterator erase(iterator position)
+	{
+		return data().erase(position);
+	}
+
+	bool alive(const iterator &position) const
+	{
+		return data().alive(position);
 	}
 	void resize(size_t newsize);
 	size_t push_back(dyn_object &&value);
@@ -279,17 +625,17 @@ public:
 
 	size_t index_of(iterator it) const
 	{
-		return data.index_of(it);
+		return data().index_of(it);
 	}
 
 	iterator last_iter()
 	{
-		return data.last_iter();
+		return data().last_iter();
 	}
 
 	void set_ordered(bool ordered)
 	{
-		if(data.set_ordered(ordered))
+		if(data().set_ordered(ordered))
 		{
 			++revision;
 		}
@@ -297,7 +643,7 @@ public:
 
 	bool ordered() const
 	{
-		return data.is_ordered();
+		return data().is_ordered();
 	}
 
 	bool insert_dyn(iterator position, const std::type_info &type, void *value, iterator &result)
@@ -312,14 +658,14 @@ public:
 
 	size_t num_elements() const
 	{
-		return data.num_elements();
+		return data().num_elements();
 	}
 
 	void reserve(size_t count)
 	{
-		if(count > data.size())
+		if(count > data().size())
 		{
-			if(data.resize(count))
+			if(data().resize(count))
 			{
 				++revision;
 			}
@@ -327,107 +673,367 @@ public:
 	}
 };
 
-namespace std
+class expression;
+
+struct heap_node
 {
-	template <>
-	inline void swap<list_t>(list_t &a, list_t &b) noexcept
+	dyn_object value;
+	size_t index;
+
+	heap_node(dyn_object &&value, size_t index) : value(std::move(value)), index(index)
 	{
-		a.swap(b);
+
 	}
+};
 
-	template <>
-	inline void swap<map_t>(map_t &a, map_t &b) noexcept
+// Each element knows its position in the heap, so iterators can follow it when the elements are reordered
+class heap_t : public collection_base<std::vector<std::shared_ptr<heap_node>>>
+{
+	std::shared_ptr<const expression> comparator;
+
+	bool less(const dyn_object &a, const dyn_object &b) const;
+	void swap_nodes(size_t a, size_t b);
+	size_t sift_up(size_t index);
+	size_t sift_down(size_t index);
+	size_t restore(size_t index);
+	void copy_nodes();
+
+public:
+	heap_t() = default;
+
+	heap_t(std::shared_ptr<const expression> comparator) : comparator(std::move(comparator))
 	{
-		a.swap(b);
+
 	}
 
-	template <>
-	inline void swap<linked_list_t>(linked_list_t &a, linked_list_t &b) noexcept
+	heap_t(const heap_t &obj) : collection_base(static_cast<const collection_base&>(obj)), comparator(obj.comparator)
 	{
-		a.swap(b);
+		copy_nodes();
 	}
 
-	template <>
-	inline void swap<pool_t>(pool_t &a, pool_t &b) noexcept
+	heap_t(heap_t &&obj) = default;
+
+	heap_t &operator=(const heap_t &obj)
 	{
-		a.swap(b);
+		if(this != &obj)
+		{
+			collection_base::operator=(obj);
+			comparator = obj.comparator;
+			copy_nodes();
+		}
+		return *this;
 	}
-}
 
-class dyn_iterator
-{
-public:
-	virtual bool expired() const;
-	virtual bool valid() const;
-	virtual bool empty() const;
-	virtual bool move_next();
-	virtual bool move_previous();
-	virtual bool set_to_first();
-	virtual bool set_to_last();
-	virtual bool reset();
-	virtual bool erase(bool stay);
-	virtual bool can_reset() const;
-	virtual bool can_insert() const;
-	virtual bool can_erase() const;
-	virtual std::unique_ptr<dyn_iterator> clone() const;
-	virtual std::shared_ptr<dyn_iterator> clone_shared() const;
-	virtual size_t get_hash() const;
-	virtual bool operator==(const dyn_iterator &obj) const;
-	int &operator[](size_t index) const;
-	virtual ~dyn_iterator() = default;
+	heap_t &operator=(heap_t &&obj) = default;
 
-	template <class Type>
-	bool extract(Type &value) const
+	const dyn_object &top() const
 	{
-		return extract_dyn(typeid(Type), reinterpret_cast<void*>(&value));
+		return data().front()->value;
 	}
 
-	template <class Type>
-	bool insert(Type &&value)
+	const std::shared_ptr<heap_node> &node_at(size_t index) const
 	{
-		return insert_dyn(typeid(Type), &value);
+		return data()[index];
 	}
 
-	template <class Type>
-	bool insert(const Type &value)
+	const std::shared_ptr<const expression> &get_comparator() const
 	{
-		return insert_dyn(typeid(Type), &value);
+		return comparator;
 	}
 
-	virtual bool extract_dyn(const std::type_info &type, void *value) const;
-	virtual bool insert_dyn(const std::type_info &type, void *value);
-	virtual bool insert_dyn(const std::type_info &type, const void *value);
-};
+	size_t push(dyn_object &&value);
+	size_t push(const dyn_object &value);
+	dyn_object remove(size_t index);
+	size_t update(size_t index, dyn_object &&value);
 
-template <class Base>
-class iterator_impl : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
-{
-protected:
-	enum class state
+	dyn_object pop()
 	{
-		outside,
-		at_element,
-		before_element
-	};
+		return remove(0);
+	}
 
-	typedef typename Base::iterator iterator;
-	typedef typename Base::value_type value_type;
-	std::weak_ptr<Base> _source;
-	int _revision;
-	iterator _position;
-	state _state;
+	bool clone_is_copy() const;
 
-	virtual std::shared_ptr<Base> lock_same()
+	void reserve(size_t count)
 	{
-		if(auto source = _source.lock())
+		if(count > data().capacity())
 		{
-			if(source->get_revision() == _revision)
-			{
-				return source;
-			}else if(_state == state::outside)
-			{
-				_position = source->end();
-				_revision = source->get_revision();
+			++revision;
+		}
+		data().reserve(count);
+	}
+
+	size_t capacity() const
+	{
+		return data().capacity();
+	}
+
+	void swap(heap_t &other)
+	{
+		collection_base::swap(other);
+		std::swap(comparator, other.comparator);
+	}
+};
+
+class deque_t : public collection_base<aux::ring_buffer<dyn_object>>
+{
+public:
+	typedef typename aux::ring_buffer<dyn_object>::reverse_iterator reverse_iterator;
+	reverse_iterator rbegin()
+	{
+		return data().rbegin();
+	}
+	reverse_iterator rend()
+	{
+		return data().rend();
+	}
+	dyn_object &operator[](size_t index)
+	{
+		return data()[index];
+	}
+	const dyn_object &operator[](size_t index) const
+	{
+		return data()[index];
+	}
+	const dyn_object &front() const
+	{
+		return data().front();
+	}
+	const dyn_object &back() const
+	{
+		return data().back();
+	}
+	void push_back(dyn_object &&value);
+	void push_back(const dyn_object &value);
+	void push_front(dyn_object &&value);
+	void push_front(const dyn_object &value);
+	dyn_object pop_back();
+	dyn_object pop_front();
+	iterator insert(iterator position, dyn_object &&value);
+	iterator insert(iterator position, const dyn_object &value);
+	bool insert_dyn(iterator position, const std::type_info &type, void *value, iterator &result);
+	bool insert_dyn(iterator position, const std::type_info &type, const void *value, iterator &result);
+	bool clone_is_copy() const;
+
+	template <class InputIterator>
+	void insert(iterator position, InputIterator first, InputIterator last)
+	{
+		data().insert(position, first, last);
+		++revision;
+	}
+
+	void reserve(size_t count)
+	{
+		if(count > data().capacity())
+		{
+			++revision;
+		}
+		data().reserve(count);
+	}
+
+	size_t capacity() const
+	{
+		return data().capacity();
+	}
+};
+
+// The elements are cells, compared as unsigned numbers
+class bitset_t : public collection_base<aux::roaring_bitmap>
+{
+public:
+	bitset_t() = default;
+
+	bitset_t(aux::roaring_bitmap &&bitmap) : collection_base<aux::roaring_bitmap>(std::move(bitmap))
+	{
+
+	}
+
+	bool contains(cell value) const
+	{
+		return data().contains(static_cast<ucell>(value));
+	}
+
+	bool add(cell value)
+	{
+		if(data().add(static_cast<ucell>(value)))
+		{
+			++revision;
+			return true;
+		}
+		return false;
+	}
+
+	bool remove(cell value)
+	{
+		if(data().remove(static_cast<ucell>(value)))
+		{
+			++revision;
+			return true;
+		}
+		return false;
+	}
+
+	size_t add_range(cell begin, cell end)
+	{
+		size_t added = data().add_range(static_cast<ucell>(begin), static_cast<ucell>(end));
+		if(added > 0)
+		{
+			++revision;
+		}
+		return added;
+	}
+
+	const_iterator lower_bound(cell value) const
+	{
+		return data().lower_bound(static_cast<ucell>(value));
+	}
+
+	static bitset_t combine(const bitset_t &a, const bitset_t &b, aux::roaring_bitmap::set_op op)
+	{
+		return bitset_t(aux::roaring_bitmap::combine(a.data(), b.data(), op));
+	}
+
+	static size_t intersect_count(const bitset_t &a, const bitset_t &b)
+	{
+		return aux::roaring_bitmap::intersect_count(a.data(), b.data());
+	}
+
+	size_t memory_size() const
+	{
+		return data().memory_size();
+	}
+};
+
+namespace std
+{
+	template <>
+	inline void swap<list_t>(list_t &a, list_t &b) noexcept
+	{
+		a.swap(b);
+	}
+
+	template <>
+	inline void swap<map_t>(map_t &a, map_t &b) noexcept
+	{
+		a.swap(b);
+	}
+
+	template <>
+	inline void swap<linked_list_t>(linked_list_t &a, linked_list_t &b) noexcept
+	{
+		a.swap(b);
+	}
+
+	template <>
+	inline void swap<pool_t>(pool_t &a, pool_t &b) noexcept
+	{
+		a.swap(b);
+	}
+
+	template <>
+	inline void swap<heap_t>(heap_t &a, heap_t &b) noexcept
+	{
+		a.swap(b);
+	}
+
+	template <>
+	inline void swap<deque_t>(deque_t &a, deque_t &b) noexcept
+	{
+		a.swap(b);
+	}
+
+	template <>
+	inline void swap<bitset_t>(bitset_t &a, bitset_t &b) noexcept
+	{
+		a.swap(b);
+	}
+}
+
+class dyn_iterator
+{
+public:
+	virtual bool expired() const;
+	virtual bool valid() const;
+	virtual bool empty() const;
+	virtual bool move_next();
+	virtual bool move_previous();
+	virtual bool set_to_first();
+	virtual bool set_to_last();
+	virtual bool reset();
+	virtual bool erase(bool stay);
+	virtual bool can_reset() const;
+	virtual bool can_insert() const;
+	virtual bool can_erase() const;
+	virtual std::unique_ptr<dyn_iterator> clone() const;
+	virtual std::shared_ptr<dyn_iterator> clone_shared() const;
+	virtual size_t get_hash() const;
+	virtual bool operator==(const dyn_iterator &obj) const;
+	int &operator[](size_t index) const;
+	virtual ~dyn_iterator() = default;
+
+	template <class Type>
+	bool extract(Type &value) const
+	{
+		return extract_dyn(typeid(Type), reinterpret_cast<void*>(&value));
+	}
+
+	template <class Type>
+	bool insert(Type &&value)
+	{
+		return insert_dyn(typeid(Type), &value);
+	}
+
+	template <class Type>
+	bool insert(const Type &value)
+	{
+		return insert_dyn(typeid(Type), &value);
+	}
+
+	virtual bool extract_dyn(const std::type_info &type, void *value) const;
+	virtual bool insert_dyn(const std::type_info &type, void *value);
+	virtual bool insert_dyn(const std::type_info &type, const void *value);
+};
+
+template <class Base>
+class iterator_impl : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
+{
+protected:
+	enum class state
+	{
+		outside,
+		at_element,
+		before_element
+	};
+
+	typedef typename Base::iterator iterator;
+	typedef typename Base::value_type value_type;
+	std::weak_ptr<Base> _source;
+	mutable int _revision;
+	mutable iterator _position;
+	state _state;
+
+	// The storage may be shared with a clone, so it must be copied before it is modified
+	void detach(Base &source) const
+	{
+		_position = source.detach(_position);
+		_revision = source.get_revision();
+	}
+
+	// The position is usable if the collection was not modified in a way that moves its elements
+	// and the element at the position was not erased
+	virtual std::shared_ptr<Base> lock_same()
+	{
+		if(auto source = _source.lock())
+		{
+			if(source->get_revision() == _revision)
+			{
+				if(_state == state::outside || source->alive(_position))
+				{
+					return source;
+				}
+			}else if(_state == state::outside)
+			{
+				_position = source->shared_end();
+				_revision = source->get_revision();
 				return source;
 			}
 		}
@@ -438,7 +1044,7 @@ protected:
 	{
 		if(auto source = _source.lock())
 		{
-			if(source->get_revision() == _revision)
+			if(source->get_revision() == _revision && (_state == state::outside || source->alive(_position)))
 			{
 				return source;
 			}
@@ -452,12 +1058,12 @@ public:
 
 	}*/
 
-	iterator_impl(const std::shared_ptr<Base> &source) : iterator_impl(source, source->begin())
+	iterator_impl(const std::shared_ptr<Base> &source) : iterator_impl(source, source->shared_begin())
 	{
 
 	}
 
-	iterator_impl(const std::shared_ptr<Base> &source, iterator position) : _source(source), _revision(source->get_revision()), _position(position), _state(position != source->end() ? state::at_element : state::outside)
+	iterator_impl(const std::shared_ptr<Base> &source, iterator position) : _source(source), _revision(source->get_revision()), _position(position), _state(position != source->shared_end() ? state::at_element : state::outside)
 	{
 
 	}
@@ -502,7 +1108,7 @@ public:
 			}else{
 				++_position;
 			}
-			if(_position == source->end())
+			if(_position == source->shared_end())
 			{
 				_state = state::outside;
 				return false;
@@ -517,8 +1123,8 @@ public:
 		if(auto source = _source.lock())
 		{
 			_revision = source->get_revision();
-			_position = source->begin();
-			if(_position != source->end())
+			_position = source->shared_begin();
+			if(_position != source->shared_end())
 			{
 				_state = state::at_element;
 				return true;
@@ -539,7 +1145,7 @@ public:
 		if(auto source = _source.lock())
 		{
 			_revision = source->get_revision();
-			_position = source->end();
+			_position = source->shared_end();
 			_state = state::outside;
 			return true;
 		}
@@ -550,7 +1156,7 @@ public:
 	{
 		if(auto source = _source.lock())
 		{
-			if(source->get_revision() == _revision)
+			if(source->get_revision() == _revision && (_state == state::outside || source->alive(_position)))
 			{
 				return std::hash<decltype(&*_position)>()(&*_position);
 			}else if(_state == state::outside)
@@ -576,9 +1182,10 @@ public:
 		{
 			if(_state == state::at_element)
 			{
+				detach(*source);
 				_position = source->erase(_position);
 				_revision = source->get_revision();
-				if(_position == source->end())
+				if(_position == source->shared_end())
 				{
 					_state = state::outside;
 				}else if(stay)
@@ -591,191 +1198,547 @@ public:
 		return false;
 	}
 
-	virtual bool operator==(const dyn_iterator &obj) const
+	virtual bool operator==(const dyn_iterator &obj) const
+	{
+		auto other = dynamic_cast<const iterator_impl<Base>*>(&obj);
+		if(other != nullptr)
+		{
+			return !_source.owner_before(other->_source) && !other->_source.owner_before(_source) && _revision == other->_revision && _position == other->_position && _state == other->_state;
+		}
+		return false;
+	}
+
+	virtual bool can_insert() const override
+	{
+		if(auto source = lock_same())
+		{
+			return true;
+		}
+		return false;
+	}
+
+	virtual bool extract_dyn(const std::type_info &type, void *value) const override
+	{
+		if(_state != state::outside && valid())
+		{
+			if(type == typeid(value_type*))
+			{
+				if(auto source = lock_same())
+				{
+					detach(*source);
+				}
+				*reinterpret_cast<value_type**>(value) = &*_position;
+				return true;
+			}else if(type == typeid(const value_type*))
+			{
+				*reinterpret_cast<const value_type**>(value) = &*_position;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	virtual bool insert_dyn(const std::type_info &type, void *value) override
+	{
+		if(auto source = lock_same())
+		{
+			detach(*source);
+			if(source->insert_dyn(_position, type, value, _position))
+			{
+				_revision = source->get_revision();
+				_state = state::at_element;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	virtual bool insert_dyn(const std::type_info &type, const void *value) override
+	{
+		if(auto source = lock_same())
+		{
+			detach(*source);
+			if(source->insert_dyn(_position, type, value, _position))
+			{
+				_revision = source->get_revision();
+				_state = state::at_element;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	virtual dyn_iterator *get() override
+	{
+		return this;
+	}
+
+	virtual const dyn_iterator *get() const override
+	{
+		return this;
+	}
+};
+
+class list_iterator_t : public iterator_impl<list_t>
+{
+public:
+	/*list_iterator_t()
+	{
+
+	}*/
+
+	list_iterator_t(const std::shared_ptr<list_t> source) : iterator_impl(source)
+	{
+
+	}
+
+	list_iterator_t(const std::shared_ptr<list_t> source, iterator position) : iterator_impl(source, position)
+	{
+
+	}
+
+	list_iterator_t(const list_iterator_t &iter) : iterator_impl(iter)
+	{
+
+	}
+
+	virtual bool move_previous() override
+	{
+		if(auto source = lock_same())
+		{
+			if(_position == source->shared_end())
+			{
+				return false;
+			}else if(_position == source->shared_begin())
+			{
+				_position = source->shared_end();
+				_state = state::outside;
+				return false;
+			}else{
+				--_position;
+				_state = state::at_element;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	virtual bool set_to_last() override
+	{
+		if(auto source = _source.lock())
+		{
+			_revision = source->get_revision();
+			_position = source->shared_end();
+			if(_position != source->shared_begin())
+			{
+				--_position;
+				_state = state::at_element;
+				return true;
+			}else{
+				_state = state::outside;
+			}
+		}
+		return false;
+	}
+
+	virtual std::unique_ptr<dyn_iterator> clone() const override
+	{
+		return std::make_unique<list_iterator_t>(*this);
+	}
+
+	virtual std::shared_ptr<dyn_iterator> clone_shared() const override
+	{
+		return std::make_shared<list_iterator_t>(*this);
+	}
+
+	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
+};
+
+class map_iterator_t : public iterator_impl<map_t>
+{
+	// Insertions into an ordered map move its elements, so the key is kept to find the element again
+	mutable dyn_object _key;
+	mutable int _layout;
+
+	// Finds the element again if it was moved since the position was obtained
+	bool relocate(map_t &source) const
+	{
+		if(source.get_layout() != _layout)
+		{
+			_layout = source.get_layout();
+			if(_state == state::outside)
+			{
+				_position = source.shared_end();
+			}else{
+				_position = source.shared_find(_key);
+				if(_position == source.shared_end())
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+protected:
+	// Called after the position was changed
+	bool track(bool result)
+	{
+		if(auto source = _source.lock())
+		{
+			if(source->get_revision() == _revision)
+			{
+				_layout = source->get_layout();
+				if(_state != state::outside && source->ordered())
+				{
+					_key = _position->first;
+				}
+			}
+		}
+		return result;
+	}
+
+	virtual std::shared_ptr<map_t> lock_same() override
+	{
+		if(auto source = iterator_impl::lock_same())
+		{
+			if(relocate(*source))
+			{
+				return source;
+			}
+		}
+		return nullptr;
+	}
+
+	virtual std::shared_ptr<map_t> lock_same() const override
+	{
+		if(auto source = iterator_impl::lock_same())
+		{
+			if(relocate(*source))
+			{
+				return source;
+			}
+		}
+		return nullptr;
+	}
+
+public:
+	/*map_iterator_t()
+	{
+
+	}*/
+
+	map_iterator_t(const std::shared_ptr<map_t> source) : map_iterator_t(source, source->shared_begin())
+	{
+
+	}
+
+	map_iterator_t(const std::shared_ptr<map_t> source, iterator position) : iterator_impl(source, position), _layout(source->get_layout())
+	{
+		source->add_iterator();
+		track(true);
+	}
+
+	map_iterator_t(const map_iterator_t &iter) : iterator_impl(iter), _key(iter._key), _layout(iter._layout)
+	{
+		if(auto source = _source.lock())
+		{
+			source->add_iterator();
+		}
+	}
+
+	virtual ~map_iterator_t()
+	{
+		if(auto source = _source.lock())
+		{
+			source->remove_iterator();
+		}
+	}
+
+	virtual bool move_next() override
+	{
+		return track(iterator_impl::move_next());
+	}
+
+	virtual bool set_to_first() override
+	{
+		return track(iterator_impl::set_to_first());
+	}
+
+	virtual bool erase(bool stay) override
+	{
+		return track(iterator_impl::erase(stay));
+	}
+
+	virtual size_t get_hash() const override
+	{
+		lock_same();
+		return iterator_impl::get_hash();
+	}
+	
+	virtual bool move_previous() override
+	{
+		if(auto source = lock_same())
+		{
+			if(!source->ordered()) return false;
+
+			if(_position == source->shared_end())
+			{
+				return false;
+			}else if(_position == source->shared_begin())
+			{
+				_position = source->shared_end();
+				_state = state::outside;
+				return false;
+			}else{
+				--_position;
+				_state = state::at_element;
+				return track(true);
+			}
+		}
+		return false;
+	}
+
+	virtual bool set_to_last() override
+	{
+		if(auto source = _source.lock())
+		{
+			if(!source->ordered()) return false;
+
+			_revision = source->get_revision();
+			_position = source->shared_end();
+			if(_position != source->shared_begin())
+			{
+				--_position;
+				_state = state::at_element;
+				return track(true);
+			}else{
+				_state = state::outside;
+			}
+		}
+		return false;
+	}
+
+	virtual std::unique_ptr<dyn_iterator> clone() const override
+	{
+		return std::make_unique<map_iterator_t>(*this);
+	}
+
+	virtual std::shared_ptr<dyn_iterator> clone_shared() const override
+	{
+		return std::make_shared<map_iterator_t>(*this);
+	}
+};
+
+// Iterates the keys of an ordered map from the lower bound (inclusive) to the upper bound (exclusive)
+class map_range_iterator_t : public map_iterator_t
+{
+	dyn_object _lower;
+	dyn_object _upper;
+
+	bool in_range() const
+	{
+		return !(_position->first < _lower) && _position->first < _upper;
+	}
+
+	void leave(map_t &source)
 	{
-		auto other = dynamic_cast<const iterator_impl<Base>*>(&obj);
-		if(other != nullptr)
+		_position = source.shared_end();
+		_state = state::outside;
+	}
+
+public:
+	map_range_iterator_t(const std::shared_ptr<map_t> source, dyn_object &&lower, dyn_object &&upper) : map_iterator_t(source, source->shared_end()), _lower(std::move(lower)), _upper(std::move(upper))
+	{
+		set_to_first();
+	}
+
+	map_range_iterator_t(const map_range_iterator_t &iter) = default;
+
+	virtual bool move_next() override
+	{
+		if(map_iterator_t::move_next())
 		{
-			return !_source.owner_before(other->_source) && !other->_source.owner_before(_source) && _revision == other->_revision && _position == other->_position && _state == other->_state;
+			if(in_range())
+			{
+				return true;
+			}
+			leave(*_source.lock());
 		}
 		return false;
 	}
 
-	virtual bool can_insert() const override
+	virtual bool move_previous() override
 	{
-		if(auto source = lock_same())
+		if(map_iterator_t::move_previous())
 		{
-			return true;
+			if(in_range())
+			{
+				return true;
+			}
+			leave(*_source.lock());
 		}
 		return false;
 	}
 
-	virtual bool extract_dyn(const std::type_info &type, void *value) const override
+	virtual bool set_to_first() override
 	{
-		if(_state != state::outside && valid())
+		if(auto source = _source.lock())
 		{
-			if(type == typeid(value_type*))
-			{
-				*reinterpret_cast<value_type**>(value) = &*_position;
-				return true;
-			}else if(type == typeid(const value_type*))
+			_revision = source->get_revision();
+			_position = source->shared_lower_bound(_lower);
+			if(_position != source->shared_end() && in_range())
 			{
-				*reinterpret_cast<const value_type**>(value) = &*_position;
-				return true;
+				_state = state::at_element;
+				return track(true);
 			}
+			leave(*source);
 		}
 		return false;
 	}
 
-	virtual bool insert_dyn(const std::type_info &type, void *value) override
+	virtual bool set_to_last() override
 	{
-		if(auto source = lock_same())
+		if(auto source = _source.lock())
 		{
-			if(source->insert_dyn(_position, type, value, _position))
+			_revision = source->get_revision();
+			_position = source->shared_lower_bound(_upper);
+			if(source->ordered() && _position != source->shared_begin())
 			{
-				_revision = source->get_revision();
-				_state = state::at_element;
-				return true;
+				--_position;
+				if(in_range())
+				{
+					_state = state::at_element;
+					return track(true);
+				}
 			}
+			leave(*source);
 		}
 		return false;
 	}
 
-	virtual bool insert_dyn(const std::type_info &type, const void *value) override
+	virtual bool erase(bool stay) override
 	{
-		if(auto source = lock_same())
+		if(map_iterator_t::erase(stay))
 		{
-			if(source->insert_dyn(_position, type, value, _position))
+			if(_state != state::outside && !in_range())
 			{
-				_revision = source->get_revision();
-				_state = state::at_element;
-				return true;
+				leave(*_source.lock());
 			}
+			return true;
 		}
 		return false;
 	}
 
-	virtual dyn_iterator *get() override
+	virtual std::unique_ptr<dyn_iterator> clone() const override
 	{
-		return this;
+		return std::make_unique<map_range_iterator_t>(*this);
 	}
 
-	virtual const dyn_iterator *get() const override
+	virtual std::shared_ptr<dyn_iterator> clone_shared() const override
 	{
-		return this;
+		return std::make_shared<map_range_iterator_t>(*this);
 	}
 };
 
-class list_iterator_t : public iterator_impl<list_t>
+class linked_list_iterator_t : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
 {
+protected:
+	typedef typename linked_list_t::iterator iterator;
+	typedef typename linked_list_t::value_type value_type;
+	std::weak_ptr<linked_list_t> _source;
+	iterator _position;
+	std::weak_ptr<dyn_object> _current;
+	bool _before;
+
+	virtual std::shared_ptr<linked_list_t> lock_same();
+	virtual std::shared_ptr<linked_list_t> lock_same() const;
+
 public:
-	/*list_iterator_t()
+	/*linked_list_iterator_t()
 	{
 
 	}*/
 
-	list_iterator_t(const std::shared_ptr<list_t> source) : iterator_impl(source)
+	linked_list_iterator_t(const std::shared_ptr<linked_list_t> source) : linked_list_iterator_t(source, source->begin())
 	{
 
 	}
 
-	list_iterator_t(const std::shared_ptr<list_t> source, iterator position) : iterator_impl(source, position)
+	linked_list_iterator_t(const std::shared_ptr<linked_list_t> source, iterator position) : _source(source), _position(position), _current(position != source->end() ? *position : nullptr), _before(false)
 	{
 
 	}
 
-	list_iterator_t(const list_iterator_t &iter) : iterator_impl(iter)
-	{
+	linked_list_iterator_t(const linked_list_iterator_t &iter) = default;
 
-	}
+	virtual bool expired() const override;
+	virtual bool valid() const override;
+	virtual bool empty() const override;
+	virtual bool move_next() override;
+	virtual bool move_previous() override;
+	virtual bool set_to_first() override;
+	virtual bool set_to_last() override;
+	virtual bool reset() override;
+	virtual size_t get_hash() const override;
+	virtual bool erase(bool stay) override;
+	virtual std::unique_ptr<dyn_iterator> clone() const override;
+	virtual std::shared_ptr<dyn_iterator> clone_shared() const override;
+	virtual bool operator==(const dyn_iterator &obj) const override;
 
-	virtual bool move_previous() override
-	{
-		if(auto source = lock_same())
-		{
-			if(_position == source->end())
-			{
-				return false;
-			}else if(_position == source->begin())
-			{
-				_position = source->end();
-				_state = state::outside;
-				return false;
-			}else{
-				--_position;
-				_state = state::at_element;
-				return true;
-			}
-		}
-		return false;
-	}
+	virtual bool can_reset() const override;
+	virtual bool can_insert() const override;
+	virtual bool can_erase() const override;
 
-	virtual bool set_to_last() override
-	{
-		if(auto source = _source.lock())
-		{
-			_revision = source->get_revision();
-			_position = source->end();
-			if(_position != source->begin())
-			{
-				--_position;
-				_state = state::at_element;
-				return true;
-			}else{
-				_state = state::outside;
-			}
-		}
-		return false;
-	}
+	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
+	virtual bool insert_dyn(const std::type_info &type, void *value) override;
+	virtual bool insert_dyn(const std::type_info &type, const void *value) override;
 
-	virtual std::unique_ptr<dyn_iterator> clone() const override
+public:
+	virtual dyn_iterator *get() override
 	{
-		return std::make_unique<list_iterator_t>(*this);
+		return this;
 	}
 
-	virtual std::shared_ptr<dyn_iterator> clone_shared() const override
+	virtual const dyn_iterator *get() const override
 	{
-		return std::make_shared<list_iterator_t>(*this);
+		return this;
 	}
-
-	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
 };
 
-class map_iterator_t : public iterator_impl<map_t>
+class pool_iterator_t : public iterator_impl<pool_t>
 {
 public:
-	/*map_iterator_t()
+	/*pool_iterator_t()
 	{
 
 	}*/
 
-	map_iterator_t(const std::shared_ptr<map_t> source) : iterator_impl(source)
+	pool_iterator_t(const std::shared_ptr<pool_t> source) : iterator_impl(source)
 	{
 
 	}
 
-	map_iterator_t(const std::shared_ptr<map_t> source, iterator position) : iterator_impl(source, position)
+	pool_iterator_t(const std::shared_ptr<pool_t> source, iterator position) : iterator_impl(source, position)
 	{
 
 	}
 
-	map_iterator_t(const map_iterator_t &iter) : iterator_impl(iter)
+	pool_iterator_t(const pool_iterator_t &iter) : iterator_impl(iter)
 	{
 
 	}
-	
+
 	virtual bool move_previous() override
 	{
 		if(auto source = lock_same())
 		{
-			if(!source->ordered()) return false;
-
-			if(_position == source->end())
+			if(_position == source->shared_end())
 			{
 				return false;
-			}else if(_position == source->begin())
+			}else if(_position == source->shared_begin())
 			{
-				_position = source->end();
+				_position = source->shared_end();
 				_state = state::outside;
 				return false;
 			}else{
@@ -791,13 +1754,10 @@ public:
 	{
 		if(auto source = _source.lock())
 		{
-			if(!source->ordered()) return false;
-
 			_revision = source->get_revision();
-			_position = source->end();
-			if(_position != source->begin())
+			_position = source->last_iter();
+			if(_position != source->shared_end())
 			{
-				--_position;
 				_state = state::at_element;
 				return true;
 			}else{
@@ -809,45 +1769,49 @@ public:
 
 	virtual std::unique_ptr<dyn_iterator> clone() const override
 	{
-		return std::make_unique<map_iterator_t>(*this);
+		return std::make_unique<pool_iterator_t>(*this);
 	}
 
 	virtual std::shared_ptr<dyn_iterator> clone_shared() const override
 	{
-		return std::make_shared<map_iterator_t>(*this);
+		return std::make_shared<pool_iterator_t>(*this);
 	}
+
+	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
 };
 
-class linked_list_iterator_t : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
+class heap_iterator_t : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
 {
 protected:
-	typedef typename linked_list_t::iterator iterator;
-	typedef typename linked_list_t::value_type value_type;
-	std::weak_ptr<linked_list_t> _source;
-	iterator _position;
-	std::weak_ptr<dyn_object> _current;
+	std::weak_ptr<heap_t> _source;
+	std::weak_ptr<heap_node> _current;
 	bool _before;
 
-	virtual std::shared_ptr<linked_list_t> lock_same();
-	virtual std::shared_ptr<linked_list_t> lock_same() const;
+	std::shared_ptr<heap_node> current(const heap_t &source) const;
 
 public:
-	/*linked_list_iterator_t()
+	/*heap_iterator_t()
 	{
 
 	}*/
 
-	linked_list_iterator_t(const std::shared_ptr<linked_list_t> source) : linked_list_iterator_t(source, source->begin())
+	heap_iterator_t(const std::shared_ptr<heap_t> source) : heap_iterator_t(source, 0)
 	{
 
 	}
 
-	linked_list_iterator_t(const std::shared_ptr<linked_list_t> source, iterator position) : _source(source), _position(position), _current(position != source->end() ? *position : nullptr), _before(false)
+	heap_iterator_t(const std::shared_ptr<heap_t> source, size_t index) : _source(source), _before(false)
 	{
-
+		if(index < source->size())
+		{
+			_current = source->node_at(index);
+		}
 	}
 
-	linked_list_iterator_t(const linked_list_iterator_t &iter) = default;
+	heap_iterator_t(const heap_iterator_t &iter) = default;
+
+	// Replaces the value of the element and moves it to its new place in the heap
+	bool update(dyn_object &&value);
 
 	virtual bool expired() const override;
 	virtual bool valid() const override;
@@ -883,25 +1847,25 @@ public:
 	}
 };
 
-class pool_iterator_t : public iterator_impl<pool_t>
+class deque_iterator_t : public iterator_impl<deque_t>
 {
 public:
-	/*pool_iterator_t()
+	/*deque_iterator_t()
 	{
 
 	}*/
 
-	pool_iterator_t(const std::shared_ptr<pool_t> source) : iterator_impl(source)
+	deque_iterator_t(const std::shared_ptr<deque_t> source) : iterator_impl(source)
 	{
 
 	}
 
-	pool_iterator_t(const std::shared_ptr<pool_t> source, iterator position) : iterator_impl(source, position)
+	deque_iterator_t(const std::shared_ptr<deque_t> source, iterator position) : iterator_impl(source, position)
 	{
 
 	}
 
-	pool_iterator_t(const pool_iterator_t &iter) : iterator_impl(iter)
+	deque_iterator_t(const deque_iterator_t &iter) : iterator_impl(iter)
 	{
 
 	}
@@ -910,12 +1874,12 @@ public:
 	{
 		if(auto source = lock_same())
 		{
-			if(_position == source->end())
+			if(_position == source->shared_end())
 			{
 				return false;
-			}else if(_position == source->begin())
+			}else if(_position == source->shared_begin())
 			{
-				_position = source->end();
+				_position = source->shared_end();
 				_state = state::outside;
 				return false;
 			}else{
@@ -932,9 +1896,10 @@ public:
 		if(auto source = _source.lock())
 		{
 			_revision = source->get_revision();
-			_position = source->last_iter();
-			if(_position != source->end())
+			_position = source->shared_end();
+			if(_position != source->shared_begin())
 			{
+				--_position;
 				_state = state::at_element;
 				return true;
 			}else{
@@ -946,15 +1911,84 @@ public:
 
 	virtual std::unique_ptr<dyn_iterator> clone() const override
 	{
-		return std::make_unique<pool_iterator_t>(*this);
+		return std::make_unique<deque_iterator_t>(*this);
 	}
 
 	virtual std::shared_ptr<dyn_iterator> clone_shared() const override
 	{
-		return std::make_shared<pool_iterator_t>(*this);
+		return std::make_shared<deque_iterator_t>(*this);
+	}
+
+	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
+};
+
+// Points to a value rather than a position, so it stays usable when the set is modified
+class bitset_iterator_t : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
+{
+protected:
+	enum class state
+	{
+		outside,
+		at_element,
+		before_element
+	};
+
+	std::weak_ptr<bitset_t> _source;
+	dyn_object _current;
+	state _state;
+
+	bool move_to(const bitset_t &source, bitset_t::const_iterator it);
+
+public:
+	/*bitset_iterator_t()
+	{
+
+	}*/
+
+	bitset_iterator_t(const std::shared_ptr<bitset_t> source) : bitset_iterator_t(source, 0)
+	{
+
 	}
 
+	bitset_iterator_t(const std::shared_ptr<bitset_t> source, cell value) : _source(source), _state(state::outside)
+	{
+		move_to(*source, source->lower_bound(value));
+	}
+
+	bitset_iterator_t(const bitset_iterator_t &iter) = default;
+
+	virtual bool expired() const override;
+	virtual bool valid() const override;
+	virtual bool empty() const override;
+	virtual bool move_next() override;
+	virtual bool move_previous() override;
+	virtual bool set_to_first() override;
+	virtual bool set_to_last() override;
+	virtual bool reset() override;
+	virtual size_t get_hash() const override;
+	virtual bool erase(bool stay) override;
+	virtual std::unique_ptr<dyn_iterator> clone() const override;
+	virtual std::shared_ptr<dyn_iterator> clone_shared() const override;
+	virtual bool operator==(const dyn_iterator &obj) const override;
+
+	virtual bool can_reset() const override;
+	virtual bool can_insert() const override;
+	virtual bool can_erase() const override;
+
 	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
+	virtual bool insert_dyn(const std::type_info &type, void *value) override;
+	virtual bool insert_dyn(const std::type_info &type, const void *value) override;
+
+public:
+	virtual dyn_iterator *get() override
+	{
+		return this;
+	}
+
+	virtual const dyn_iterator *get() const override
+	{
+		return this;
+	}
 };
 
 class handle_t
@@ -1051,11 +2085,16 @@ public:
 	}
 };
 
-extern aux::shared_id_set_pool<list_t> list_pool;
-extern aux::shared_id_set_pool<map_t> map_pool;
-extern aux::shared_id_set_pool<linked_list_t> linked_list_pool;
-extern aux::shared_id_set_pool<pool_t> pool_pool;
+extern aux::slot_map_pool<list_t> list_pool;
+extern aux::slot_map_pool<map_t> map_pool;
+extern aux::slot_map_pool<linked_list_t> linked_list_pool;
+extern aux::slot_map_pool<pool_t> pool_pool;
+extern aux::slot_map_pool<heap_t> heap_pool;
+extern aux::slot_map_pool<deque_t> deque_pool;
+extern aux::slot_map_pool<bitset_t> bitset_pool;
 extern object_pool<dyn_iterator> iter_pool;
 extern object_pool<handle_t> handle_pool;
 
+void map_rehash_tick(size_t budget);
+
 #endif
@@ -429,300 +429,374 @@ bool handle_iterator::extract_dyn(const std::type_info &type, void *value) const
 	return false;
 }
 
-bool filter_iterator::is_valid(expression::args_type args) const
+pipeline_iterator::pipeline_iterator(std::shared_ptr<dyn_iterator> &&source, stage &&first) : source(std::move(source))
 {
-	return value_read(source.get(), [&](const dyn_object &val)
-	{
-		if(args.size() == 0)
-		{
-			args.push_back(std::ref(val));
-		}else{
-			args[0] = std::ref(val);
-		}
-		try{
-			return key_read(source.get(), [&](const dyn_object &key)
-			{
-				if(args.size() == 1)
-				{
-					args.push_back(std::ref(key));
-				}else{
-					args[1] = std::ref(key);
-				}
-				return expr->execute_bool(args, expression::exec_info());
-			});
-		}catch(const errors::native_error&)
-		{
-			args.erase(std::next(args.begin()), args.end());
-			return expr->execute_bool(args, expression::exec_info());
-		}
-	});
+	stages.emplace_back(std::move(first));
+	init();
 }
 
-void filter_iterator::find_valid()
+pipeline_iterator::pipeline_iterator(const pipeline_iterator &base, stage &&next) : source(base.source->clone_shared()), stages(base.stages)
 {
-	expression::args_type args;
-	do{
-		if(is_valid(args))
-		{
-			return;
-		}
-	}while(source->move_next());
+	stages.emplace_back(std::move(next));
+	init();
 }
 
-bool filter_iterator::expired() const
+pipeline_iterator::pipeline_iterator(const pipeline_iterator &iter) : source(iter.source->clone_shared()), stages(iter.stages), states(iter.states), inside(iter.inside), stateless(iter.stateless), current_value(iter.current_value), current_pair(iter.current_pair)
 {
-	return source->expired();
-}
 
-bool filter_iterator::valid() const
-{
-	return source->valid();
 }
 
-bool filter_iterator::move_next()
+void pipeline_iterator::init()
 {
-	expression::args_type args;
-	while(source->move_next())
+	states.resize(stages.size());
+	stateless = true;
+	for(const auto &st : stages)
 	{
-		if(is_valid(args))
+		if(st.op != operation::filter && st.op != operation::project)
 		{
-			return true;
+			stateless = false;
 		}
 	}
-	return false;
+	inside = false;
+	find_next(true);
 }
 
-bool filter_iterator::move_previous()
+// Runs the operations on the current element of the source, returning false if it is left out.
+// finished is set when no further elements can pass.
+bool pipeline_iterator::accept(bool &finished)
 {
-	expression::args_type args;
-	while(source->move_previous())
+	current_value = nullptr;
+	current_pair = nullptr;
+
+	const dyn_object *val = nullptr;
+	const dyn_object *key = nullptr;
+	bool key_read = false;
+	std::shared_ptr<const dyn_object> source_value;
+	std::shared_ptr<const std::pair<const dyn_object, dyn_object>> source_pair;
+
+	auto read_value = [&]()
 	{
-		if(is_valid(args))
+		if(val != nullptr)
 		{
-			return true;
+			return;
+		}
+		const dyn_object *cobj;
+		if(source->extract(cobj))
+		{
+			val = cobj;
+			return;
+		}
+		if(source->extract(source_value))
+		{
+			val = source_value.get();
+			return;
+		}
+		const std::pair<const dyn_object, dyn_object> *cpair;
+		if(source->extract(cpair))
+		{
+			val = &cpair->second;
+			key = &cpair->first;
+			key_read = true;
+			return;
+		}
+		if(source->extract(source_pair))
+		{
+			val = &source_pair->second;
+			key = &source_pair->first;
+			key_read = true;
+			return;
+		}
+		amx_LogicError(errors::operation_not_supported, "iterator");
+	};
+
+	// the key is passed to expressions if the source has one
+	auto read_args = [&]()
+	{
+		read_value();
+		if(!key_read)
+		{
+			key_read = true;
+			const std::pair<const dyn_object, dyn_object> *cpair;
+			if(source->extract(cpair))
+			{
+				key = &cpair->first;
+			}else if(source_pair || source->extract(source_pair))
+			{
+				key = &source_pair->first;
+			}
+		}
+		args.clear();
+		args.push_back(std::cref(*val));
+		if(key != nullptr)
+		{
+			args.push_back(std::cref(*key));
+		}
+	};
+
+	for(size_t i = 0; i < stages.size(); i++)
+	{
+		const auto &st = stages[i];
+		auto &state = states[i];
+		switch(st.op)
+		{
+			case operation::filter:
+			{
+				read_args();
+				if(!st.expr->execute_bool(args, expression::exec_info()))
+				{
+					return false;
+				}
+			}
+			break;
+			case operation::project:
+			{
+				read_args();
+				dyn_object result = st.expr->execute(args, expression::exec_info());
+				if(key != nullptr)
+				{
+					auto pair = std::make_shared<const std::pair<const dyn_object, dyn_object>>(*key, std::move(result));
+					current_pair = std::move(pair);
+					current_value = nullptr;
+					key = &current_pair->first;
+					val = &current_pair->second;
+				}else{
+					current_value = std::make_shared<const dyn_object>(std::move(result));
+					val = current_value.get();
+				}
+			}
+			break;
+			case operation::skip:
+			{
+				if(state.counter < st.count)
+				{
+					state.counter++;
+					return false;
+				}
+			}
+			break;
+			case operation::take:
+			{
+				if(state.counter >= st.count)
+				{
+					finished = true;
+					return false;
+				}
+				state.counter++;
+			}
+			break;
+			case operation::distinct:
+			{
+				read_value();
+				if(!state.seen.insert(*val).second)
+				{
+					return false;
+				}
+			}
+			break;
+			case operation::zip:
+			{
+				// the first element is paired with the current element of the other iterator
+				if(state.counter == 0 ? !st.other->valid() : !st.other->move_next())
+				{
+					finished = true;
+					return false;
+				}
+				state.counter++;
+				read_value();
+				value_read(st.other.get(), [&](const dyn_object &obj)
+				{
+					auto pair = std::make_shared<const std::pair<const dyn_object, dyn_object>>(*val, obj);
+					current_pair = std::move(pair);
+				});
+				current_value = nullptr;
+				key = &current_pair->first;
+				val = &current_pair->second;
+				key_read = true;
+			}
+			break;
 		}
 	}
-	return false;
+	return true;
 }
 
-bool filter_iterator::set_to_first()
+bool pipeline_iterator::find_next(bool from_current)
 {
-	if(source->set_to_first())
+	if(from_current ? source->valid() : source->move_next())
 	{
-		expression::args_type args;
 		do{
-			if(is_valid(args))
+			bool finished = false;
+			if(accept(finished))
 			{
+				inside = true;
 				return true;
 			}
+			if(finished)
+			{
+				break;
+			}
 		}while(source->move_next());
 	}
+	inside = false;
+	current_value = nullptr;
+	current_pair = nullptr;
 	return false;
 }
 
-bool filter_iterator::set_to_last()
+bool pipeline_iterator::find_previous(bool from_current)
 {
-	if(source->set_to_last())
+	if(from_current ? source->valid() : source->move_previous())
 	{
-		expression::args_type args;
 		do{
-			if(is_valid(args))
+			bool finished = false;
+			if(accept(finished))
 			{
+				inside = true;
 				return true;
 			}
 		}while(source->move_previous());
 	}
+	inside = false;
+	current_value = nullptr;
+	current_pair = nullptr;
 	return false;
 }
 
-bool filter_iterator::reset()
-{
-	return source->reset();
-}
-
-bool filter_iterator::erase(bool stay)
-{
-	return source->erase(stay);
-}
-
-bool filter_iterator::can_reset() const
+void pipeline_iterator::restart(bool to_first)
 {
-	return source->can_reset();
-}
-
-bool filter_iterator::can_erase() const
-{
-	return source->can_erase();
-}
-
-bool filter_iterator::can_insert() const
-{
-	return source->can_insert();
+	for(size_t i = 0; i < stages.size(); i++)
+	{
+		states[i] = stage_state();
+		if(stages[i].op == operation::zip)
+		{
+			if(to_first)
+			{
+				stages[i].other->set_to_first();
+			}else{
+				stages[i].other->reset();
+			}
+		}
+	}
+	inside = false;
+	current_value = nullptr;
+	current_pair = nullptr;
 }
 
-std::unique_ptr<dyn_iterator> filter_iterator::clone() const
+bool pipeline_iterator::expired() const
 {
-	return std::make_unique<filter_iterator>(*this);
+	return source->expired();
 }
 
-std::shared_ptr<dyn_iterator> filter_iterator::clone_shared() const
+bool pipeline_iterator::valid() const
 {
-	return std::make_shared<filter_iterator>(*this);
+	return inside && source->valid();
 }
 
-size_t filter_iterator::get_hash() const
+bool pipeline_iterator::move_next()
 {
-	return source->get_hash();
+	return find_next(false);
 }
 
-bool filter_iterator::operator==(const dyn_iterator &obj) const
+bool pipeline_iterator::move_previous()
 {
-	auto other = dynamic_cast<const filter_iterator*>(&obj);
-	if(other != nullptr)
+	if(!stateless)
 	{
-		if(valid())
-		{
-			return other->valid() && source == other->source && expr == other->expr;
-		}else{
-			return !other->valid();
-		}
+		return false;
 	}
-	return false;
-}
-
-bool filter_iterator::extract_dyn(const std::type_info &type, void *value) const
-{
-	return source->extract_dyn(type, value);
+	return find_previous(false);
 }
 
-bool filter_iterator::insert_dyn(const std::type_info &type, void *value)
+bool pipeline_iterator::set_to_first()
 {
-	if(type == typeid(dyn_object))
-	{
-		auto &obj = *reinterpret_cast<dyn_object*>(value);
-		if(expr->execute_bool({std::cref(obj)}, expression::exec_info()))
-		{
-			return source->insert_dyn(type, value);
-		}
-	}else if(type == typeid(std::pair<const dyn_object, dyn_object>))
+	restart(true);
+	if(source->set_to_first())
 	{
-		auto &obj = *reinterpret_cast<std::pair<const dyn_object, dyn_object>*>(value);
-		if(expr->execute_bool({std::cref(obj.second), std::cref(obj.first)}, expression::exec_info()))
-		{
-			return source->insert_dyn(type, value);
-		}
+		return find_next(true);
 	}
 	return false;
 }
 
-bool filter_iterator::insert_dyn(const std::type_info &type, const void *value)
+bool pipeline_iterator::set_to_last()
 {
-	if(type == typeid(dyn_object))
+	if(!stateless)
 	{
-		auto &obj = *reinterpret_cast<const dyn_object*>(value);
-		if(expr->execute_bool({std::ref(obj)}, expression::exec_info()))
-		{
-			return source->insert_dyn(type, value);
-		}
-	}else if(type == typeid(std::pair<const dyn_object, dyn_object>))
+		return false;
+	}
+	restart(true);
+	if(source->set_to_last())
 	{
-		auto &obj = *reinterpret_cast<const std::pair<const dyn_object, dyn_object>*>(value);
-		if(expr->execute_bool({std::ref(obj.second), std::ref(obj.first)}, expression::exec_info()))
-		{
-			return source->insert_dyn(type, value);
-		}
+		return find_previous(true);
 	}
 	return false;
 }
 
-dyn_iterator *filter_iterator::get()
-{
-	return this;
-}
-
-const dyn_iterator *filter_iterator::get() const
-{
-	return this;
-}
-
-bool project_iterator::expired() const
-{
-	return source->expired();
-}
-
-bool project_iterator::valid() const
-{
-	return source->valid();
-}
-
-bool project_iterator::move_next()
-{
-	return source->move_next();
-}
-
-bool project_iterator::move_previous()
-{
-	return source->move_previous();
-}
-
-bool project_iterator::set_to_first()
-{
-	return source->set_to_first();
-}
-
-bool project_iterator::set_to_last()
-{
-	return source->set_to_last();
-}
-
-bool project_iterator::reset()
+bool pipeline_iterator::reset()
 {
+	restart(false);
 	return source->reset();
 }
 
-bool project_iterator::erase(bool stay)
+bool pipeline_iterator::erase(bool stay)
 {
-	return source->erase(stay);
+	if(!stateless || !valid() || !source->erase(stay))
+	{
+		return false;
+	}
+	if(stay)
+	{
+		// the source is before the next element, which is checked when it is moved to
+		current_value = nullptr;
+		current_pair = nullptr;
+	}else{
+		find_next(true);
+	}
+	return true;
 }
 
-bool project_iterator::can_reset() const
+bool pipeline_iterator::can_reset() const
 {
 	return source->can_reset();
 }
 
-bool project_iterator::can_erase() const
+bool pipeline_iterator::can_erase() const
 {
-	return source->can_erase();
+	return stateless && valid() && source->can_erase();
 }
 
-bool project_iterator::can_insert() const
+bool pipeline_iterator::can_insert() const
 {
-	return false;
+	for(const auto &st : stages)
+	{
+		if(st.op != operation::filter)
+		{
+			return false;
+		}
+	}
+	return source->can_insert();
 }
 
-std::unique_ptr<dyn_iterator> project_iterator::clone() const
+std::unique_ptr<dyn_iterator> pipeline_iterator::clone() const
 {
-	return std::make_unique<project_iterator>(*this);
+	return std::make_unique<pipeline_iterator>(*this);
 }
 
-std::shared_ptr<dyn_iterator> project_iterator::clone_shared() const
+std::shared_ptr<dyn_iterator> pipeline_iterator::clone_shared() const
 {
-	return std::make_shared<project_iterator>(*this);
+	return std::make_shared<pipeline_iterator>(*this);
 }
 
-size_t project_iterator::get_hash() const
+size_t pipeline_iterator::get_hash() const
 {
 	return source->get_hash();
 }
 
-bool project_iterator::operator==(const dyn_iterator &obj) const
+bool pipeline_iterator::operator==(const dyn_iterator &obj) const
 {
-	auto other = dynamic_cast<const project_iterator*>(&obj);
+	auto other = dynamic_cast<const pipeline_iterator*>(&obj);
 	if(other != nullptr)
 	{
 		if(valid())
 		{
-			return other->valid() && source == other->source && expr == other->expr;
+			return other->valid() && source == other->source && stages == other->stages;
 		}else{
 			return !other->valid();
 		}
@@ -730,45 +804,96 @@ bool project_iterator::operator==(const dyn_iterator &obj) const
 	return false;
 }
 
-bool project_iterator::extract_dyn(const std::type_info &type, void *value) const
+bool pipeline_iterator::extract_dyn(const std::type_info &type, void *value) const
 {
-	if(type == typeid(std::shared_ptr<const dyn_object>))
+	if(!valid())
 	{
-		return value_read(source.get(), [&](const dyn_object &obj)
+		return false;
+	}
+	if(current_pair)
+	{
+		if(type == typeid(const std::pair<const dyn_object, dyn_object>*))
 		{
-			*reinterpret_cast<std::shared_ptr<const dyn_object>*>(value) = std::make_shared<dyn_object>(expr->execute({std::ref(obj)}, expression::exec_info()));
+			*reinterpret_cast<const std::pair<const dyn_object, dyn_object>**>(value) = current_pair.get();
 			return true;
-		});
-	}else if(type == typeid(std::shared_ptr<const std::pair<const dyn_object, dyn_object>>))
+		}else if(type == typeid(std::shared_ptr<const std::pair<const dyn_object, dyn_object>>))
+		{
+			*reinterpret_cast<std::shared_ptr<const std::pair<const dyn_object, dyn_object>>*>(value) = current_pair;
+			return true;
+		}
+		return false;
+	}
+	if(current_value)
 	{
-		return value_read(source.get(), [&](const dyn_object &val)
+		if(type == typeid(const dyn_object*))
 		{
-			return key_read(source.get(), [&](const dyn_object &key)
-			{
-				*reinterpret_cast<std::shared_ptr<const std::pair<const dyn_object, dyn_object>>*>(value) = std::make_shared<std::pair<const dyn_object, dyn_object>>(key, expr->execute({std::ref(val), std::ref(key)}, expression::exec_info()));
-				return true;
-			});
-		});
+			*reinterpret_cast<const dyn_object**>(value) = current_value.get();
+			return true;
+		}else if(type == typeid(std::shared_ptr<const dyn_object>))
+		{
+			*reinterpret_cast<std::shared_ptr<const dyn_object>*>(value) = current_value;
+			return true;
+		}
+		return false;
 	}
-	return false;
+	return source->extract_dyn(type, value);
 }
 
-bool project_iterator::insert_dyn(const std::type_info &type, void *value)
+template <class Value>
+static bool insert_filtered(dyn_iterator &source, const std::vector<pipeline_iterator::stage> &stages, const std::type_info &type, Value *value)
 {
+	expression::args_type args;
+	if(type == typeid(dyn_object))
+	{
+		args.push_back(std::cref(*reinterpret_cast<const dyn_object*>(value)));
+	}else if(type == typeid(std::pair<const dyn_object, dyn_object>))
+	{
+		auto &obj = *reinterpret_cast<const std::pair<const dyn_object, dyn_object>*>(value);
+		args.push_back(std::cref(obj.second));
+		args.push_back(std::cref(obj.first));
+	}else{
+		return false;
+	}
+	for(const auto &st : stages)
+	{
+		if(st.op != pipeline_iterator::operation::filter || !st.expr->execute_bool(args, expression::exec_info()))
+		{
+			return false;
+		}
+	}
+	return source.insert_dyn(type, value);
+}
+
+bool pipeline_iterator::insert_dyn(const std::type_info &type, void *value)
+{
+	if(insert_filtered(*source, stages, type, value))
+	{
+		inside = true;
+		current_value = nullptr;
+		current_pair = nullptr;
+		return true;
+	}
 	return false;
 }
 
-bool project_iterator::insert_dyn(const std::type_info &type, const void *value)
+bool pipeline_iterator::insert_dyn(const std::type_info &type, const void *value)
 {
+	if(insert_filtered(*source, stages, type, value))
+	{
+		inside = true;
+		current_value = nullptr;
+		current_pair = nullptr;
+		return true;
+	}
 	return false;
 }
 
-dyn_iterator *project_iterator::get()
+dyn_iterator *pipeline_iterator::get()
 {
 	return this;
 }
 
-const dyn_iterator *project_iterator::get() const
+const dyn_iterator *pipeline_iterator::get() const
 {
 	return this;
 }
@@ -5,6 +5,8 @@
 #include "modules/containers.h"
 #include "modules/expressions.h"
 
+#include <unordered_set>
+
 class range_iterator : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
 {
 	cell index;
@@ -294,51 +296,87 @@ auto key_value_access(dyn_iterator *iter, Func f) -> typename std::result_of<Fun
 	return f(tmp);
 }
 
-class filter_iterator : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
+// Applies a chain of operations to the elements of another iterator in a single pass.
+// The source is always a clone owned by the pipeline, so the iterator it was made from is never moved.
+// Adding an operation to a pipeline of filters and projections extends a copy of it
+// instead of wrapping it in another iterator.
+class pipeline_iterator : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
 {
-	std::shared_ptr<dyn_iterator> source;
-	expression_ptr expr;
-
-	bool is_valid(expression::args_type args) const;
-	void find_valid();
-
 public:
-	filter_iterator(std::shared_ptr<dyn_iterator> &&source, expression_ptr &&expr) : source(std::move(source)), expr(std::move(expr))
+	enum class operation
 	{
-		find_valid();
-	}
+		filter,
+		project,
+		skip,
+		take,
+		distinct,
+		zip
+	};
+
+	struct stage
+	{
+		operation op;
+		expression_ptr expr;
+		cell count;
+		std::shared_ptr<dyn_iterator> other;
 
-	virtual bool expired() const override;
-	virtual bool valid() const override;
-	virtual bool move_next() override;
-	virtual bool move_previous() override;
-	virtual bool set_to_first() override;
-	virtual bool set_to_last() override;
-	virtual bool reset() override;
-	virtual bool erase(bool stay) override;
-	virtual bool can_reset() const override;
-	virtual bool can_erase() const override;
-	virtual bool can_insert() const override;
-	virtual std::unique_ptr<dyn_iterator> clone() const override;
-	virtual std::shared_ptr<dyn_iterator> clone_shared() const override;
-	virtual size_t get_hash() const override;
-	virtual bool operator==(const dyn_iterator &obj) const override;
-	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
-	virtual bool insert_dyn(const std::type_info &type, void *value) override;
-	virtual bool insert_dyn(const std::type_info &type, const void *value) override;
-	virtual dyn_iterator *get() override;
-	virtual const dyn_iterator *get() const override;
-};
+		stage(operation op, expression_ptr &&expr) : op(op), expr(std::move(expr)), count(0)
+		{
+
+		}
+
+		stage(operation op, cell count) : op(op), count(count)
+		{
+
+		}
+
+		stage(std::shared_ptr<dyn_iterator> &&other) : op(operation::zip), count(0), other(std::move(other))
+		{
+
+		}
+
+		bool operator==(const stage &obj) const
+		{
+			return op == obj.op && expr == obj.expr && count == obj.count && other == obj.other;
+		}
+	};
+
+private:
+	struct stage_state
+	{
+		cell counter = 0;
+		std::unordered_set<dyn_object> seen;
+	};
 
-class project_iterator : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
-{
 	std::shared_ptr<dyn_iterator> source;
-	expression_ptr expr;
+	std::vector<stage> stages;
+	std::vector<stage_state> states;
+	bool inside;
+	// only filters and projections, which don't depend on the previous elements
+	bool stateless;
+	// the element after the operations, if any of them produced a new one
+	std::shared_ptr<const dyn_object> current_value;
+	std::shared_ptr<const std::pair<const dyn_object, dyn_object>> current_pair;
+	// reused for every element
+	expression::args_type args;
+
+	void init();
+	bool accept(bool &finished);
+	bool find_next(bool from_current);
+	bool find_previous(bool from_current);
+	void restart(bool to_first);
 
 public:
-	project_iterator(std::shared_ptr<dyn_iterator> &&source, expression_ptr &&expr) : source(std::move(source)), expr(std::move(expr))
+	// The source must not be shared with other iterators
+	pipeline_iterator(std::shared_ptr<dyn_iterator> &&source, stage &&first);
+	// A new pipeline over a clone of the source with one more operation, so the base is not moved
+	pipeline_iterator(const pipeline_iterator &base, stage &&next);
+	pipeline_iterator(const pipeline_iterator &iter);
+
+	// Whether the operations can be repeated on a clone of the source, starting at its current element
+	bool extendable() const
 	{
-
+		return stateless;
 	}
 
 	virtual bool expired() const override;
@@ -10,7 +10,7 @@ bool serialize_value(cell value, tag_ptr tag, void(*binary_writer)(void*, const
 	{
 		case tags::tag_list:
 		{
-			list_t *ptr;
+			const list_t *ptr;
 			if(!list_pool.get_by_id(value, ptr))
 			{
 				return false;
@@ -25,7 +25,7 @@ bool serialize_value(cell value, tag_ptr tag, void(*binary_writer)(void*, const
 		}
 		case tags::tag_map:
 		{
-			map_t *ptr;
+			const map_t *ptr;
 			if(!map_pool.get_by_id(value, ptr))
 			{
 				return false;
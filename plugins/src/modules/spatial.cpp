@@ -0,0 +1,601 @@
+#include "spatial.h"
+#include "modules/tags.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+aux::slot_map_pool<spatial_t> spatial_pool;
+
+// cell coordinates are stored in 21 bits each
+static constexpr int coord_limit = (1 << 20) - 1;
+static constexpr uint64_t coord_mask = (static_cast<uint64_t>(1) << 21) - 1;
+
+int spatial_t::cell_coord(float value) const
+{
+	float c = std::floor(value / cell_size);
+	if(!(c > -coord_limit))
+	{
+		return -coord_limit;
+	}
+	if(c > coord_limit)
+	{
+		return coord_limit;
+	}
+	return static_cast<int>(c);
+}
+
+uint64_t spatial_t::cell_key(int x, int y, int z)
+{
+	return (static_cast<uint64_t>(x + coord_limit) << 42) | (static_cast<uint64_t>(y + coord_limit) << 21) | static_cast<uint64_t>(z + coord_limit);
+}
+
+void spatial_t::cell_of_key(uint64_t key, int &x, int &y, int &z)
+{
+	x = static_cast<int>((key >> 42) & coord_mask) - coord_limit;
+	y = static_cast<int>((key >> 21) & coord_mask) - coord_limit;
+	z = static_cast<int>(key & coord_mask) - coord_limit;
+}
+
+void spatial_t::link(size_t id)
+{
+	const entry &e = entries[id];
+	int c[3] = {cell_coord(e.x), cell_coord(e.y), cell_coord(e.z)};
+	grid[cell_key(c[0], c[1], c[2])].push_back(id);
+	for(int i = 0; i < 3; i++)
+	{
+		if(!bounded || c[i] < min_cell[i])
+		{
+			min_cell[i] = c[i];
+		}
+		if(!bounded || c[i] > max_cell[i])
+		{
+			max_cell[i] = c[i];
+		}
+	}
+	bounded = true;
+}
+
+void spatial_t::unlink(size_t id)
+{
+	const entry &e = entries[id];
+	auto it = grid.find(cell_key(cell_coord(e.x), cell_coord(e.y), cell_coord(e.z)));
+	if(it != grid.end())
+	{
+		auto &ids = it->second;
+		auto pos = std::find(ids.begin(), ids.end(), id);
+		if(pos != ids.end())
+		{
+			*pos = ids.back();
+			ids.pop_back();
+		}
+		if(ids.empty())
+		{
+			grid.erase(it);
+		}
+	}
+}
+
+template <class Func>
+void spatial_t::visit_box(float min_x, float min_y, float min_z, float max_x, float max_y, float max_z, Func f) const
+{
+	if(!bounded || count == 0)
+	{
+		return;
+	}
+	int x0 = std::max(cell_coord(min_x), min_cell[0]), x1 = std::min(cell_coord(max_x), max_cell[0]);
+	int y0 = std::max(cell_coord(min_y), min_cell[1]), y1 = std::min(cell_coord(max_y), max_cell[1]);
+	int z0 = std::max(cell_coord(min_z), min_cell[2]), z1 = std::min(cell_coord(max_z), max_cell[2]);
+	if(x0 > x1 || y0 > y1 || z0 > z1)
+	{
+		return;
+	}
+	uint64_t cells = static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(y1 - y0 + 1) * static_cast<uint64_t>(z1 - z0 + 1);
+	if(cells > grid.size())
+	{
+		for(const auto &pair : grid)
+		{
+			int x, y, z;
+			cell_of_key(pair.first, x, y, z);
+			if(x >= x0 && x <= x1 && y >= y0 && y <= y1 && z >= z0 && z <= z1)
+			{
+				for(size_t id : pair.second)
+				{
+					f(id);
+				}
+			}
+		}
+		return;
+	}
+	for(int x = x0; x <= x1; x++)
+	{
+		for(int y = y0; y <= y1; y++)
+		{
+			for(int z = z0; z <= z1; z++)
+			{
+				visit_cell(x, y, z, f);
+			}
+		}
+	}
+}
+
+size_t spatial_t::add(float x, float y, float z, dyn_object &&value)
+{
+	size_t id;
+	if(free_entries.empty())
+	{
+		id = entries.size();
+		entries.emplace_back();
+	}else{
+		id = free_entries.back();
+		free_entries.pop_back();
+	}
+	entry &e = entries[id];
+	e.x = x;
+	e.y = y;
+	e.z = z;
+	e.value = std::move(value);
+	e.used = true;
+	++count;
+	link(id);
+	return id;
+}
+
+bool spatial_t::move(size_t id, float x, float y, float z)
+{
+	if(!has(id))
+	{
+		return false;
+	}
+	entry &e = entries[id];
+	bool same_cell = cell_coord(e.x) == cell_coord(x) && cell_coord(e.y) == cell_coord(y) && cell_coord(e.z) == cell_coord(z);
+	if(!same_cell)
+	{
+		unlink(id);
+	}
+	e.x = x;
+	e.y = y;
+	e.z = z;
+	if(!same_cell)
+	{
+		link(id);
+	}
+	return true;
+}
+
+dyn_object spatial_t::remove(size_t id)
+{
+	unlink(id);
+	entry &e = entries[id];
+	dyn_object value = std::move(e.value);
+	e.value = dyn_object();
+	e.used = false;
+	++e.generation;
+	free_entries.push_back(id);
+	--count;
+	return value;
+}
+
+void spatial_t::clear()
+{
+	entries.clear();
+	free_entries.clear();
+	grid.clear();
+	count = 0;
+	bounded = false;
+}
+
+bool spatial_t::clone_is_copy() const
+{
+	for(const auto &e : entries)
+	{
+		if(e.used && !e.value.clone_is_copy())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+auto spatial_t::query_all() const -> std::vector<entry_ref>
+{
+	std::vector<entry_ref> result;
+	result.reserve(count);
+	for(size_t id = 0; id < entries.size(); id++)
+	{
+		if(entries[id].used)
+		{
+			result.push_back(get_ref(id));
+		}
+	}
+	return result;
+}
+
+auto spatial_t::query_radius(float x, float y, float z, float radius, bool sorted) const -> std::vector<entry_ref>
+{
+	std::vector<std::pair<float, size_t>> found;
+	if(radius >= 0)
+	{
+		float max_dist = radius * radius;
+		visit_box(x - radius, y - radius, z - radius, x + radius, y + radius, z + radius, [&](size_t id)
+		{
+			const entry &e = entries[id];
+			float dx = e.x - x, dy = e.y - y, dz = e.z - z;
+			float dist = dx * dx + dy * dy + dz * dz;
+			if(dist <= max_dist)
+			{
+				found.emplace_back(dist, id);
+			}
+		});
+	}
+	if(sorted)
+	{
+		std::sort(found.begin(), found.end());
+	}
+	std::vector<entry_ref> result;
+	result.reserve(found.size());
+	for(const auto &pair : found)
+	{
+		result.push_back(get_ref(pair.second));
+	}
+	return result;
+}
+
+auto spatial_t::query_box(float min_x, float min_y, float min_z, float max_x, float max_y, float max_z) const -> std::vector<entry_ref>
+{
+	if(min_x > max_x) std::swap(min_x, max_x);
+	if(min_y > max_y) std::swap(min_y, max_y);
+	if(min_z > max_z) std::swap(min_z, max_z);
+	std::vector<entry_ref> result;
+	visit_box(min_x, min_y, min_z, max_x, max_y, max_z, [&](size_t id)
+	{
+		const entry &e = entries[id];
+		if(e.x >= min_x && e.x <= max_x && e.y >= min_y && e.y <= max_y && e.z >= min_z && e.z <= max_z)
+		{
+			result.push_back(get_ref(id));
+		}
+	});
+	return result;
+}
+
+// Visits the cells in growing shells around the point, until no unvisited cell can contain a closer entry
+auto spatial_t::query_nearest(float x, float y, float z, size_t max_count, float max_distance) const -> std::vector<entry_ref>
+{
+	std::vector<entry_ref> result;
+	if(max_count == 0 || count == 0)
+	{
+		return result;
+	}
+	float max_dist = max_distance < 0 ? std::numeric_limits<float>::infinity() : max_distance * max_distance;
+
+	// a max-heap of the closest entries found so far
+	std::vector<std::pair<float, size_t>> best;
+	auto consider = [&](size_t id)
+	{
+		const entry &e = entries[id];
+		float dx = e.x - x, dy = e.y - y, dz = e.z - z;
+		float dist = dx * dx + dy * dy + dz * dz;
+		if(dist > max_dist)
+		{
+			return;
+		}
+		if(best.size() < max_count)
+		{
+			best.emplace_back(dist, id);
+			std::push_heap(best.begin(), best.end());
+		}else if(dist < best.front().first)
+		{
+			std::pop_heap(best.begin(), best.end());
+			best.back() = std::make_pair(dist, id);
+			std::push_heap(best.begin(), best.end());
+		}
+	};
+
+	int c[3] = {cell_coord(x), cell_coord(y), cell_coord(z)};
+	int max_ring = 0;
+	for(int i = 0; i < 3; i++)
+	{
+		max_ring = std::max(max_ring, std::max(c[i] - min_cell[i], max_cell[i] - c[i]));
+	}
+
+	for(int ring = 0; ring <= max_ring; ring++)
+	{
+		if(ring > 0)
+		{
+			// entries in unvisited cells are at least this far away
+			float bound = (ring - 1) * cell_size;
+			bound *= bound;
+			if(bound > max_dist || (best.size() == max_count && best.front().first <= bound))
+			{
+				break;
+			}
+		}
+
+		int lo[3], hi[3];
+		uint64_t outer = 1, inner = ring > 0 ? 1 : 0;
+		for(int i = 0; i < 3; i++)
+		{
+			lo[i] = std::max(c[i] - ring, min_cell[i]);
+			hi[i] = std::min(c[i] + ring, max_cell[i]);
+			outer *= hi[i] >= lo[i] ? static_cast<uint64_t>(hi[i] - lo[i] + 1) : 0;
+			int inner_lo = std::max(c[i] - ring + 1, min_cell[i]), inner_hi = std::min(c[i] + ring - 1, max_cell[i]);
+			inner *= inner_hi >= inner_lo ? static_cast<uint64_t>(inner_hi - inner_lo + 1) : 0;
+		}
+
+		if(outer - inner > grid.size())
+		{
+			// the shell is larger than the occupied cells, so the rest is checked directly
+			for(const auto &pair : grid)
+			{
+				int cx, cy, cz;
+				cell_of_key(pair.first, cx, cy, cz);
+				int dist = std::max(std::abs(cx - c[0]), std::max(std::abs(cy - c[1]), std::abs(cz - c[2])));
+				if(dist >= ring)
+				{
+					for(size_t id : pair.second)
+					{
+						consider(id);
+					}
+				}
+			}
+			break;
+		}
+
+		for(int cx = lo[0]; cx <= hi[0]; cx++)
+		{
+			for(int cy = lo[1]; cy <= hi[1]; cy++)
+			{
+				if(std::abs(cx - c[0]) == ring || std::abs(cy - c[1]) == ring)
+				{
+					for(int cz = lo[2]; cz <= hi[2]; cz++)
+					{
+						visit_cell(cx, cy, cz, consider);
+					}
+				}else{
+					if(c[2] - ring >= lo[2])
+					{
+						visit_cell(cx, cy, c[2] - ring, consider);
+					}
+					if(ring > 0 && c[2] + ring <= hi[2])
+					{
+						visit_cell(cx, cy, c[2] + ring, consider);
+					}
+				}
+			}
+		}
+	}
+
+	std::sort_heap(best.begin(), best.end());
+	result.reserve(best.size());
+	for(const auto &pair : best)
+	{
+		result.push_back(get_ref(pair.second));
+	}
+	return result;
+}
+
+size_t spatial_t::memory_size() const
+{
+	size_t size = entries.capacity() * sizeof(entry) + free_entries.capacity() * sizeof(size_t) + grid.memory_size();
+	for(const auto &e : entries)
+	{
+		size += e.value.buffer_size();
+	}
+	for(const auto &pair : grid)
+	{
+		size += pair.second.capacity() * sizeof(size_t);
+	}
+	return size;
+}
+
+
+
+bool spatial_iterator_t::at_entry(const spatial_t &source) const
+{
+	return !_before && _index < _results->size() && source.has((*_results)[_index]);
+}
+
+bool spatial_iterator_t::expired() const
+{
+	return _source.expired();
+}
+
+bool spatial_iterator_t::valid() const
+{
+	if(auto source = _source.lock())
+	{
+		return _index < _results->size();
+	}
+	return false;
+}
+
+bool spatial_iterator_t::empty() const
+{
+	if(auto source = _source.lock())
+	{
+		return !at_entry(*source);
+	}
+	return false;
+}
+
+bool spatial_iterator_t::move_next()
+{
+	if(auto source = _source.lock())
+	{
+		if(_before)
+		{
+			_before = false;
+			return _index < _results->size();
+		}
+		if(_index >= _results->size())
+		{
+			return false;
+		}
+		++_index;
+		return _index < _results->size();
+	}
+	return false;
+}
+
+bool spatial_iterator_t::move_previous()
+{
+	if(auto source = _source.lock())
+	{
+		_before = false;
+		if(_index >= _results->size())
+		{
+			return false;
+		}
+		if(_index == 0)
+		{
+			_index = _results->size();
+			return false;
+		}
+		--_index;
+		return true;
+	}
+	return false;
+}
+
+bool spatial_iterator_t::set_to_first()
+{
+	if(auto source = _source.lock())
+	{
+		_before = false;
+		_index = 0;
+		return _index < _results->size();
+	}
+	return false;
+}
+
+bool spatial_iterator_t::set_to_last()
+{
+	if(auto source = _source.lock())
+	{
+		_before = false;
+		if(_results->size() > 0)
+		{
+			_index = _results->size() - 1;
+			return true;
+		}
+		_index = 0;
+	}
+	return false;
+}
+
+bool spatial_iterator_t::reset()
+{
+	if(auto source = _source.lock())
+	{
+		_before = false;
+		_index = _results->size();
+		return true;
+	}
+	return false;
+}
+
+size_t spatial_iterator_t::get_hash() const
+{
+	if(auto source = _source.lock())
+	{
+		if(_index < _results->size())
+		{
+			const auto &ref = (*_results)[_index];
+			return std::hash<size_t>()(ref.first) ^ std::hash<uint32_t>()(ref.second);
+		}else{
+			return std::hash<spatial_t*>()(source.get());
+		}
+	}
+	return 0;
+}
+
+bool spatial_iterator_t::erase(bool stay)
+{
+	if(auto source = _source.lock())
+	{
+		if(at_entry(*source))
+		{
+			source->remove((*_results)[_index].first);
+			++_index;
+			_before = stay && _index < _results->size();
+		}
+		return true;
+	}
+	return false;
+}
+
+bool spatial_iterator_t::can_reset() const
+{
+	return !_source.expired();
+}
+
+bool spatial_iterator_t::can_erase() const
+{
+	if(auto source = _source.lock())
+	{
+		return at_entry(*source);
+	}
+	return false;
+}
+
+bool spatial_iterator_t::can_insert() const
+{
+	return false;
+}
+
+std::unique_ptr<dyn_iterator> spatial_iterator_t::clone() const
+{
+	return std::make_unique<spatial_iterator_t>(*this);
+}
+
+std::shared_ptr<dyn_iterator> spatial_iterator_t::clone_shared() const
+{
+	return std::make_shared<spatial_iterator_t>(*this);
+}
+
+bool spatial_iterator_t::operator==(const dyn_iterator &obj) const
+{
+	auto other = dynamic_cast<const spatial_iterator_t*>(&obj);
+	if(other != nullptr)
+	{
+		return !_source.owner_before(other->_source) && !other->_source.owner_before(_source) && _results == other->_results && _index == other->_index && _before == other->_before;
+	}
+	return false;
+}
+
+// The key of an element is its id in the container
+bool spatial_iterator_t::extract_dyn(const std::type_info &type, void *value) const
+{
+	if(auto source = _source.lock())
+	{
+		if(at_entry(*source))
+		{
+			size_t id = (*_results)[_index].first;
+			if(type == typeid(dyn_object*))
+			{
+				*reinterpret_cast<dyn_object**>(value) = &(*source)[id].value;
+				return true;
+			}else if(type == typeid(const dyn_object*))
+			{
+				*reinterpret_cast<const dyn_object**>(value) = &(*source)[id].value;
+				return true;
+			}else if(type == typeid(std::shared_ptr<const std::pair<const dyn_object, dyn_object>>))
+			{
+				auto fake_pair = std::make_shared<std::pair<const dyn_object, dyn_object>>(std::pair<const dyn_object, dyn_object>(dyn_object(static_cast<cell>(id), tags::find_tag(tags::tag_cell)), (*source)[id].value));
+				*reinterpret_cast<std::shared_ptr<const std::pair<const dyn_object, dyn_object>>*>(value) = std::move(fake_pair);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool spatial_iterator_t::insert_dyn(const std::type_info &type, void *value)
+{
+	return false;
+}
+
+bool spatial_iterator_t::insert_dyn(const std::type_info &type, const void *value)
+{
+	return false;
+}
@@ -0,0 +1,183 @@
+#ifndef SPATIAL_H_INCLUDED
+#define SPATIAL_H_INCLUDED
+
+#include "modules/containers.h"
+#include "utils/flat_hash_map.h"
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+
+// Values stored at points in space, indexed by a uniform grid of cubic cells.
+// A query only visits the cells overlapping the searched area,
+// or all occupied cells if there are fewer of them. Points in 2D have z set to 0.
+class spatial_t : public aux::slot_map_hook
+{
+public:
+	struct entry
+	{
+		float x, y, z;
+		dyn_object value;
+		uint32_t generation = 0;
+		bool used = false;
+	};
+
+	// Identifies an entry; the generation changes when the slot is reused
+	typedef std::pair<size_t, uint32_t> entry_ref;
+
+private:
+	float cell_size;
+	std::vector<entry> entries;
+	std::vector<size_t> free_entries;
+	size_t count = 0;
+	aux::flat_hash_map<uint64_t, std::vector<size_t>> grid;
+	// the range of cells that were ever occupied
+	int min_cell[3] = {};
+	int max_cell[3] = {};
+	bool bounded = false;
+
+	int cell_coord(float value) const;
+	static uint64_t cell_key(int x, int y, int z);
+	static void cell_of_key(uint64_t key, int &x, int &y, int &z);
+	void link(size_t id);
+	void unlink(size_t id);
+
+	template <class Func>
+	void visit_cell(int x, int y, int z, Func f) const
+	{
+		auto it = grid.find(cell_key(x, y, z));
+		if(it != grid.end())
+		{
+			for(size_t id : it->second)
+			{
+				f(id);
+			}
+		}
+	}
+
+	template <class Func>
+	void visit_box(float min_x, float min_y, float min_z, float max_x, float max_y, float max_z, Func f) const;
+
+public:
+	spatial_t(float cell_size = 10.0f) : cell_size(cell_size)
+	{
+
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	float get_cell_size() const
+	{
+		return cell_size;
+	}
+
+	bool has(size_t id) const
+	{
+		return id < entries.size() && entries[id].used;
+	}
+
+	bool has(const entry_ref &ref) const
+	{
+		return has(ref.first) && entries[ref.first].generation == ref.second;
+	}
+
+	entry &operator[](size_t id)
+	{
+		return entries[id];
+	}
+
+	const entry &operator[](size_t id) const
+	{
+		return entries[id];
+	}
+
+	entry_ref get_ref(size_t id) const
+	{
+		return entry_ref(id, entries[id].generation);
+	}
+
+	template <class Func>
+	void for_each(Func f)
+	{
+		for(auto &e : entries)
+		{
+			if(e.used)
+			{
+				f(e.value);
+			}
+		}
+	}
+
+	size_t add(float x, float y, float z, dyn_object &&value);
+	bool move(size_t id, float x, float y, float z);
+	dyn_object remove(size_t id);
+	void clear();
+	bool clone_is_copy() const;
+
+	std::vector<entry_ref> query_all() const;
+	std::vector<entry_ref> query_radius(float x, float y, float z, float radius, bool sorted) const;
+	std::vector<entry_ref> query_box(float min_x, float min_y, float min_z, float max_x, float max_y, float max_z) const;
+	std::vector<entry_ref> query_nearest(float x, float y, float z, size_t max_count, float max_distance) const;
+
+	size_t memory_size() const;
+};
+
+// Goes over the results of a query, which are found when it is created
+class spatial_iterator_t : public dyn_iterator, public object_pool<dyn_iterator>::ref_container_virtual
+{
+protected:
+	std::weak_ptr<spatial_t> _source;
+	std::shared_ptr<const std::vector<spatial_t::entry_ref>> _results;
+	size_t _index;
+	bool _before;
+
+	bool at_entry(const spatial_t &source) const;
+
+public:
+	spatial_iterator_t(const std::shared_ptr<spatial_t> source, std::vector<spatial_t::entry_ref> &&results) : _source(source), _results(std::make_shared<std::vector<spatial_t::entry_ref>>(std::move(results))), _index(0), _before(false)
+	{
+
+	}
+
+	spatial_iterator_t(const spatial_iterator_t &iter) = default;
+
+	virtual bool expired() const override;
+	virtual bool valid() const override;
+	virtual bool empty() const override;
+	virtual bool move_next() override;
+	virtual bool move_previous() override;
+	virtual bool set_to_first() override;
+	virtual bool set_to_last() override;
+	virtual bool reset() override;
+	virtual size_t get_hash() const override;
+	virtual bool erase(bool stay) override;
+	virtual std::unique_ptr<dyn_iterator> clone() const override;
+	virtual std::shared_ptr<dyn_iterator> clone_shared() const override;
+	virtual bool operator==(const dyn_iterator &obj) const override;
+
+	virtual bool can_reset() const override;
+	virtual bool can_insert() const override;
+	virtual bool can_erase() const override;
+
+	virtual bool extract_dyn(const std::type_info &type, void *value) const override;
+	virtual bool insert_dyn(const std::type_info &type, void *value) override;
+	virtual bool insert_dyn(const std::type_info &type, const void *value) override;
+
+public:
+	virtual dyn_iterator *get() override
+	{
+		return this;
+	}
+
+	virtual const dyn_iterator *get() const override
+	{
+		return this;
+	}
+};
+
+extern aux::slot_map_pool<spatial_t> spatial_pool;
+
+#endif
@@ -0,0 +1,298 @@
+#include "stats.h"
+
+#include "modules/containers.h"
+#include "modules/spatial.h"
+#include "modules/variants.h"
+#include "modules/strings.h"
+#include "modules/expressions.h"
+#include "modules/tasks.h"
+#include "modules/amxutils.h"
+
+#include <cstring>
+
+template <class Type>
+static size_t elements_size(Type &cont)
+{
+	size_t size = 0;
+	for(const auto &obj : cont)
+	{
+		size += obj.buffer_size();
+	}
+	return size;
+}
+
+struct pool_info
+{
+	const char *name;
+	aux::pool_stats(*get)();
+	void(*reset)();
+};
+
+static const pool_info pools[] = {
+	{
+		"strings",
+		[]()
+		{
+			return strings::pool.get_stats([](const strings::cell_string &str)
+			{
+				return str.capacity() * sizeof(cell);
+			});
+		},
+		[]()
+		{
+			strings::pool.reset_stats();
+		}
+	},
+	{
+		"variants",
+		[]()
+		{
+			return variants::pool.get_stats([](const dyn_object &obj)
+			{
+				return obj.buffer_size();
+			});
+		},
+		[]()
+		{
+			variants::pool.reset_stats();
+		}
+	},
+	{
+		"lists",
+		[]()
+		{
+			return list_pool.get_stats([](const list_t &list)
+			{
+				return list.capacity() * sizeof(dyn_object) + elements_size(list);
+			});
+		},
+		[]()
+		{
+			list_pool.reset_stats();
+		}
+	},
+	{
+		"linked_lists",
+		[]()
+		{
+			return linked_list_pool.get_stats([](const linked_list_t &list)
+			{
+				size_t size = list.memory_size();
+				for(const auto &obj : list)
+				{
+					size += sizeof(dyn_object) + obj->buffer_size();
+				}
+				return size;
+			});
+		},
+		[]()
+		{
+			linked_list_pool.reset_stats();
+		}
+	},
+	{
+		"maps",
+		[]()
+		{
+			return map_pool.get_stats([](const map_t &map)
+			{
+				size_t size = map.memory_size();
+				for(const auto &pair : map)
+				{
+					size += pair.first.buffer_size() + pair.second.buffer_size();
+				}
+				return size;
+			});
+		},
+		[]()
+		{
+			map_pool.reset_stats();
+		}
+	},
+	{
+		"pools",
+		[]()
+		{
+			return pool_pool.get_stats([](const pool_t &pool)
+			{
+				// hybrid_pool cannot be iterated as const
+				return pool.size() * sizeof(dyn_object) + elements_size(const_cast<pool_t&>(pool));
+			});
+		},
+		[]()
+		{
+			pool_pool.reset_stats();
+		}
+	},
+	{
+		"heaps",
+		[]()
+		{
+			return heap_pool.get_stats([](const heap_t &heap)
+			{
+				size_t size = heap.capacity() * sizeof(std::shared_ptr<heap_node>);
+				for(const auto &node : heap)
+				{
+					size += sizeof(heap_node) + node->value.buffer_size();
+				}
+				return size;
+			});
+		},
+		[]()
+		{
+			heap_pool.reset_stats();
+		}
+	},
+	{
+		"deques",
+		[]()
+		{
+			return deque_pool.get_stats([](const deque_t &deque)
+			{
+				size_t size = deque.capacity() * sizeof(dyn_object);
+				for(const auto &obj : deque)
+				{
+					size += obj.buffer_size();
+				}
+				return size;
+			});
+		},
+		[]()
+		{
+			deque_pool.reset_stats();
+		}
+	},
+	{
+		"bitsets",
+		[]()
+		{
+			return bitset_pool.get_stats([](const bitset_t &bitset)
+			{
+				return bitset.memory_size();
+			});
+		},
+		[]()
+		{
+			bitset_pool.reset_stats();
+		}
+	},
+	{
+		"spatials",
+		[]()
+		{
+			return spatial_pool.get_stats([](const spatial_t &spatial)
+			{
+				return spatial.memory_size();
+			});
+		},
+		[]()
+		{
+			spatial_pool.reset_stats();
+		}
+	},
+	{
+		"iterators",
+		[]()
+		{
+			return iter_pool.get_stats([](const dyn_iterator&)
+			{
+				return 0;
+			});
+		},
+		[]()
+		{
+			iter_pool.reset_stats();
+		}
+	},
+	{
+		"handles",
+		[]()
+		{
+			return handle_pool.get_stats([](const handle_t &handle)
+			{
+				return handle.get().buffer_size();
+			});
+		},
+		[]()
+		{
+			handle_pool.reset_stats();
+		}
+	},
+	{
+		"expressions",
+		[]()
+		{
+			return expression_pool.get_stats([](const expression&)
+			{
+				return 0;
+			});
+		},
+		[]()
+		{
+			expression_pool.reset_stats();
+		}
+	},
+	{
+		"tasks",
+		[]()
+		{
+			return tasks::get_stats();
+		},
+		[]()
+		{
+			tasks::reset_stats();
+		}
+	},
+	{
+		"amx_vars",
+		[]()
+		{
+			return amx_var_pool.get_stats([](const amx_var_info&)
+			{
+				return 0;
+			});
+		},
+		[]()
+		{
+			amx_var_pool.reset_stats();
+		}
+	},
+};
+
+size_t stats::count()
+{
+	return sizeof(pools) / sizeof(*pools);
+}
+
+const char *stats::name(size_t index)
+{
+	if(index >= count()) return nullptr;
+	return pools[index].name;
+}
+
+aux::pool_stats stats::get(size_t index)
+{
+	if(index >= count()) return {};
+	return pools[index].get();
+}
+
+bool stats::find(const char *name, size_t &index)
+{
+	for(size_t i = 0; i < count(); i++)
+	{
+		if(!std::strcmp(pools[i].name, name))
+		{
+			index = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+void stats::reset()
+{
+	for(const auto &info : pools)
+	{
+		info.reset();
+	}
+}
@@ -0,0 +1,15 @@
+#ifndef STATS_H_INCLUDED
+#define STATS_H_INCLUDED
+
+#include "utils/slot_map_pool.h"
+
+namespace stats
+{
+	size_t count();
+	const char *name(size_t index);
+	aux::pool_stats get(size_t index);
+	bool find(const char *name, size_t &index);
+	void reset();
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "strings.h"
+#include "utils/cell_hash.h"
 
 #include <stddef.h>
 #include <vector>
@@ -20,12 +21,11 @@ object_pool<cell_string> strings::pool;
 cell strings::null_value1[1] = {0};
 cell strings::null_value2[2] = {0, 1};
 
-cell strings::create(const cell *addr, bool truncate, bool fixnulls)
+static void apply_mode(cell_string &str, bool truncate, bool fixnulls)
 {
-	auto &ptr = pool.emplace(convert(addr));
 	if(truncate || fixnulls)
 	{
-		for(auto &c : *ptr)
+		for(auto &c : str)
 		{
 			if(truncate)
 			{
@@ -37,26 +37,19 @@ cell strings::create(const cell *addr, bool truncate, bool fixnulls)
 			}
 		}
 	}
+}
+
+cell strings::create(const cell *addr, bool truncate, bool fixnulls)
+{
+	auto &ptr = pool.emplace(convert(addr));
+	apply_mode(*ptr, truncate, fixnulls);
 	return pool.get_id(ptr);
 }
 
 cell strings::create(const cell *addr, size_t length, bool packed, bool truncate, bool fixnulls)
 {
 	auto &ptr = pool.emplace(convert(addr, length, packed));
-	if(truncate || fixnulls)
-	{
-		for(auto &c : *ptr)
-		{
-			if(truncate)
-			{
-				c &= 0xFF;
-			}
-			if(fixnulls && c == 0)
-			{
-				c = 0x00FFFF00;
-			}
-		}
-	}
+	apply_mode(*ptr, truncate, fixnulls);
 	return pool.get_id(ptr);
 }
 
@@ -106,6 +99,66 @@ cell strings::create(const std::string &str)
 	return pool.get_id(pool.emplace(convert(str)));
 }
 
+size_t strings::hash(const cell_string &str)
+{
+	return aux::hash_cells(str.data(), str.size());
+}
+
+struct interned_key_hash
+{
+	size_t operator()(const std::pair<const cell_string*, size_t> &key) const
+	{
+		return key.second;
+	}
+};
+
+struct interned_key_equal
+{
+	bool operator()(const std::pair<const cell_string*, size_t> &a, const std::pair<const cell_string*, size_t> &b) const
+	{
+		return a.second == b.second && *a.first == *b.first;
+	}
+};
+
+// Interned strings are looked up by their contents, using the hash computed when they were created
+static std::unordered_map<std::pair<const cell_string*, size_t>, std::shared_ptr<decltype(pool)::ref_container>, interned_key_hash, interned_key_equal> interned_strings;
+
+cell strings::intern(const cell *addr, size_t length, bool packed, bool truncate, bool fixnulls)
+{
+	auto str = convert(addr, length, packed);
+	apply_mode(str, truncate, fixnulls);
+	return intern(std::move(str));
+}
+
+cell strings::intern(cell_string &&str)
+{
+	size_t hash = strings::hash(str);
+	auto it = interned_strings.find(std::make_pair(&str, hash));
+	if(it != interned_strings.end())
+	{
+		cell id = pool.get_id(*it->second);
+		if(id != 0)
+		{
+			return id;
+		}
+		// the string was forcibly deleted from the pool
+		interned_strings.erase(it);
+	}
+	// interned strings live until the end, so they are not allocated in the region
+	auto &obj = pool.add(std::make_shared<decltype(pool)::ref_container>(std::move(str)));
+	auto ptr = pool.get(obj);
+	pool.acquire_ref(obj);
+	obj.set_interned(hash);
+	const cell_string *key = *ptr;
+	interned_strings.emplace(std::make_pair(key, hash), ptr);
+	return pool.get_id(*ptr);
+}
+
+void strings::clear_interned()
+{
+	interned_strings.clear();
+}
+
 bool strings::clamp_range(const cell_string &str, cell &start, cell &end)
 {
 	clamp_pos(str, start);
@@ -296,6 +296,10 @@ namespace strings
 	cell create(const cell *addr, bool truncate, bool fixnulls);
 	cell create(const cell *addr, size_t length, bool packed, bool truncate, bool fixnulls);
 	cell create(const std::string &str);
+	cell intern(const cell *addr, size_t length, bool packed, bool truncate, bool fixnulls);
+	cell intern(cell_string &&str);
+	void clear_interned();
+	size_t hash(const cell_string &str);
 
 	cell_string convert(const cell *str);
 	cell_string convert(const cell *str, size_t length, bool packed);
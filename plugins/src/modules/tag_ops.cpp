@@ -4,6 +4,7 @@
 #include "modules/format.h"
 #include "modules/variants.h"
 #include "modules/containers.h"
+#include "modules/spatial.h"
 #include "modules/tasks.h"
 #include "modules/amxutils.h"
 #include "modules/events.h"
@@ -12,6 +13,7 @@
 #include "objects/stored_param.h"
 #include "fixes/linux.h"
 #include "utils/optional.h"
+#include "utils/cell_hash.h"
 #include <vector>
 #include <algorithm>
 #include <cmath>
@@ -25,12 +27,7 @@ using encoding = strings::encoding;
 template <class Iter>
 using format_info = strings::format_info<Iter>;
 
-template <class T>
-inline void hash_combine(size_t& seed, const T& v)
-{
-	std::hash<T> hasher;
-	seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-}
+using aux::hash_combine;
 
 static std::unordered_map<cell, std::pair<const tag_operations*, bool>> specifier_map;
 
@@ -249,6 +246,16 @@ struct null_operations : public tag_operations
 		return std::hash<cell>()(arg);
 	}
 
+	virtual size_t hash(tag_ptr tag, const cell *arg, cell size) const override
+	{
+		size_t seed = 0;
+		for(cell i = 0; i < size; i++)
+		{
+			hash_combine(seed, hash(tag, arg[i]));
+		}
+		return seed;
+	}
+
 	virtual bool append_string(tag_ptr tag, cell arg, cell_string &str, const encoding &encoding) const override
 	{
 		str.append(strings::convert(tags::find_tag(tag_uid)->format_name()));
@@ -392,6 +399,12 @@ struct cell_operations : public null_operations<Self>
 		return !!std::memcmp(a, b, size * sizeof(cell));
 	}
 
+	// the cells are hashed as one buffer instead of one by one
+	virtual size_t hash(tag_ptr tag, const cell *arg, cell size) const override
+	{
+		return aux::hash_cells(arg, size);
+	}
+
 	virtual bool lt(tag_ptr tag, cell a, cell b) const override
 	{
 		return a < b;
@@ -1005,7 +1018,7 @@ struct string_operations : public null_operations<string_operations>
 	virtual cell add(tag_ptr tag, cell a, cell b) const override
 	{
 		cell_string *str1, *str2;
-		if((!strings::pool.get_by_id(a, str1) && str1 != nullptr) || (!strings::pool.get_by_id(b, str2) && str2 != nullptr))
+		if((!strings::pool.get_by_id(a, str1) && a != 0) || (!strings::pool.get_by_id(b, str2) && b != 0))
 		{
 			return 0;
 		}
@@ -1033,21 +1046,25 @@ struct string_operations : public null_operations<string_operations>
 
 	virtual bool eq(tag_ptr tag, cell a, cell b) const override
 	{
-		cell_string *str1;
-		if(!strings::pool.get_by_id(a, str1) && str1 != nullptr) return false;
-		cell_string *str2;
-		if(!strings::pool.get_by_id(b, str2) && str2 != nullptr) return false;
+		decltype(strings::pool)::ref_container *str1;
+		if(!strings::pool.get_by_id(a, str1) && a != 0) return false;
+		decltype(strings::pool)::ref_container *str2;
+		if(!strings::pool.get_by_id(b, str2) && b != 0) return false;
 
 		if(str1 == nullptr && str2 == nullptr) return true;
 		if(str1 == nullptr)
 		{
-			return str2->size() == 0;
+			return (*str2)->size() == 0;
 		}
 		if(str2 == nullptr)
 		{
-			return str1->size() == 0;
+			return (*str1)->size() == 0;
 		}
-		return *str1 == *str2;
+		if(str1->is_interned() && str2->is_interned())
+		{
+			return str1 == str2;
+		}
+		return **str1 == **str2;
 	}
 
 	virtual bool not(tag_ptr tag, cell a) const override
@@ -1099,15 +1116,14 @@ struct string_operations : public null_operations<string_operations>
 
 	virtual size_t hash(tag_ptr tag, cell arg) const override
 	{
-		cell_string *str;
+		decltype(strings::pool)::ref_container *str;
 		if(strings::pool.get_by_id(arg, str))
 		{
-			size_t seed = 0;
-			for(size_t i = 0; i < str->size(); i++)
+			if(str->is_interned())
 			{
-				hash_combine(seed, (*str)[i]);
+				return str->get_interned_hash();
 			}
-			return seed;
+			return strings::hash(**str);
 		}
 		return null_operations::hash(tag, arg);
 	}
@@ -1120,15 +1136,16 @@ struct string_operations : public null_operations<string_operations>
 			str.append(*ptr);
 			return true;
 		}
-		return ptr == nullptr;
+		return arg == 0;
 	}
 
 	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
 	{
-		std::shared_ptr<cell_string> ptr;
-		if(strings::pool.get_by_id(arg, ptr))
+		// the handle would expire if the object was moved
+		std::shared_ptr<decltype(strings::pool)::ref_container> ptr;
+		if(strings::pool.get_pinned(arg, ptr))
 		{
-			return ptr;
+			return std::shared_ptr<cell_string>(ptr, *ptr);
 		}
 		return {};
 	}
@@ -1141,7 +1158,7 @@ struct string_operations : public null_operations<string_operations>
 			case 'S':
 			{
 				cell_string *str;
-				if(strings::pool.get_by_id(*arg, str) || str == nullptr)
+				if(strings::pool.get_by_id(*arg, str) || *arg == 0)
 				{
 					if(strings::select_iterator<strings::format_specific<Iter>::template append>(str, info.fmt_begin, info.fmt_end, info.target, info.parse_num, info.enc))
 					{
@@ -1154,7 +1171,7 @@ struct string_operations : public null_operations<string_operations>
 			case 'E':
 			{
 				cell_string *str;
-				if(strings::pool.get_by_id(*arg, str) || str == nullptr)
+				if(strings::pool.get_by_id(*arg, str) || *arg == 0)
 				{
 					if(strings::select_iterator<strings::format_specific<Iter>::template add_query>(str, info.fmt_begin, info.fmt_end, info.target, info.parse_num, info.enc))
 					{
@@ -1239,7 +1256,7 @@ struct variant_operations : public null_operations<variant_operations>
 	bool AMX_NATIVE_CALL log_op(tag_ptr tag, cell a, cell b) const
 	{
 		dyn_object *var1, *var2;
-		if((!variants::pool.get_by_id(a, var1) && var1 != nullptr) || (!variants::pool.get_by_id(b, var2) && var2 != nullptr)) return false;
+		if((!variants::pool.get_by_id(a, var1) && a != 0) || (!variants::pool.get_by_id(b, var2) && b != 0)) return false;
 		bool init1 = false, init2 = false;
 		if(var1 == nullptr)
 		{
@@ -1385,10 +1402,11 @@ struct variant_operations : public null_operations<variant_operations>
 
 	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
 	{
-		std::shared_ptr<dyn_object> ptr;
-		if(variants::pool.get_by_id(arg, ptr))
+		// the handle would expire if the object was moved
+		std::shared_ptr<decltype(variants::pool)::ref_container> ptr;
+		if(variants::pool.get_pinned(arg, ptr))
 		{
-			return ptr;
+			return std::shared_ptr<dyn_object>(ptr, *ptr);
 		}
 		return {};
 	}
@@ -1610,7 +1628,7 @@ struct list_operations : public generic_operations<list_operations, tags::tag_li
 		if(list_pool.get_by_id(arg, l))
 		{
 			list_t *l2 = list_pool.add().get();
-			*l2 = *l;
+			l2->share(*l);
 			return list_pool.get_id(l2);
 		}
 		return 0;
@@ -1621,6 +1639,12 @@ struct list_operations : public generic_operations<list_operations, tags::tag_li
 		list_t *l;
 		if(list_pool.get_by_id(arg, l))
 		{
+			if(l->clone_is_copy())
+			{
+				list_t *l2 = list_pool.add().get();
+				l2->share(*l);
+				return list_pool.get_id(l2);
+			}
 			list_t tmp;
 			std::swap(*l, tmp);
 			list_t *l2 = list_pool.add().get();
@@ -1803,7 +1827,7 @@ struct map_operations : public generic_operations<map_operations, tags::tag_map>
 		if(map_pool.get_by_id(arg, m))
 		{
 			map_t *m2 = map_pool.add().get();
-			*m2 = *m;
+			m2->share(*m);
 			return map_pool.get_id(m2);
 		}
 		return 0;
@@ -1814,6 +1838,12 @@ struct map_operations : public generic_operations<map_operations, tags::tag_map>
 		map_t *m;
 		if(map_pool.get_by_id(arg, m))
 		{
+			if(m->clone_is_copy())
+			{
+				map_t *m2 = map_pool.add().get();
+				m2->share(*m);
+				return map_pool.get_id(m2);
+			}
 			map_t tmp;
 			std::swap(*m, tmp);
 			map_t *m2 = map_pool.add().get();
@@ -2246,6 +2276,373 @@ struct pool_operations : public generic_operations<pool_operations, tags::tag_po
 	}
 };
 
+struct heap_operations : public generic_operations<heap_operations, tags::tag_heap>
+{
+	heap_operations() : generic_operations<heap_operations, tags::tag_heap>()
+	{
+
+	}
+
+	heap_operations(tag_ptr element) : generic_operations(element)
+	{
+
+	}
+
+	virtual bool eq(tag_ptr tag, cell a, cell b) const override
+	{
+		return a == b;
+	}
+
+	virtual bool not(tag_ptr tag, cell a) const override
+	{
+		heap_t *h;
+		return !heap_pool.get_by_id(a, h);
+	}
+
+	virtual char format_spec(tag_ptr tag, bool arr) const override
+	{
+		return arr ? 'a' : 'l';
+	}
+
+	virtual bool del(tag_ptr tag, cell arg) const override
+	{
+		heap_t *h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			return heap_pool.remove(h);
+		}
+		return false;
+	}
+
+	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<heap_t> h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			return h;
+		}
+		return {};
+	}
+
+	virtual bool release(tag_ptr tag, cell arg) const override
+	{
+		heap_t *h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			heap_t old;
+			std::swap(*h, old);
+			heap_pool.remove(h);
+			for(auto &node : old)
+			{
+				node->value.release();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	virtual cell copy(tag_ptr tag, cell arg) const override
+	{
+		heap_t *h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			heap_t *h2 = heap_pool.add().get();
+			*h2 = *h;
+			return heap_pool.get_id(h2);
+		}
+		return 0;
+	}
+
+	virtual cell clone(tag_ptr tag, cell arg) const override
+	{
+		heap_t *h;
+		if(heap_pool.get_by_id(arg, h))
+		{
+			heap_t tmp;
+			std::swap(*h, tmp);
+			heap_t *h2 = heap_pool.add().get();
+			*h2 = heap_t(tmp.get_comparator());
+			h2->reserve(tmp.size());
+			for(auto &node : tmp)
+			{
+				h2->push(node->value.clone());
+			}
+			std::swap(*h, tmp);
+			return heap_pool.get_id(h2);
+		}
+		return 0;
+	}
+};
+
+struct deque_operations : public generic_operations<deque_operations, tags::tag_deque>
+{
+	deque_operations() : generic_operations()
+	{
+
+	}
+
+	deque_operations(tag_ptr element) : generic_operations(element)
+	{
+
+	}
+
+	virtual bool eq(tag_ptr tag, cell a, cell b) const override
+	{
+		return a == b;
+	}
+
+	virtual bool not(tag_ptr tag, cell a) const override
+	{
+		deque_t *d;
+		return !deque_pool.get_by_id(a, d);
+	}
+
+	virtual char format_spec(tag_ptr tag, bool arr) const override
+	{
+		return arr ? 'a' : 'l';
+	}
+
+	virtual bool del(tag_ptr tag, cell arg) const override
+	{
+		deque_t *d;
+		if(deque_pool.get_by_id(arg, d))
+		{
+			return deque_pool.remove(d);
+		}
+		return false;
+	}
+
+	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<deque_t> d;
+		if(deque_pool.get_by_id(arg, d))
+		{
+			return d;
+		}
+		return {};
+	}
+
+	virtual bool release(tag_ptr tag, cell arg) const override
+	{
+		deque_t *d;
+		if(deque_pool.get_by_id(arg, d))
+		{
+			deque_t old;
+			std::swap(*d, old);
+			deque_pool.remove(d);
+			for(auto &obj : old)
+			{
+				obj.release();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	virtual cell copy(tag_ptr tag, cell arg) const override
+	{
+		deque_t *d;
+		if(deque_pool.get_by_id(arg, d))
+		{
+			deque_t *d2 = deque_pool.add().get();
+			d2->share(*d);
+			return deque_pool.get_id(d2);
+		}
+		return 0;
+	}
+
+	virtual cell clone(tag_ptr tag, cell arg) const override
+	{
+		deque_t *d;
+		if(deque_pool.get_by_id(arg, d))
+		{
+			if(d->clone_is_copy())
+			{
+				deque_t *d2 = deque_pool.add().get();
+				d2->share(*d);
+				return deque_pool.get_id(d2);
+			}
+			deque_t tmp;
+			std::swap(*d, tmp);
+			deque_t *d2 = deque_pool.add().get();
+			d2->reserve(tmp.size());
+			for(auto &obj : tmp)
+			{
+				d2->push_back(obj.clone());
+			}
+			std::swap(*d, tmp);
+			return deque_pool.get_id(d2);
+		}
+		return 0;
+	}
+};
+
+struct bitset_operations : public generic_operations<bitset_operations, tags::tag_bitset>
+{
+	bitset_operations() : generic_operations()
+	{
+
+	}
+
+	bitset_operations(tag_ptr element) : generic_operations(element)
+	{
+
+	}
+
+	virtual bool eq(tag_ptr tag, cell a, cell b) const override
+	{
+		return a == b;
+	}
+
+	virtual bool not(tag_ptr tag, cell a) const override
+	{
+		bitset_t *b;
+		return !bitset_pool.get_by_id(a, b);
+	}
+
+	virtual char format_spec(tag_ptr tag, bool arr) const override
+	{
+		return arr ? 'a' : 'l';
+	}
+
+	virtual bool del(tag_ptr tag, cell arg) const override
+	{
+		bitset_t *b;
+		if(bitset_pool.get_by_id(arg, b))
+		{
+			return bitset_pool.remove(b);
+		}
+		return false;
+	}
+
+	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<bitset_t> b;
+		if(bitset_pool.get_by_id(arg, b))
+		{
+			return b;
+		}
+		return {};
+	}
+
+	// The elements are plain cells, so there is nothing else to release
+	virtual bool release(tag_ptr tag, cell arg) const override
+	{
+		return del(tag, arg);
+	}
+
+	virtual cell copy(tag_ptr tag, cell arg) const override
+	{
+		bitset_t *b;
+		if(bitset_pool.get_by_id(arg, b))
+		{
+			bitset_t *b2 = bitset_pool.add().get();
+			b2->share(*b);
+			return bitset_pool.get_id(b2);
+		}
+		return 0;
+	}
+
+	virtual cell clone(tag_ptr tag, cell arg) const override
+	{
+		return copy(tag, arg);
+	}
+};
+
+struct spatial_operations : public generic_operations<spatial_operations, tags::tag_spatial>
+{
+	spatial_operations() : generic_operations()
+	{
+
+	}
+
+	spatial_operations(tag_ptr element) : generic_operations(element)
+	{
+
+	}
+
+	virtual bool eq(tag_ptr tag, cell a, cell b) const override
+	{
+		return a == b;
+	}
+
+	virtual bool not(tag_ptr tag, cell a) const override
+	{
+		spatial_t *s;
+		return !spatial_pool.get_by_id(a, s);
+	}
+
+	virtual char format_spec(tag_ptr tag, bool arr) const override
+	{
+		return arr ? 'a' : 'l';
+	}
+
+	virtual bool del(tag_ptr tag, cell arg) const override
+	{
+		spatial_t *s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			return spatial_pool.remove(s);
+		}
+		return false;
+	}
+
+	virtual std::weak_ptr<const void> handle(tag_ptr tag, cell arg) const override
+	{
+		std::shared_ptr<spatial_t> s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			return s;
+		}
+		return {};
+	}
+
+	virtual bool release(tag_ptr tag, cell arg) const override
+	{
+		spatial_t *s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			spatial_t old(s->get_cell_size());
+			std::swap(*s, old);
+			spatial_pool.remove(s);
+			old.for_each([](dyn_object &obj)
+			{
+				obj.release();
+			});
+			return true;
+		}
+		return false;
+	}
+
+	virtual cell copy(tag_ptr tag, cell arg) const override
+	{
+		spatial_t *s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			return spatial_pool.get_id(spatial_pool.emplace(*s));
+		}
+		return 0;
+	}
+
+	virtual cell clone(tag_ptr tag, cell arg) const override
+	{
+		spatial_t *s;
+		if(spatial_pool.get_by_id(arg, s))
+		{
+			auto &s2 = spatial_pool.emplace(*s);
+			if(!s->clone_is_copy())
+			{
+				s2->for_each([](dyn_object &obj)
+				{
+					obj = obj.clone();
+				});
+			}
+			return spatial_pool.get_id(s2);
+		}
+		return 0;
+	}
+};
+
 struct expression_operations : public null_operations<expression_operations>
 {
 	expression_operations() : null_operations<expression_operations>(tags::tag_expression)
@@ -2349,6 +2746,10 @@ std::vector<std::unique_ptr<tag_info>> tag_list([]()
 	v.push_back(std::move(string_const));
 	v.push_back(std::move(variant_const));
 	v.push_back(std::make_unique<tag_info>(27, "char@", v[3].get(), std::make_unique<char_operations>()));
+	v.push_back(std::make_unique<tag_info>(28, "Heap", unknown_tag, std::make_unique<heap_operations>()));
+	v.push_back(std::make_unique<tag_info>(29, "Deque", unknown_tag, std::make_unique<deque_operations>()));
+	v.push_back(std::make_unique<tag_info>(30, "Bitset", unknown_tag, std::make_unique<bitset_operations>()));
+	v.push_back(std::make_unique<tag_info>(31, "Spatial", unknown_tag, std::make_unique<spatial_operations>()));
 
 	unknown_ops.register_specifier('v');
 
@@ -2754,6 +3155,21 @@ public:
 		return op_un(tag, op_type::hash, arg);
 	}
 
+	virtual size_t hash(tag_ptr tag, const cell *arg, cell size) const override
+	{
+		auto it = dyn_ops.find(op_type::hash);
+		if(it != dyn_ops.end() && it->second)
+		{
+			return null_operations::hash(tag, arg, size);
+		}
+		tag_ptr base = tags::find_tag(tag_uid)->base;
+		if(base != nullptr)
+		{
+			return base->get_ops().hash(tag, arg, size);
+		}
+		return null_operations::hash(tag, arg, size);
+	}
+
 	virtual bool set_op(op_type type, AMX *amx, const char *handler, const char *add_format, const cell *args, int numargs) override
 	{
 		if(_locked) return false;
@@ -2816,7 +3232,7 @@ public:
 				str.append(*ptr);
 				return true;
 			}
-			return ptr == nullptr;
+			return result == 0;
 		}
 		tag_ptr base = tags::find_tag(tag_uid)->base;
 		if(base == nullptr) base = tags::find_tag(tags::tag_unknown);
@@ -2855,7 +3271,7 @@ public:
 				info.target.append(*ptr);
 				return true;
 			}
-			return ptr == nullptr;
+			return result == 0;
 		}
 		tag_ptr base = tags::find_tag(ops.get_tag_uid())->base;
 		if(base == nullptr) base = tags::find_tag(tags::tag_unknown);
@@ -2940,7 +3356,7 @@ cell tag_operations::call_op(tag_ptr tag, op_type type, cell *args, size_t numar
 			if(numargs >= 3)
 			{
 				cell_string *format;
-				if(strings::pool.get_by_id(args[2], format) || format == nullptr)
+				if(strings::pool.get_by_id(args[2], format) || args[2] == 0)
 				{
 					auto &ref = strings::pool.add();
 					bool result;
@@ -61,6 +61,7 @@ public:
 	virtual bool assign(tag_ptr tag, cell *arg, cell size) const = 0;
 	virtual bool init(tag_ptr tag, cell *arg, cell size) const = 0;
 	virtual size_t hash(tag_ptr tag, cell arg) const = 0;
+	virtual size_t hash(tag_ptr tag, const cell *arg, cell size) const = 0;
 
 protected:
 	using it1_t = const cell*;
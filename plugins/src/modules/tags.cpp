@@ -3,16 +3,30 @@
 #include "main.h"
 #include "amxinfo.h"
 #include "fixes/linux.h"
-#include <unordered_map>
 #include <vector>
 #include <cstdint>
 #include <memory>
 
 extern std::vector<std::unique_ptr<tag_info>> tag_list;
 
+struct tag_map_info;
+
+static AMX *last_amx = nullptr;
+static amx::instance *last_instance = nullptr;
+static tag_map_info *last_map = nullptr;
+
 struct tag_map_info : public amx::extra
 {
-	std::unordered_map<cell, tag_ptr> tag_map;
+	struct entry
+	{
+		cell tag_id;
+		tag_ptr tag;
+	};
+
+	// indexed by the tag id in the script without the flags
+	std::vector<entry> tag_map;
+	// indexed by the uid of the tag, 0 if the tag is not used by the script
+	std::vector<cell> id_map;
 
 	tag_map_info(AMX *amx) : amx::extra(amx)
 	{
@@ -26,12 +40,66 @@ struct tag_map_info : public amx::extra
 			if(!amx_GetTag(amx, i, tagname, &tag_id))
 			{
 				auto info = tags::find_tag(tagname, -1);
-				tag_map[tag_id & 0x7FFFFFFF] = info;
+				tag_id &= 0x7FFFFFFF;
+				size_t index = tag_id & 0x3FFFFFFF;
+				if(index >= tag_map.size())
+				{
+					tag_map.resize(index + 1, entry{0, nullptr});
+				}
+				tag_map[index] = entry{tag_id, info};
+				if(static_cast<size_t>(info->uid) >= id_map.size())
+				{
+					id_map.resize(info->uid + 1, 0);
+				}
+				id_map[info->uid] = tag_id | 0x80000000;
 			}
 		}
 	}
+
+	tag_ptr find(cell tag_id) const
+	{
+		size_t index = tag_id & 0x3FFFFFFF;
+		if(index < tag_map.size() && tag_map[index].tag && tag_map[index].tag_id == tag_id)
+		{
+			return tag_map[index].tag;
+		}
+		return nullptr;
+	}
+
+	cell get_id(tag_ptr tag) const
+	{
+		if(static_cast<size_t>(tag->uid) < id_map.size())
+		{
+			return id_map[tag->uid];
+		}
+		return 0;
+	}
+
+	virtual ~tag_map_info() override
+	{
+		if(last_map == this)
+		{
+			last_amx = nullptr;
+			last_instance = nullptr;
+			last_map = nullptr;
+		}
+	}
 };
 
+// Consecutive calls usually come from the same script.
+// The map is forgotten when the instance is invalidated or destroyed, since the AMX may be reused.
+static tag_map_info &get_tag_map(AMX *amx)
+{
+	if(amx != last_amx || last_instance == nullptr || !last_instance->valid())
+	{
+		const auto &obj = amx::load_lock(amx);
+		last_map = &obj->get_extra<tag_map_info>();
+		last_instance = obj.get();
+		last_amx = amx;
+	}
+	return *last_map;
+}
+
 tag_ptr tags::find_tag(const char *name, size_t sublen)
 {
 	std::string tag_name = sublen == -1 ? std::string(name) : std::string(name, sublen);
@@ -88,12 +156,9 @@ tag_ptr tags::find_tag(AMX *amx, cell tag_id)
 	tag_id &= 0x7FFFFFFF;
 	if(tag_id == 0) return ::tag_list[tag_cell].get();
 
-	auto obj = amx::load_lock(amx);
-	auto &map = obj->get_extra<tag_map_info>().tag_map;
-	auto it = map.find(tag_id);
-	if(it != map.end())
+	if(auto tag = get_tag_map(amx).find(tag_id))
 	{
-		return it->second;
+		return tag;
 	}
 	char *tagname = amx_NameBuffer(amx);
 	if(amx_FindTagId(amx, tag_id, tagname) == AMX_ERR_NONE)
@@ -190,12 +255,8 @@ bool tag_info::same_base(tag_ptr tag) const
 cell tag_info::get_id(AMX *amx) const
 {
 	if(uid == tags::tag_cell) return 0x80000000;
-	const auto &obj = amx::load_lock(amx);
-	auto &map = obj->get_extra<tag_map_info>().tag_map;
-	for(auto &pair : map)
-	{
-		if(pair.second == this) return pair.first | 0x80000000;
-	}
+	cell id = get_tag_map(amx).get_id(this);
+	if(id != 0) return id;
 	return uid;
 }
 
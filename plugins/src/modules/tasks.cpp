@@ -1,7 +1,7 @@
 #include "tasks.h"
 #include "exec.h"
 
-#include "utils/shared_id_set_pool.h"
+#include "utils/slot_map_pool.h"
 #include "sdk/amx/amx.h"
 #include <utility>
 #include <chrono>
@@ -73,7 +73,7 @@ namespace tasks
 		}
 	};
 
-	aux::shared_id_set_pool<task> pool;
+	aux::slot_map_pool<task> pool;
 
 	ucell tick_count = 0;
 	std::list<std::pair<ucell, std::unique_ptr<handler>>> tick_handlers;
@@ -383,6 +383,23 @@ namespace tasks
 		return pool.size();
 	}
 
+	aux::pool_stats get_stats()
+	{
+		auto stats = pool.get_stats([](const task&)
+		{
+			return 0;
+		});
+		// handlers waiting for a tick or a timer
+		stats.bytes += tick_handlers.size() * (sizeof(decltype(tick_handlers)::value_type) + 2 * sizeof(void*));
+		stats.bytes += timer_handlers.size() * (sizeof(decltype(timer_handlers)::value_type) + 2 * sizeof(void*));
+		return stats;
+	}
+
+	void reset_stats()
+	{
+		pool.reset_stats();
+	}
+
 	void tick()
 	{
 		tick_count++;
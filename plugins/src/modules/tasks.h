@@ -3,6 +3,7 @@
 
 #include "objects/reset.h"
 #include "objects/dyn_object.h"
+#include "utils/slot_map_pool.h"
 #include "sdk/amx/amx.h"
 #include <list>
 #include <memory>
@@ -45,7 +46,7 @@ namespace tasks
 		}
 	};
 
-	class task
+	class task : public aux::slot_map_hook
 	{
 		union{
 			cell _error = 0;
@@ -230,6 +231,8 @@ namespace tasks
 
 	void tick();
 	size_t size();
+	aux::pool_stats get_stats();
+	void reset_stats();
 
 	extra &get_extra(AMX *amx, amx::object &owner);
 }
@@ -168,6 +168,10 @@ int RegisterMathNatives(AMX *amx);
 int RegisterDebugNatives(AMX *amx);
 int RegisterPoolNatives(AMX *amx);
 int RegisterExprNatives(AMX *amx);
+int RegisterHeapNatives(AMX *amx);
+int RegisterDequeNatives(AMX *amx);
+int RegisterBitsetNatives(AMX *amx);
+int RegisterSpatialNatives(AMX *amx);
 
 inline int RegisterNatives(AMX *amx)
 {
@@ -188,6 +192,10 @@ inline int RegisterNatives(AMX *amx)
 	RegisterDebugNatives(amx);
 	RegisterPoolNatives(amx);
 	RegisterExprNatives(amx);
+	RegisterHeapNatives(amx);
+	RegisterDequeNatives(amx);
+	RegisterBitsetNatives(amx);
+	RegisterSpatialNatives(amx);
 	return AMX_ERR_NONE;
 }
 
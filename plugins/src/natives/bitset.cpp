@@ -0,0 +1,229 @@
+#include "natives.h"
+#include "errors.h"
+#include "modules/containers.h"
+
+template <aux::roaring_bitmap::set_op Op>
+static cell AMX_NATIVE_CALL bitset_combine(AMX *amx, cell *params)
+{
+	const bitset_t *ptr1;
+	if(!bitset_pool.get_by_id(params[1], ptr1)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+	const bitset_t *ptr2;
+	if(!bitset_pool.get_by_id(params[2], ptr2)) amx_LogicError(errors::pointer_invalid, "bitset", params[2]);
+	return bitset_pool.get_id(bitset_pool.emplace(bitset_t::combine(*ptr1, *ptr2, Op)));
+}
+
+namespace Natives
+{
+	// native Bitset:bitset_new();
+	AMX_DEFINE_NATIVE_TAG(bitset_new, 0, bitset)
+	{
+		return bitset_pool.get_id(bitset_pool.add());
+	}
+
+	// native Bitset:bitset_new_arr(const values[], size=sizeof(values));
+	AMX_DEFINE_NATIVE_TAG(bitset_new_arr, 2, bitset)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "size");
+		const cell *arr = amx_GetAddrSafe(amx, params[1]);
+		auto ptr = bitset_pool.add();
+		for(cell i = 0; i < params[2]; i++)
+		{
+			ptr->add(arr[i]);
+		}
+		return bitset_pool.get_id(ptr);
+	}
+
+	// native bool:bitset_valid(Bitset:bitset);
+	AMX_DEFINE_NATIVE_TAG(bitset_valid, 1, bool)
+	{
+		bitset_t *ptr;
+		return bitset_pool.get_by_id(params[1], ptr);
+	}
+
+	// native bitset_delete(Bitset:bitset);
+	AMX_DEFINE_NATIVE_TAG(bitset_delete, 1, cell)
+	{
+		bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		return bitset_pool.remove(ptr);
+	}
+
+	// native Bitset:bitset_clone(Bitset:bitset);
+	AMX_DEFINE_NATIVE_TAG(bitset_clone, 1, bitset)
+	{
+		bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		auto b = bitset_pool.add();
+		b->share(*ptr);
+		return bitset_pool.get_id(b);
+	}
+
+	// native bitset_size(Bitset:bitset);
+	AMX_DEFINE_NATIVE_TAG(bitset_size, 1, cell)
+	{
+		const bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		return static_cast<cell>(ptr->size());
+	}
+
+	// native bitset_clear(Bitset:bitset);
+	AMX_DEFINE_NATIVE_TAG(bitset_clear, 1, cell)
+	{
+		bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		bitset_t().swap(*ptr);
+		return 1;
+	}
+
+	// native bool:bitset_add(Bitset:bitset, value);
+	AMX_DEFINE_NATIVE_TAG(bitset_add, 2, bool)
+	{
+		bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		return ptr->add(params[2]);
+	}
+
+	// native bitset_add_arr(Bitset:bitset, const values[], size=sizeof(values));
+	AMX_DEFINE_NATIVE_TAG(bitset_add_arr, 3, cell)
+	{
+		if(params[3] < 0) amx_LogicError(errors::out_of_range, "size");
+		bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		const cell *arr = amx_GetAddrSafe(amx, params[2]);
+		cell count = 0;
+		for(cell i = 0; i < params[3]; i++)
+		{
+			if(ptr->add(arr[i]))
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+
+	// native bitset_add_range(Bitset:bitset, begin, end);
+	// The values are unsigned. Every 65536 values of a dense range take 8 KiB, up to 512 MiB for the whole range.
+	AMX_DEFINE_NATIVE_TAG(bitset_add_range, 3, cell)
+	{
+		bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		if(static_cast<ucell>(params[2]) >= static_cast<ucell>(params[3]))
+		{
+			return 0;
+		}
+		return static_cast<cell>(ptr->add_range(params[2], params[3]));
+	}
+
+	// native bool:bitset_remove(Bitset:bitset, value);
+	AMX_DEFINE_NATIVE_TAG(bitset_remove, 2, bool)
+	{
+		bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		return ptr->remove(params[2]);
+	}
+
+	// native bitset_remove_arr(Bitset:bitset, const values[], size=sizeof(values));
+	AMX_DEFINE_NATIVE_TAG(bitset_remove_arr, 3, cell)
+	{
+		if(params[3] < 0) amx_LogicError(errors::out_of_range, "size");
+		bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		const cell *arr = amx_GetAddrSafe(amx, params[2]);
+		cell count = 0;
+		for(cell i = 0; i < params[3]; i++)
+		{
+			if(ptr->remove(arr[i]))
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+
+	// native bool:bitset_contains(Bitset:bitset, value);
+	AMX_DEFINE_NATIVE_TAG(bitset_contains, 2, bool)
+	{
+		const bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		return ptr->contains(params[2]);
+	}
+
+	// native bitset_to_arr(Bitset:bitset, values[], size=sizeof(values), start=0);
+	AMX_DEFINE_NATIVE_TAG(bitset_to_arr, 3, cell)
+	{
+		if(params[3] < 0) amx_LogicError(errors::out_of_range, "size");
+		const bitset_t *ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		cell *arr = amx_GetAddrSafe(amx, params[2]);
+		cell count = 0;
+		for(auto it = ptr->lower_bound(optparam(4, 0)); it != ptr->cend() && count < params[3]; ++it)
+		{
+			arr[count++] = static_cast<cell>(*it);
+		}
+		return count;
+	}
+
+	// native Bitset:bitset_union(Bitset:bitset1, Bitset:bitset2);
+	AMX_DEFINE_NATIVE_TAG(bitset_union, 2, bitset)
+	{
+		return bitset_combine<aux::roaring_bitmap::set_op::unite>(amx, params);
+	}
+
+	// native Bitset:bitset_intersect(Bitset:bitset1, Bitset:bitset2);
+	AMX_DEFINE_NATIVE_TAG(bitset_intersect, 2, bitset)
+	{
+		return bitset_combine<aux::roaring_bitmap::set_op::intersect>(amx, params);
+	}
+
+	// native Bitset:bitset_difference(Bitset:bitset1, Bitset:bitset2);
+	AMX_DEFINE_NATIVE_TAG(bitset_difference, 2, bitset)
+	{
+		return bitset_combine<aux::roaring_bitmap::set_op::subtract>(amx, params);
+	}
+
+	// native Bitset:bitset_symmetric_difference(Bitset:bitset1, Bitset:bitset2);
+	AMX_DEFINE_NATIVE_TAG(bitset_symmetric_difference, 2, bitset)
+	{
+		return bitset_combine<aux::roaring_bitmap::set_op::exclude>(amx, params);
+	}
+
+	// native bitset_intersect_size(Bitset:bitset1, Bitset:bitset2);
+	AMX_DEFINE_NATIVE_TAG(bitset_intersect_size, 2, cell)
+	{
+		const bitset_t *ptr1;
+		if(!bitset_pool.get_by_id(params[1], ptr1)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+		const bitset_t *ptr2;
+		if(!bitset_pool.get_by_id(params[2], ptr2)) amx_LogicError(errors::pointer_invalid, "bitset", params[2]);
+		return static_cast<cell>(bitset_t::intersect_count(*ptr1, *ptr2));
+	}
+}
+
+static AMX_NATIVE_INFO native_list[] =
+{
+	AMX_DECLARE_NATIVE(bitset_new),
+	AMX_DECLARE_NATIVE(bitset_new_arr),
+	AMX_DECLARE_NATIVE(bitset_valid),
+	AMX_DECLARE_NATIVE(bitset_delete),
+	AMX_DECLARE_NATIVE(bitset_clone),
+	AMX_DECLARE_NATIVE(bitset_size),
+	AMX_DECLARE_NATIVE(bitset_clear),
+
+	AMX_DECLARE_NATIVE(bitset_add),
+	AMX_DECLARE_NATIVE(bitset_add_arr),
+	AMX_DECLARE_NATIVE(bitset_add_range),
+	AMX_DECLARE_NATIVE(bitset_remove),
+	AMX_DECLARE_NATIVE(bitset_remove_arr),
+	AMX_DECLARE_NATIVE(bitset_contains),
+	AMX_DECLARE_NATIVE(bitset_to_arr),
+
+	AMX_DECLARE_NATIVE(bitset_union),
+	AMX_DECLARE_NATIVE(bitset_intersect),
+	AMX_DECLARE_NATIVE(bitset_difference),
+	AMX_DECLARE_NATIVE(bitset_symmetric_difference),
+	AMX_DECLARE_NATIVE(bitset_intersect_size),
+};
+
+int RegisterBitsetNatives(AMX *amx)
+{
+	return amx_Register(amx, native_list, sizeof(native_list) / sizeof(*native_list));
+}
@@ -0,0 +1,451 @@
+#include "natives.h"
+#include "errors.h"
+#include "modules/containers.h"
+#include "modules/variants.h"
+
+template <size_t... Indices>
+class value_at
+{
+	using value_ftype = typename dyn_factory<Indices...>::type;
+	using result_ftype = typename dyn_result<Indices...>::type;
+
+public:
+	// native deque_push_back(Deque:deque, value, ...);
+	template <value_ftype Factory>
+	static cell AMX_NATIVE_CALL deque_push_back(AMX *amx, cell *params)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		ptr->push_back(Factory(amx, params[Indices]...));
+		return static_cast<cell>(ptr->size() - 1);
+	}
+
+	// native deque_push_front(Deque:deque, value, ...);
+	template <value_ftype Factory>
+	static cell AMX_NATIVE_CALL deque_push_front(AMX *amx, cell *params)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		ptr->push_front(Factory(amx, params[Indices]...));
+		return 0;
+	}
+
+	// native deque_pop_back(Deque:deque, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL deque_pop_back(AMX *amx, cell *params)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		// the element is kept in the deque if it cannot be stored
+		cell result = Factory(amx, ptr->back(), params[Indices]...);
+		ptr->pop_back();
+		return result;
+	}
+
+	// native deque_pop_front(Deque:deque, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL deque_pop_front(AMX *amx, cell *params)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		// the element is kept in the deque if it cannot be stored
+		cell result = Factory(amx, ptr->front(), params[Indices]...);
+		ptr->pop_front();
+		return result;
+	}
+
+	// native deque_get(Deque:deque, index, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL deque_get(AMX *amx, cell *params)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		const deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		return Factory(amx, (*ptr)[params[2]], params[Indices]...);
+	}
+
+	// native deque_set(Deque:deque, index, value, ...);
+	template <value_ftype Factory>
+	static cell AMX_NATIVE_CALL deque_set(AMX *amx, cell *params)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		(*ptr)[params[2]] = Factory(amx, params[Indices]...);
+		return 1;
+	}
+};
+
+namespace Natives
+{
+	// native Deque:deque_new();
+	AMX_DEFINE_NATIVE_TAG(deque_new, 0, deque)
+	{
+		return deque_pool.get_id(deque_pool.add());
+	}
+
+	// native bool:deque_valid(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_valid, 1, bool)
+	{
+		deque_t *ptr;
+		return deque_pool.get_by_id(params[1], ptr);
+	}
+
+	// native deque_delete(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_delete, 1, cell)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		return deque_pool.remove(ptr);
+	}
+
+	// native deque_delete_deep(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_delete_deep, 1, cell)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		deque_t old;
+		ptr->swap(old);
+		deque_pool.remove(ptr);
+		for(auto &obj : old)
+		{
+			obj.release();
+		}
+		return 1;
+	}
+
+	// native Deque:deque_clone(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_clone, 1, deque)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		auto d = deque_pool.add();
+		if(ptr->clone_is_copy())
+		{
+			d->share(*ptr);
+		}else{
+			const deque_t &source = *ptr;
+			d->reserve(source.size());
+			for(auto &&obj : source)
+			{
+				d->push_back(obj.clone());
+			}
+		}
+		return deque_pool.get_id(d);
+	}
+
+	// native deque_size(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_size, 1, cell)
+	{
+		const deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		return static_cast<cell>(ptr->size());
+	}
+
+	// native deque_capacity(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_capacity, 1, cell)
+	{
+		const deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		return static_cast<cell>(ptr->capacity());
+	}
+
+	// native deque_reserve(Deque:deque, capacity);
+	AMX_DEFINE_NATIVE_TAG(deque_reserve, 2, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "capacity");
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		ucell size = params[2];
+		ptr->reserve(size);
+		return 1;
+	}
+
+	// native deque_clear(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_clear, 1, cell)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		deque_t().swap(*ptr);
+		return 1;
+	}
+
+	// native deque_clear_deep(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_clear_deep, 1, cell)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		deque_t old;
+		ptr->swap(old);
+		for(auto &obj : old)
+		{
+			obj.release();
+		}
+		return 1;
+	}
+
+	// native deque_push_back(Deque:deque, AnyTag:value, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(deque_push_back, 3, cell)
+	{
+		return value_at<2, 3>::deque_push_back<dyn_func>(amx, params);
+	}
+
+	// native deque_push_back_arr(Deque:deque, const AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(deque_push_back_arr, 4, cell)
+	{
+		return value_at<2, 3, 4>::deque_push_back<dyn_func_arr>(amx, params);
+	}
+
+	// native deque_push_back_str(Deque:deque, const value[]);
+	AMX_DEFINE_NATIVE_TAG(deque_push_back_str, 2, cell)
+	{
+		return value_at<2>::deque_push_back<dyn_func_str>(amx, params);
+	}
+
+	// native deque_push_back_str_s(Deque:deque, ConstStringTag:value);
+	AMX_DEFINE_NATIVE_TAG(deque_push_back_str_s, 2, cell)
+	{
+		return value_at<2>::deque_push_back<dyn_func_str_s>(amx, params);
+	}
+
+	// native deque_push_back_var(Deque:deque, ConstVariantTag:value);
+	AMX_DEFINE_NATIVE_TAG(deque_push_back_var, 2, cell)
+	{
+		return value_at<2>::deque_push_back<dyn_func_var>(amx, params);
+	}
+
+	// native deque_push_front(Deque:deque, AnyTag:value, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(deque_push_front, 3, cell)
+	{
+		return value_at<2, 3>::deque_push_front<dyn_func>(amx, params);
+	}
+
+	// native deque_push_front_arr(Deque:deque, const AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(deque_push_front_arr, 4, cell)
+	{
+		return value_at<2, 3, 4>::deque_push_front<dyn_func_arr>(amx, params);
+	}
+
+	// native deque_push_front_str(Deque:deque, const value[]);
+	AMX_DEFINE_NATIVE_TAG(deque_push_front_str, 2, cell)
+	{
+		return value_at<2>::deque_push_front<dyn_func_str>(amx, params);
+	}
+
+	// native deque_push_front_str_s(Deque:deque, ConstStringTag:value);
+	AMX_DEFINE_NATIVE_TAG(deque_push_front_str_s, 2, cell)
+	{
+		return value_at<2>::deque_push_front<dyn_func_str_s>(amx, params);
+	}
+
+	// native deque_push_front_var(Deque:deque, ConstVariantTag:value);
+	AMX_DEFINE_NATIVE_TAG(deque_push_front_var, 2, cell)
+	{
+		return value_at<2>::deque_push_front<dyn_func_var>(amx, params);
+	}
+
+	// native deque_pop_back(Deque:deque, offset=0);
+	AMX_DEFINE_NATIVE(deque_pop_back, 2)
+	{
+		return value_at<2>::deque_pop_back<dyn_func>(amx, params);
+	}
+
+	// native deque_pop_back_arr(Deque:deque, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(deque_pop_back_arr, 3, cell)
+	{
+		return value_at<2, 3>::deque_pop_back<dyn_func_arr>(amx, params);
+	}
+
+	// native String:deque_pop_back_str_s(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_pop_back_str_s, 1, string)
+	{
+		return value_at<>::deque_pop_back<dyn_func_str_s>(amx, params);
+	}
+
+	// native Variant:deque_pop_back_var(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_pop_back_var, 1, variant)
+	{
+		return value_at<>::deque_pop_back<dyn_func_var>(amx, params);
+	}
+
+	// native deque_pop_back_deep(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_pop_back_deep, 1, cell)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		ptr->pop_back().release();
+		return 1;
+	}
+
+	// native deque_pop_front(Deque:deque, offset=0);
+	AMX_DEFINE_NATIVE(deque_pop_front, 2)
+	{
+		return value_at<2>::deque_pop_front<dyn_func>(amx, params);
+	}
+
+	// native deque_pop_front_arr(Deque:deque, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(deque_pop_front_arr, 3, cell)
+	{
+		return value_at<2, 3>::deque_pop_front<dyn_func_arr>(amx, params);
+	}
+
+	// native String:deque_pop_front_str_s(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_pop_front_str_s, 1, string)
+	{
+		return value_at<>::deque_pop_front<dyn_func_str_s>(amx, params);
+	}
+
+	// native Variant:deque_pop_front_var(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_pop_front_var, 1, variant)
+	{
+		return value_at<>::deque_pop_front<dyn_func_var>(amx, params);
+	}
+
+	// native deque_pop_front_deep(Deque:deque);
+	AMX_DEFINE_NATIVE_TAG(deque_pop_front_deep, 1, cell)
+	{
+		deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		ptr->pop_front().release();
+		return 1;
+	}
+
+	// native deque_get(Deque:deque, index, offset=0);
+	AMX_DEFINE_NATIVE(deque_get, 3)
+	{
+		return value_at<3>::deque_get<dyn_func>(amx, params);
+	}
+
+	// native deque_get_arr(Deque:deque, index, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(deque_get_arr, 4, cell)
+	{
+		return value_at<3, 4>::deque_get<dyn_func_arr>(amx, params);
+	}
+
+	// native String:deque_get_str_s(Deque:deque, index);
+	AMX_DEFINE_NATIVE_TAG(deque_get_str_s, 2, string)
+	{
+		return value_at<>::deque_get<dyn_func_str_s>(amx, params);
+	}
+
+	// native Variant:deque_get_var(Deque:deque, index);
+	AMX_DEFINE_NATIVE_TAG(deque_get_var, 2, variant)
+	{
+		return value_at<>::deque_get<dyn_func_var>(amx, params);
+	}
+
+	// native deque_set(Deque:deque, index, AnyTag:value, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(deque_set, 4, cell)
+	{
+		return value_at<3, 4>::deque_set<dyn_func>(amx, params);
+	}
+
+	// native deque_set_arr(Deque:deque, index, const AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(deque_set_arr, 5, cell)
+	{
+		return value_at<3, 4, 5>::deque_set<dyn_func_arr>(amx, params);
+	}
+
+	// native deque_set_str(Deque:deque, index, const value[]);
+	AMX_DEFINE_NATIVE_TAG(deque_set_str, 3, cell)
+	{
+		return value_at<3>::deque_set<dyn_func_str>(amx, params);
+	}
+
+	// native deque_set_str_s(Deque:deque, index, ConstStringTag:value);
+	AMX_DEFINE_NATIVE_TAG(deque_set_str_s, 3, cell)
+	{
+		return value_at<3>::deque_set<dyn_func_str_s>(amx, params);
+	}
+
+	// native deque_set_var(Deque:deque, index, ConstVariantTag:value);
+	AMX_DEFINE_NATIVE_TAG(deque_set_var, 3, cell)
+	{
+		return value_at<3>::deque_set<dyn_func_var>(amx, params);
+	}
+
+	// native deque_tagof(Deque:deque, index);
+	AMX_DEFINE_NATIVE_TAG(deque_tagof, 2, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		const deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		auto &obj = (*ptr)[params[2]];
+		return obj.get_tag(amx);
+	}
+
+	// native deque_sizeof(Deque:deque, index);
+	AMX_DEFINE_NATIVE_TAG(deque_sizeof, 2, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		const deque_t *ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		auto &obj = (*ptr)[params[2]];
+		return obj.get_size();
+	}
+}
+
+static AMX_NATIVE_INFO native_list[] =
+{
+	AMX_DECLARE_NATIVE(deque_new),
+	AMX_DECLARE_NATIVE(deque_valid),
+	AMX_DECLARE_NATIVE(deque_delete),
+	AMX_DECLARE_NATIVE(deque_delete_deep),
+	AMX_DECLARE_NATIVE(deque_clone),
+	AMX_DECLARE_NATIVE(deque_size),
+	AMX_DECLARE_NATIVE(deque_capacity),
+	AMX_DECLARE_NATIVE(deque_reserve),
+	AMX_DECLARE_NATIVE(deque_clear),
+	AMX_DECLARE_NATIVE(deque_clear_deep),
+
+	AMX_DECLARE_NATIVE(deque_push_back),
+	AMX_DECLARE_NATIVE(deque_push_back_arr),
+	AMX_DECLARE_NATIVE(deque_push_back_str),
+	AMX_DECLARE_NATIVE(deque_push_back_str_s),
+	AMX_DECLARE_NATIVE(deque_push_back_var),
+
+	AMX_DECLARE_NATIVE(deque_push_front),
+	AMX_DECLARE_NATIVE(deque_push_front_arr),
+	AMX_DECLARE_NATIVE(deque_push_front_str),
+	AMX_DECLARE_NATIVE(deque_push_front_str_s),
+	AMX_DECLARE_NATIVE(deque_push_front_var),
+
+	AMX_DECLARE_NATIVE(deque_pop_back),
+	AMX_DECLARE_NATIVE(deque_pop_back_arr),
+	AMX_DECLARE_NATIVE(deque_pop_back_str_s),
+	AMX_DECLARE_NATIVE(deque_pop_back_var),
+	AMX_DECLARE_NATIVE(deque_pop_back_deep),
+
+	AMX_DECLARE_NATIVE(deque_pop_front),
+	AMX_DECLARE_NATIVE(deque_pop_front_arr),
+	AMX_DECLARE_NATIVE(deque_pop_front_str_s),
+	AMX_DECLARE_NATIVE(deque_pop_front_var),
+	AMX_DECLARE_NATIVE(deque_pop_front_deep),
+
+	AMX_DECLARE_NATIVE(deque_get),
+	AMX_DECLARE_NATIVE(deque_get_arr),
+	AMX_DECLARE_NATIVE(deque_get_str_s),
+	AMX_DECLARE_NATIVE(deque_get_var),
+
+	AMX_DECLARE_NATIVE(deque_set),
+	AMX_DECLARE_NATIVE(deque_set_arr),
+	AMX_DECLARE_NATIVE(deque_set_str),
+	AMX_DECLARE_NATIVE(deque_set_str_s),
+	AMX_DECLARE_NATIVE(deque_set_var),
+
+	AMX_DECLARE_NATIVE(deque_tagof),
+	AMX_DECLARE_NATIVE(deque_sizeof),
+};
+
+int RegisterDequeNatives(AMX *amx)
+{
+	return amx_Register(amx, native_list, sizeof(native_list) / sizeof(*native_list));
+}
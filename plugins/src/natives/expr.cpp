@@ -122,7 +122,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(expr_parse_s, 1, expression)
 	{
 		strings::cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		return strings::select_iterator<parse_base>(str, amx, optparam(2, -1));
 	}
 
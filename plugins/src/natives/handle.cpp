@@ -23,7 +23,7 @@ public:
 	static cell AMX_NATIVE_CALL handle_alias(AMX *amx, cell *params)
 	{
 		handle_t *handle;
-		if(!handle_pool.get_by_id(params[1], handle) && handle != nullptr) amx_LogicError(errors::pointer_invalid, "handle", params[1]);
+		if(!handle_pool.get_by_id(params[1], handle) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "handle", params[1]);
 		if(handle == nullptr)
 		{
 			return handle_pool.get_id(handle_pool.emplace(Factory(amx, params[Indices]...), true));
@@ -149,7 +149,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(handle_tagof, 1, cell)
 	{
 		handle_t *handle;
-		if(!handle_pool.get_by_id(params[1], handle) && handle != nullptr) amx_LogicError(errors::pointer_invalid, "handle", params[1]);
+		if(!handle_pool.get_by_id(params[1], handle) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "handle", params[1]);
 		if(handle == nullptr)
 		{
 			return 0x80000000;
@@ -161,7 +161,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(handle_sizeof, 1, cell)
 	{
 		handle_t *handle;
-		if(!handle_pool.get_by_id(params[1], handle) && handle != nullptr) amx_LogicError(errors::pointer_invalid, "handle", params[1]);
+		if(!handle_pool.get_by_id(params[1], handle) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "handle", params[1]);
 		if(handle == nullptr)
 		{
 			return 0;
@@ -200,9 +200,9 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(handle_eq, 2, bool)
 	{
 		handle_t *handle1;
-		if(!handle_pool.get_by_id(params[1], handle1) && handle1 != nullptr) amx_LogicError(errors::pointer_invalid, "handle", params[1]);
+		if(!handle_pool.get_by_id(params[1], handle1) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "handle", params[1]);
 		handle_t *handle2;
-		if(!handle_pool.get_by_id(params[2], handle2) && handle2 != nullptr) amx_LogicError(errors::pointer_invalid, "handle", params[2]);
+		if(!handle_pool.get_by_id(params[2], handle2) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "handle", params[2]);
 		if(handle1 != nullptr && handle2 != nullptr)
 		{
 			return *handle1 == *handle2;
@@ -0,0 +1,355 @@
+#include "natives.h"
+#include "errors.h"
+#include "modules/containers.h"
+#include "modules/variants.h"
+#include "modules/expressions.h"
+
+template <size_t... Indices>
+class value_at
+{
+	using value_ftype = typename dyn_factory<Indices...>::type;
+	using result_ftype = typename dyn_result<Indices...>::type;
+
+public:
+	// native heap_push(Heap:heap, value, ...);
+	template <value_ftype Factory>
+	static cell AMX_NATIVE_CALL heap_push(AMX *amx, cell *params)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		ptr->push(Factory(amx, params[Indices]...));
+		return 1;
+	}
+
+	// native heap_peek(Heap:heap, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL heap_peek(AMX *amx, cell *params)
+	{
+		const heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		return Factory(amx, ptr->top(), params[Indices]...);
+	}
+
+	// native heap_pop(Heap:heap, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL heap_pop(AMX *amx, cell *params)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		// the element is kept in the heap if it cannot be stored
+		cell result = Factory(amx, ptr->top(), params[Indices]...);
+		ptr->pop();
+		return result;
+	}
+
+	// native heap_update(IterTag:iter, value, ...);
+	template <value_ftype Factory>
+	static cell AMX_NATIVE_CALL heap_update(AMX *amx, cell *params)
+	{
+		dyn_iterator *iter;
+		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		auto heap_iter = dynamic_cast<heap_iterator_t*>(iter);
+		if(heap_iter == nullptr || !heap_iter->update(Factory(amx, params[Indices]...))) amx_LogicError(errors::operation_not_supported, "iterator", params[1]);
+		return 1;
+	}
+};
+
+namespace Natives
+{
+	// native Heap:heap_new();
+	AMX_DEFINE_NATIVE_TAG(heap_new, 0, heap)
+	{
+		return heap_pool.get_id(heap_pool.add());
+	}
+
+	// native Heap:heap_new_expr(Expression:comparator);
+	AMX_DEFINE_NATIVE_TAG(heap_new_expr, 1, heap)
+	{
+		expression_ptr expr;
+		if(!expression_pool.get_by_id(params[1], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[1]);
+		return heap_pool.get_id(heap_pool.emplace(std::move(expr)));
+	}
+
+	// native bool:heap_valid(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_valid, 1, bool)
+	{
+		heap_t *ptr;
+		return heap_pool.get_by_id(params[1], ptr);
+	}
+
+	// native heap_delete(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_delete, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return heap_pool.remove(ptr);
+	}
+
+	// native heap_delete_deep(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_delete_deep, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		heap_t old;
+		ptr->swap(old);
+		heap_pool.remove(ptr);
+		for(auto &node : old)
+		{
+			node->value.release();
+		}
+		return 1;
+	}
+
+	// native Heap:heap_clone(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_clone, 1, heap)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->clone_is_copy())
+		{
+			return heap_pool.get_id(heap_pool.emplace(*ptr));
+		}
+		auto h = heap_pool.emplace(ptr->get_comparator());
+		h->reserve(ptr->size());
+		const heap_t &source = *ptr;
+		for(auto &&node : source)
+		{
+			h->push(node->value.clone());
+		}
+		return heap_pool.get_id(h);
+	}
+
+	// native heap_size(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_size, 1, cell)
+	{
+		const heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return static_cast<cell>(ptr->size());
+	}
+
+	// native heap_capacity(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_capacity, 1, cell)
+	{
+		const heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		return static_cast<cell>(ptr->capacity());
+	}
+
+	// native heap_reserve(Heap:heap, capacity);
+	AMX_DEFINE_NATIVE_TAG(heap_reserve, 2, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "capacity");
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		ucell size = params[2];
+		ptr->reserve(size);
+		return 1;
+	}
+
+	// native heap_clear(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_clear, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		heap_t(ptr->get_comparator()).swap(*ptr);
+		return 1;
+	}
+
+	// native heap_clear_deep(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_clear_deep, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		heap_t old(ptr->get_comparator());
+		ptr->swap(old);
+		for(auto &node : old)
+		{
+			node->value.release();
+		}
+		return 1;
+	}
+
+	// native heap_push(Heap:heap, AnyTag:value, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_push, 3, cell)
+	{
+		return value_at<2, 3>::heap_push<dyn_func>(amx, params);
+	}
+
+	// native heap_push_arr(Heap:heap, const AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_push_arr, 4, cell)
+	{
+		return value_at<2, 3, 4>::heap_push<dyn_func_arr>(amx, params);
+	}
+
+	// native heap_push_str(Heap:heap, const value[]);
+	AMX_DEFINE_NATIVE_TAG(heap_push_str, 2, cell)
+	{
+		return value_at<2>::heap_push<dyn_func_str>(amx, params);
+	}
+
+	// native heap_push_str_s(Heap:heap, ConstStringTag:value);
+	AMX_DEFINE_NATIVE_TAG(heap_push_str_s, 2, cell)
+	{
+		return value_at<2>::heap_push<dyn_func_str_s>(amx, params);
+	}
+
+	// native heap_push_var(Heap:heap, VariantTag:value);
+	AMX_DEFINE_NATIVE_TAG(heap_push_var, 2, cell)
+	{
+		return value_at<2>::heap_push<dyn_func_var>(amx, params);
+	}
+
+	// native heap_peek(Heap:heap, offset=0);
+	AMX_DEFINE_NATIVE(heap_peek, 2)
+	{
+		return value_at<2>::heap_peek<dyn_func>(amx, params);
+	}
+
+	// native heap_peek_arr(Heap:heap, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_peek_arr, 3, cell)
+	{
+		return value_at<2, 3>::heap_peek<dyn_func_arr>(amx, params);
+	}
+
+	// native String:heap_peek_str_s(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_peek_str_s, 1, string)
+	{
+		return value_at<>::heap_peek<dyn_func_str_s>(amx, params);
+	}
+
+	// native Variant:heap_peek_var(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_peek_var, 1, variant)
+	{
+		return value_at<>::heap_peek<dyn_func_var>(amx, params);
+	}
+
+	// native heap_pop(Heap:heap, offset=0);
+	AMX_DEFINE_NATIVE(heap_pop, 2)
+	{
+		return value_at<2>::heap_pop<dyn_func>(amx, params);
+	}
+
+	// native heap_pop_arr(Heap:heap, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_pop_arr, 3, cell)
+	{
+		return value_at<2, 3>::heap_pop<dyn_func_arr>(amx, params);
+	}
+
+	// native String:heap_pop_str_s(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_pop_str_s, 1, string)
+	{
+		return value_at<>::heap_pop<dyn_func_str_s>(amx, params);
+	}
+
+	// native Variant:heap_pop_var(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_pop_var, 1, variant)
+	{
+		return value_at<>::heap_pop<dyn_func_var>(amx, params);
+	}
+
+	// native heap_pop_deep(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_pop_deep, 1, cell)
+	{
+		heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		ptr->pop().release();
+		return 1;
+	}
+
+	// native heap_update(IterTag:iter, AnyTag:value, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_update, 3, cell)
+	{
+		return value_at<2, 3>::heap_update<dyn_func>(amx, params);
+	}
+
+	// native heap_update_arr(IterTag:iter, const AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(heap_update_arr, 4, cell)
+	{
+		return value_at<2, 3, 4>::heap_update<dyn_func_arr>(amx, params);
+	}
+
+	// native heap_update_str(IterTag:iter, const value[]);
+	AMX_DEFINE_NATIVE_TAG(heap_update_str, 2, cell)
+	{
+		return value_at<2>::heap_update<dyn_func_str>(amx, params);
+	}
+
+	// native heap_update_str_s(IterTag:iter, ConstStringTag:value);
+	AMX_DEFINE_NATIVE_TAG(heap_update_str_s, 2, cell)
+	{
+		return value_at<2>::heap_update<dyn_func_str_s>(amx, params);
+	}
+
+	// native heap_update_var(IterTag:iter, VariantTag:value);
+	AMX_DEFINE_NATIVE_TAG(heap_update_var, 2, cell)
+	{
+		return value_at<2>::heap_update<dyn_func_var>(amx, params);
+	}
+
+	// native heap_tagof(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_tagof, 1, cell)
+	{
+		const heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		return ptr->top().get_tag(amx);
+	}
+
+	// native heap_sizeof(Heap:heap);
+	AMX_DEFINE_NATIVE_TAG(heap_sizeof, 1, cell)
+	{
+		const heap_t *ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+		if(ptr->size() == 0) amx_LogicError(errors::element_not_present);
+		return ptr->top().get_size();
+	}
+}
+
+static AMX_NATIVE_INFO native_list[] =
+{
+	AMX_DECLARE_NATIVE(heap_new),
+	AMX_DECLARE_NATIVE(heap_new_expr),
+	AMX_DECLARE_NATIVE(heap_valid),
+	AMX_DECLARE_NATIVE(heap_delete),
+	AMX_DECLARE_NATIVE(heap_delete_deep),
+	AMX_DECLARE_NATIVE(heap_clone),
+	AMX_DECLARE_NATIVE(heap_size),
+	AMX_DECLARE_NATIVE(heap_capacity),
+	AMX_DECLARE_NATIVE(heap_reserve),
+	AMX_DECLARE_NATIVE(heap_clear),
+	AMX_DECLARE_NATIVE(heap_clear_deep),
+
+	AMX_DECLARE_NATIVE(heap_push),
+	AMX_DECLARE_NATIVE(heap_push_arr),
+	AMX_DECLARE_NATIVE(heap_push_str),
+	AMX_DECLARE_NATIVE(heap_push_str_s),
+	AMX_DECLARE_NATIVE(heap_push_var),
+
+	AMX_DECLARE_NATIVE(heap_peek),
+	AMX_DECLARE_NATIVE(heap_peek_arr),
+	AMX_DECLARE_NATIVE(heap_peek_str_s),
+	AMX_DECLARE_NATIVE(heap_peek_var),
+
+	AMX_DECLARE_NATIVE(heap_pop),
+	AMX_DECLARE_NATIVE(heap_pop_arr),
+	AMX_DECLARE_NATIVE(heap_pop_str_s),
+	AMX_DECLARE_NATIVE(heap_pop_var),
+	AMX_DECLARE_NATIVE(heap_pop_deep),
+
+	AMX_DECLARE_NATIVE(heap_update),
+	AMX_DECLARE_NATIVE(heap_update_arr),
+	AMX_DECLARE_NATIVE(heap_update_str),
+	AMX_DECLARE_NATIVE(heap_update_str_s),
+	AMX_DECLARE_NATIVE(heap_update_var),
+
+	AMX_DECLARE_NATIVE(heap_tagof),
+	AMX_DECLARE_NATIVE(heap_sizeof),
+};
+
+int RegisterHeapNatives(AMX *amx)
+{
+	return amx_Register(amx, native_list, sizeof(native_list) / sizeof(*native_list));
+}
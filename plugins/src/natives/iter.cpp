@@ -1,6 +1,7 @@
 #include "natives.h"
 #include "errors.h"
 #include "modules/containers.h"
+#include "modules/spatial.h"
 #include "modules/variants.h"
 #include "modules/strings.h"
 #include "modules/expressions.h"
@@ -9,6 +10,7 @@
 #include "fixes/linux.h"
 
 #include <cstring>
+#include <algorithm>
 
 template <class Func>
 auto value_write(cell arg, Func f) -> typename std::result_of<Func(dyn_object&)>::type
@@ -161,6 +163,56 @@ public:
 		auto &iter = iter_pool.add(std::make_unique<map_iterator_t>(ptr, ptr->find(KeyFactory(amx, params[KeyIndices]...))));
 		return iter_pool.get_id(iter);
 	}
+
+	// native Iter:map_iter_lower_bound(Map:map, key, ...);
+	template <key_ftype KeyFactory>
+	static cell AMX_NATIVE_CALL map_iter_lower_bound(AMX *amx, cell *params)
+	{
+		std::shared_ptr<map_t> ptr;
+		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+		if(!ptr->ordered()) amx_LogicError(errors::operation_not_supported, "map", params[1]);
+
+		auto &iter = iter_pool.add(std::make_unique<map_iterator_t>(ptr, ptr->shared_lower_bound(KeyFactory(amx, params[KeyIndices]...))));
+		return iter_pool.get_id(iter);
+	}
+
+	// native Iter:map_iter_upper_bound(Map:map, key, ...);
+	template <key_ftype KeyFactory>
+	static cell AMX_NATIVE_CALL map_iter_upper_bound(AMX *amx, cell *params)
+	{
+		std::shared_ptr<map_t> ptr;
+		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+		if(!ptr->ordered()) amx_LogicError(errors::operation_not_supported, "map", params[1]);
+
+		auto &iter = iter_pool.add(std::make_unique<map_iterator_t>(ptr, ptr->shared_upper_bound(KeyFactory(amx, params[KeyIndices]...))));
+		return iter_pool.get_id(iter);
+	}
+};
+
+template <size_t... LowerIndices>
+class range_at
+{
+	using key_ftype = typename dyn_factory<LowerIndices...>::type;
+
+public:
+	template <size_t... UpperIndices>
+	class to
+	{
+		static_assert(sizeof...(LowerIndices) == sizeof...(UpperIndices), "the bounds must be of the same kind");
+
+	public:
+		// native Iter:map_iter_range(Map:map, lower, upper, ...);
+		template <key_ftype KeyFactory>
+		static cell AMX_NATIVE_CALL map_iter_range(AMX *amx, cell *params)
+		{
+			std::shared_ptr<map_t> ptr;
+			if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+			if(!ptr->ordered()) amx_LogicError(errors::operation_not_supported, "map", params[1]);
+
+			auto &iter = iter_pool.add(std::make_unique<map_range_iterator_t>(ptr, KeyFactory(amx, params[LowerIndices]...), KeyFactory(amx, params[UpperIndices]...)));
+			return iter_pool.get_id(iter);
+		}
+	};
 };
 
 // native bool:iter_set_cell(IterTag:iter, offset, AnyTag:value, ...);
@@ -219,6 +271,80 @@ static cell AMX_NATIVE_CALL iter_set_cells_md(AMX *amx, cell *params)
 	});
 }
 
+// Adds an operation to an iterator, extending it instead if it is a pipeline that can be extended.
+// Either way, the new iterator moves a clone of the source, so the original iterator stays where it is.
+static cell add_stage(cell iter_id, pipeline_iterator::stage &&next)
+{
+	dyn_iterator *iter;
+	if(!iter_pool.get_by_id(iter_id, iter)) amx_LogicError(errors::pointer_invalid, "iterator", iter_id);
+	auto pipeline = dynamic_cast<pipeline_iterator*>(iter);
+	if(pipeline != nullptr && pipeline->extendable())
+	{
+		return iter_pool.get_id(iter_pool.emplace_derived<pipeline_iterator>(*pipeline, std::move(next)));
+	}
+	return iter_pool.get_id(iter_pool.emplace_derived<pipeline_iterator>(iter->clone_shared(), std::move(next)));
+}
+
+// Calls the function with the value of every element from the current one to the end
+template <class Func>
+static void for_each_value(dyn_iterator *iter, Func f)
+{
+	while(iter->valid())
+	{
+		value_read(iter, f);
+		if(!iter->move_next())
+		{
+			break;
+		}
+	}
+}
+
+// Calls the function with the value and the key (if any) of every element from the current one to the end
+template <class Func>
+static void for_each_element(dyn_iterator *iter, Func f)
+{
+	while(iter->valid())
+	{
+		const std::pair<const dyn_object, dyn_object> *cpair;
+		std::shared_ptr<const std::pair<const dyn_object, dyn_object>> spair;
+		if(iter->extract(cpair))
+		{
+			f(cpair->second, &cpair->first);
+		}else if(iter->extract(spair))
+		{
+			f(spair->second, &spair->first);
+		}else{
+			value_read(iter, [&](const dyn_object &value)
+			{
+				f(value, static_cast<const dyn_object*>(nullptr));
+			});
+		}
+		if(!iter->move_next())
+		{
+			break;
+		}
+	}
+}
+
+template <class Compare>
+static cell iter_extreme(AMX *amx, cell *params)
+{
+	dyn_iterator *iter;
+	if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+	dyn_object result;
+	bool first = true;
+	Compare compare;
+	for_each_value(iter, [&](const dyn_object &value)
+	{
+		if(first || compare(value, result))
+		{
+			result = value;
+			first = false;
+		}
+	});
+	return variants::create(std::move(result));
+}
+
 namespace Natives
 {
 	// native Iter:list_iter(List:list, index=0);
@@ -332,26 +458,110 @@ namespace Natives
 		return key_at<2>::map_iter_at<dyn_func_var>(amx, params);
 	}
 
+	// native Iter:map_iter_lower_bound(Map:map, AnyTag:key, TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(map_iter_lower_bound, 3, iter)
+	{
+		return key_at<2, 3>::map_iter_lower_bound<dyn_func>(amx, params);
+	}
+
+	// native Iter:map_iter_lower_bound_arr(Map:map, const AnyTag:key[], key_size=sizeof(key), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(map_iter_lower_bound_arr, 4, iter)
+	{
+		return key_at<2, 3, 4>::map_iter_lower_bound<dyn_func_arr>(amx, params);
+	}
+
+	// native Iter:map_iter_lower_bound_str(Map:map, const key[]);
+	AMX_DEFINE_NATIVE_TAG(map_iter_lower_bound_str, 2, iter)
+	{
+		return key_at<2>::map_iter_lower_bound<dyn_func_str>(amx, params);
+	}
+
+	// native Iter:map_iter_lower_bound_str_s(Map:map, ConstStringTag:key);
+	AMX_DEFINE_NATIVE_TAG(map_iter_lower_bound_str_s, 2, iter)
+	{
+		return key_at<2>::map_iter_lower_bound<dyn_func_str_s>(amx, params);
+	}
+
+	// native Iter:map_iter_lower_bound_var(Map:map, ConstVariantTag:key);
+	AMX_DEFINE_NATIVE_TAG(map_iter_lower_bound_var, 2, iter)
+	{
+		return key_at<2>::map_iter_lower_bound<dyn_func_var>(amx, params);
+	}
+
+	// native Iter:map_iter_upper_bound(Map:map, AnyTag:key, TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(map_iter_upper_bound, 3, iter)
+	{
+		return key_at<2, 3>::map_iter_upper_bound<dyn_func>(amx, params);
+	}
+
+	// native Iter:map_iter_upper_bound_arr(Map:map, const AnyTag:key[], key_size=sizeof(key), TagTag:key_tag_id=tagof(key));
+	AMX_DEFINE_NATIVE_TAG(map_iter_upper_bound_arr, 4, iter)
+	{
+		return key_at<2, 3, 4>::map_iter_upper_bound<dyn_func_arr>(amx, params);
+	}
+
+	// native Iter:map_iter_upper_bound_str(Map:map, const key[]);
+	AMX_DEFINE_NATIVE_TAG(map_iter_upper_bound_str, 2, iter)
+	{
+		return key_at<2>::map_iter_upper_bound<dyn_func_str>(amx, params);
+	}
+
+	// native Iter:map_iter_upper_bound_str_s(Map:map, ConstStringTag:key);
+	AMX_DEFINE_NATIVE_TAG(map_iter_upper_bound_str_s, 2, iter)
+	{
+		return key_at<2>::map_iter_upper_bound<dyn_func_str_s>(amx, params);
+	}
+
+	// native Iter:map_iter_upper_bound_var(Map:map, ConstVariantTag:key);
+	AMX_DEFINE_NATIVE_TAG(map_iter_upper_bound_var, 2, iter)
+	{
+		return key_at<2>::map_iter_upper_bound<dyn_func_var>(amx, params);
+	}
+
+	// native Iter:map_iter_range(Map:map, AnyTag:lower, AnyTag:upper, TagTag:key_tag_id=tagof(lower));
+	AMX_DEFINE_NATIVE_TAG(map_iter_range, 4, iter)
+	{
+		return range_at<2, 4>::to<3, 4>::map_iter_range<dyn_func>(amx, params);
+	}
+
+	// native Iter:map_iter_range_arr(Map:map, const AnyTag:lower[], const AnyTag:upper[], lower_size=sizeof(lower), upper_size=sizeof(upper), TagTag:key_tag_id=tagof(lower));
+	AMX_DEFINE_NATIVE_TAG(map_iter_range_arr, 6, iter)
+	{
+		return range_at<2, 4, 6>::to<3, 5, 6>::map_iter_range<dyn_func_arr>(amx, params);
+	}
+
+	// native Iter:map_iter_range_str(Map:map, const lower[], const upper[]);
+	AMX_DEFINE_NATIVE_TAG(map_iter_range_str, 3, iter)
+	{
+		return range_at<2>::to<3>::map_iter_range<dyn_func_str>(amx, params);
+	}
+
+	// native Iter:map_iter_range_str_s(Map:map, ConstStringTag:lower, ConstStringTag:upper);
+	AMX_DEFINE_NATIVE_TAG(map_iter_range_str_s, 3, iter)
+	{
+		return range_at<2>::to<3>::map_iter_range<dyn_func_str_s>(amx, params);
+	}
+
+	// native Iter:map_iter_range_var(Map:map, ConstVariantTag:lower, ConstVariantTag:upper);
+	AMX_DEFINE_NATIVE_TAG(map_iter_range_var, 3, iter)
+	{
+		return range_at<2>::to<3>::map_iter_range<dyn_func_var>(amx, params);
+	}
+
 	// native Iter:linked_list_iter(LinkedList:linked_list, index=0);
 	AMX_DEFINE_NATIVE_TAG(linked_list_iter, 1, iter)
 	{
 		std::shared_ptr<linked_list_t> ptr;
 		if(!linked_list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "linked list", params[1]);
 		
-		auto &iter = iter_pool.emplace_derived<linked_list_iterator_t>(ptr);
 		cell index = optparam(2, 0);
 		if(index < 0)
 		{
+			auto &iter = iter_pool.emplace_derived<linked_list_iterator_t>(ptr);
 			iter->reset();
-		}else{
-			for(cell i = 0; i < index; i++)
-			{
-				if(!iter->move_next())
-				{
-					break;
-				}
-			}
+			return iter_pool.get_id(iter);
 		}
+		auto &iter = iter_pool.emplace_derived<linked_list_iterator_t>(ptr, ptr->iter_at(index));
 		return iter_pool.get_id(iter);
 	}
 
@@ -373,8 +583,7 @@ namespace Natives
 			amx_LogicError(errors::out_of_range, "linked list index");
 		}else if(index != ptr->size())
 		{
-			pos = ptr->begin();
-			std::advance(pos, index);
+			pos = ptr->iter_at(index);
 		}
 		while(iter->valid())
 		{
@@ -452,6 +661,52 @@ namespace Natives
 		return iter_pool.get_id(iter);
 	}
 
+	// native Iter:heap_iter(Heap:heap, index=0);
+	AMX_DEFINE_NATIVE_TAG(heap_iter, 1, iter)
+	{
+		std::shared_ptr<heap_t> ptr;
+		if(!heap_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "heap", params[1]);
+
+		cell index = optparam(2, 0);
+		auto &iter = iter_pool.emplace_derived<heap_iterator_t>(ptr, index < 0 ? ptr->size() : static_cast<ucell>(index));
+		return iter_pool.get_id(iter);
+	}
+
+	// native Iter:deque_iter(Deque:deque, index=0);
+	AMX_DEFINE_NATIVE_TAG(deque_iter, 1, iter)
+	{
+		std::shared_ptr<deque_t> ptr;
+		if(!deque_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "deque", params[1]);
+
+		cell index = optparam(2, 0);
+		if(index < 0 || static_cast<ucell>(index) > ptr->size())
+		{
+			index = ptr->size();
+		}
+		auto &iter = iter_pool.emplace_derived<deque_iterator_t>(ptr, ptr->shared_begin() + index);
+		return iter_pool.get_id(iter);
+	}
+
+	// native Iter:bitset_iter(Bitset:bitset, value=0);
+	AMX_DEFINE_NATIVE_TAG(bitset_iter, 1, iter)
+	{
+		std::shared_ptr<bitset_t> ptr;
+		if(!bitset_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "bitset", params[1]);
+
+		auto &iter = iter_pool.emplace_derived<bitset_iterator_t>(ptr, optparam(2, 0));
+		return iter_pool.get_id(iter);
+	}
+
+	// native Iter:spatial_iter(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_iter, 1, iter)
+	{
+		std::shared_ptr<spatial_t> ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+
+		auto &iter = iter_pool.emplace_derived<spatial_iterator_t>(ptr, ptr->query_all());
+		return iter_pool.get_id(iter);
+	}
+
 	// native bool:iter_valid(IterTag:iter);
 	AMX_DEFINE_NATIVE_TAG(iter_valid, 1, bool)
 	{
@@ -488,7 +743,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_linked, 1, bool)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		if(iter == nullptr)
 		{
 			return false;
@@ -500,7 +755,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_inside, 1, bool)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		if(iter == nullptr)
 		{
 			return false;
@@ -512,7 +767,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_empty, 1, bool)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		if(iter == nullptr)
 		{
 			return true;
@@ -524,7 +779,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_type, 1, cell)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		if(iter == nullptr)
 		{
 			return 0;
@@ -536,7 +791,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_type_str, 3, cell)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		cell *addr = amx_GetAddrSafe(amx, params[2]);
 		if(iter == nullptr)
 		{
@@ -551,7 +806,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_type_str_s, 1, string)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		if(iter == nullptr)
 		{
 			return strings::pool.get_id(strings::pool.add());
@@ -585,7 +840,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_reset, 1, iter)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		if(iter)
 		{
 			if(!iter->reset()) amx_LogicError(errors::operation_not_supported, "iterator", params[1]);
@@ -597,7 +852,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_can_reset, 1, bool)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		if(iter)
 		{
 			return iter->can_insert();
@@ -609,7 +864,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_can_insert, 1, bool)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		if(iter)
 		{
 			return iter->can_insert();
@@ -621,7 +876,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_can_erase, 1, bool)
 	{
 		dyn_iterator *iter;
-		if(!iter_pool.get_by_id(params[1], iter) && iter != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		if(iter)
 		{
 			return iter->can_erase();
@@ -655,9 +910,9 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(iter_eq, 2, bool)
 	{
 		dyn_iterator *iter1;
-		if(!iter_pool.get_by_id(params[1], iter1) && iter1 != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		if(!iter_pool.get_by_id(params[1], iter1) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		dyn_iterator *iter2;
-		if(!iter_pool.get_by_id(params[2], iter2) && iter2 != nullptr) amx_LogicError(errors::pointer_invalid, "iterator", params[2]);
+		if(!iter_pool.get_by_id(params[2], iter2) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "iterator", params[2]);
 		if(iter1 == nullptr)
 		{
 			return iter2 == nullptr;
@@ -731,21 +986,154 @@ namespace Natives
 	// native Iter:iter_filter(IterTag:iter, Expression:expr);
 	AMX_DEFINE_NATIVE_TAG(iter_filter, 2, iter)
 	{
-		std::shared_ptr<dyn_iterator> iter;
-		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		expression_ptr expr;
 		if(!expression_pool.get_by_id(params[2], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[2]);
-		return iter_pool.get_id(iter_pool.emplace_derived<filter_iterator>(std::move(iter), std::move(expr)));
+		return add_stage(params[1], pipeline_iterator::stage(pipeline_iterator::operation::filter, std::move(expr)));
 	}
 
 	// native Iter:iter_project(IterTag:iter, Expression:expr);
 	AMX_DEFINE_NATIVE_TAG(iter_project, 2, iter)
 	{
-		std::shared_ptr<dyn_iterator> iter;
+		expression_ptr expr;
+		if(!expression_pool.get_by_id(params[2], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[2]);
+		return add_stage(params[1], pipeline_iterator::stage(pipeline_iterator::operation::project, std::move(expr)));
+	}
+
+	// native Iter:iter_skip(IterTag:iter, count);
+	AMX_DEFINE_NATIVE_TAG(iter_skip, 2, iter)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "count");
+		return add_stage(params[1], pipeline_iterator::stage(pipeline_iterator::operation::skip, params[2]));
+	}
+
+	// native Iter:iter_take(IterTag:iter, count);
+	AMX_DEFINE_NATIVE_TAG(iter_take, 2, iter)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "count");
+		return add_stage(params[1], pipeline_iterator::stage(pipeline_iterator::operation::take, params[2]));
+	}
+
+	// native Iter:iter_distinct(IterTag:iter);
+	AMX_DEFINE_NATIVE_TAG(iter_distinct, 1, iter)
+	{
+		return add_stage(params[1], pipeline_iterator::stage(pipeline_iterator::operation::distinct, 0));
+	}
+
+	// native Iter:iter_zip(IterTag:iter, IterTag:other);
+	AMX_DEFINE_NATIVE_TAG(iter_zip, 2, iter)
+	{
+		std::shared_ptr<dyn_iterator> other;
+		if(!iter_pool.get_by_id(params[2], other)) amx_LogicError(errors::pointer_invalid, "iterator", params[2]);
+		return add_stage(params[1], pipeline_iterator::stage(std::move(other)));
+	}
+
+	// native iter_count(IterTag:iter);
+	AMX_DEFINE_NATIVE_TAG(iter_count, 1, cell)
+	{
+		dyn_iterator *iter;
+		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		cell count = 0;
+		while(iter->valid())
+		{
+			count++;
+			if(!iter->move_next())
+			{
+				break;
+			}
+		}
+		return count;
+	}
+
+	// native Variant:iter_sum(IterTag:iter);
+	AMX_DEFINE_NATIVE_TAG(iter_sum, 1, variant)
+	{
+		dyn_iterator *iter;
+		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		dyn_object result;
+		bool first = true;
+		for_each_value(iter, [&](const dyn_object &value)
+		{
+			if(first)
+			{
+				result = value;
+				first = false;
+			}else{
+				result = result + value;
+			}
+		});
+		return variants::create(std::move(result));
+	}
+
+	// native Variant:iter_min(IterTag:iter);
+	AMX_DEFINE_NATIVE_TAG(iter_min, 1, variant)
+	{
+		return iter_extreme<std::less<dyn_object>>(amx, params);
+	}
+
+	// native Variant:iter_max(IterTag:iter);
+	AMX_DEFINE_NATIVE_TAG(iter_max, 1, variant)
+	{
+		return iter_extreme<std::greater<dyn_object>>(amx, params);
+	}
+
+	// native List:iter_to_list(IterTag:iter);
+	AMX_DEFINE_NATIVE_TAG(iter_to_list, 1, list)
+	{
+		dyn_iterator *iter;
+		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		auto ptr = list_pool.add();
+		for_each_value(iter, [&](const dyn_object &value)
+		{
+			ptr->push_back(value);
+		});
+		return list_pool.get_id(ptr);
+	}
+
+	// native Map:iter_to_map(IterTag:iter, bool:ordered=false);
+	AMX_DEFINE_NATIVE_TAG(iter_to_map, 1, map)
+	{
+		dyn_iterator *iter;
+		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		bool ordered = optparam(2, 0);
+		auto ptr = map_pool.emplace(ordered);
+		for_each_element(iter, [&](const dyn_object &value, const dyn_object *key)
+		{
+			if(key == nullptr) amx_LogicError(errors::operation_not_supported, "iterator");
+			(*ptr)[*key] = value;
+		});
+		return map_pool.get_id(ptr);
+	}
+
+	// native Map:iter_group_by(IterTag:iter, Expression:expr, bool:ordered=false);
+	AMX_DEFINE_NATIVE_TAG(iter_group_by, 2, map)
+	{
+		dyn_iterator *iter;
 		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
 		expression_ptr expr;
 		if(!expression_pool.get_by_id(params[2], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[2]);
-		return iter_pool.get_id(iter_pool.emplace_derived<project_iterator>(std::move(iter), std::move(expr)));
+		bool ordered = optparam(3, 0);
+		auto ptr = map_pool.emplace(ordered);
+		std::unordered_map<dyn_object, list_t*> groups;
+		expression::args_type args;
+		for_each_element(iter, [&](const dyn_object &value, const dyn_object *key)
+		{
+			args.clear();
+			args.push_back(std::cref(value));
+			if(key != nullptr)
+			{
+				args.push_back(std::cref(*key));
+			}
+			dyn_object group = expr->execute(args, expression::exec_info(amx));
+			auto it = groups.find(group);
+			if(it == groups.end())
+			{
+				auto list = list_pool.add();
+				ptr->insert(group, dyn_object(list_pool.get_id(list), tags::find_tag(tags::tag_list)));
+				it = groups.emplace(std::move(group), &*list).first;
+			}
+			it->second->push_back(value);
+		});
+		return map_pool.get_id(ptr);
 	}
 
 	// native Iter:iter_move_next(IterTag:iter, steps=1);
@@ -910,6 +1298,100 @@ namespace Natives
 		return value_at<0>::iter_get<dyn_func_str_s>(amx, params);
 	}
 
+	// native iter_get_many(IterTag:iter, AnyTag:values[], size=sizeof(values), element_size=1, TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(iter_get_many, 3, cell)
+	{
+		cell element_size = optparam(4, 1);
+		tag_ptr tag = tags::find_tag(amx, optparam(5, 0));
+		if(params[3] < 0) amx_LogicError(errors::out_of_range, "size");
+		if(element_size <= 0) amx_LogicError(errors::out_of_range, "element_size");
+		dyn_iterator *iter;
+		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		cell *addr = amx_GetAddrSafe(amx, params[2]);
+		cell max_count = params[3] / element_size;
+		cell count = 0;
+		while(count < max_count && iter->valid())
+		{
+			// the element is not read and the iterator stays on it if the tag doesn't match
+			bool read = value_read(iter, [&](const dyn_object &obj)
+			{
+				if(!obj.tag_assignable(tag))
+				{
+					return false;
+				}
+				if(element_size == 1)
+				{
+					addr[count] = obj.get_cell(0);
+				}else{
+					obj.get_array(addr + count * element_size, element_size);
+				}
+				return true;
+			});
+			if(!read)
+			{
+				break;
+			}
+			count++;
+			if(!iter->move_next())
+			{
+				break;
+			}
+		}
+		return count;
+	}
+
+	// native iter_get_keys_values(IterTag:iter, AnyTag:keys[], AnyTag:values[], keys_size=sizeof(keys), values_size=sizeof(values), key_size=1, value_size=1, TagTag:key_tag_id=tagof(keys), TagTag:value_tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(iter_get_keys_values, 5, cell)
+	{
+		cell key_size = optparam(6, 1);
+		cell value_size = optparam(7, 1);
+		tag_ptr key_tag = tags::find_tag(amx, optparam(8, 0));
+		tag_ptr value_tag = tags::find_tag(amx, optparam(9, 0));
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "keys_size");
+		if(params[5] < 0) amx_LogicError(errors::out_of_range, "values_size");
+		if(key_size <= 0) amx_LogicError(errors::out_of_range, "key_size");
+		if(value_size <= 0) amx_LogicError(errors::out_of_range, "value_size");
+		dyn_iterator *iter;
+		if(!iter_pool.get_by_id(params[1], iter)) amx_LogicError(errors::pointer_invalid, "iterator", params[1]);
+		cell *keys = amx_GetAddrSafe(amx, params[2]);
+		cell *values = amx_GetAddrSafe(amx, params[3]);
+		cell max_count = std::min(params[4] / key_size, params[5] / value_size);
+		cell count = 0;
+		while(count < max_count && iter->valid())
+		{
+			const std::pair<const dyn_object, dyn_object> *cpair;
+			std::shared_ptr<const std::pair<const dyn_object, dyn_object>> spair;
+			if(!iter->extract(cpair))
+			{
+				if(!iter->extract(spair)) amx_LogicError(errors::operation_not_supported, "iterator");
+				cpair = spair.get();
+			}
+			// the element is not read and the iterator stays on it if either tag doesn't match
+			if(!cpair->first.tag_assignable(key_tag) || !cpair->second.tag_assignable(value_tag))
+			{
+				break;
+			}
+			if(key_size == 1)
+			{
+				keys[count] = cpair->first.get_cell(0);
+			}else{
+				cpair->first.get_array(keys + count * key_size, key_size);
+			}
+			if(value_size == 1)
+			{
+				values[count] = cpair->second.get_cell(0);
+			}else{
+				cpair->second.get_array(values + count * value_size, value_size);
+			}
+			count++;
+			if(!iter->move_next())
+			{
+				break;
+			}
+		}
+		return count;
+	}
+
 	// native iter_set(IterTag:iter, AnyTag:value, TagTag:tag_id=tagof(value));
 	AMX_DEFINE_NATIVE_TAG(iter_set, 3, cell)
 	{
@@ -1280,11 +1762,30 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(map_iter_at_str),
 	AMX_DECLARE_NATIVE(map_iter_at_str_s),
 	AMX_DECLARE_NATIVE(map_iter_at_var),
+	AMX_DECLARE_NATIVE(map_iter_lower_bound),
+	AMX_DECLARE_NATIVE(map_iter_lower_bound_arr),
+	AMX_DECLARE_NATIVE(map_iter_lower_bound_str),
+	AMX_DECLARE_NATIVE(map_iter_lower_bound_str_s),
+	AMX_DECLARE_NATIVE(map_iter_lower_bound_var),
+	AMX_DECLARE_NATIVE(map_iter_upper_bound),
+	AMX_DECLARE_NATIVE(map_iter_upper_bound_arr),
+	AMX_DECLARE_NATIVE(map_iter_upper_bound_str),
+	AMX_DECLARE_NATIVE(map_iter_upper_bound_str_s),
+	AMX_DECLARE_NATIVE(map_iter_upper_bound_var),
+	AMX_DECLARE_NATIVE(map_iter_range),
+	AMX_DECLARE_NATIVE(map_iter_range_arr),
+	AMX_DECLARE_NATIVE(map_iter_range_str),
+	AMX_DECLARE_NATIVE(map_iter_range_str_s),
+	AMX_DECLARE_NATIVE(map_iter_range_var),
 	AMX_DECLARE_NATIVE(linked_list_iter),
 	AMX_DECLARE_NATIVE(var_iter),
 	AMX_DECLARE_NATIVE(handle_iter),
 	AMX_DECLARE_NATIVE(pool_iter),
 	AMX_DECLARE_NATIVE(pool_iter_at),
+	AMX_DECLARE_NATIVE(heap_iter),
+	AMX_DECLARE_NATIVE(deque_iter),
+	AMX_DECLARE_NATIVE(bitset_iter),
+	AMX_DECLARE_NATIVE(spatial_iter),
 
 	AMX_DECLARE_NATIVE(iter_valid),
 	AMX_DECLARE_NATIVE(iter_acquire),
@@ -1318,6 +1819,17 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(iter_repeat_var),
 	AMX_DECLARE_NATIVE(iter_filter),
 	AMX_DECLARE_NATIVE(iter_project),
+	AMX_DECLARE_NATIVE(iter_skip),
+	AMX_DECLARE_NATIVE(iter_take),
+	AMX_DECLARE_NATIVE(iter_distinct),
+	AMX_DECLARE_NATIVE(iter_zip),
+	AMX_DECLARE_NATIVE(iter_count),
+	AMX_DECLARE_NATIVE(iter_sum),
+	AMX_DECLARE_NATIVE(iter_min),
+	AMX_DECLARE_NATIVE(iter_max),
+	AMX_DECLARE_NATIVE(iter_to_list),
+	AMX_DECLARE_NATIVE(iter_to_map),
+	AMX_DECLARE_NATIVE(iter_group_by),
 
 	AMX_DECLARE_NATIVE(iter_move_next),
 	AMX_DECLARE_NATIVE(iter_move_previous),
@@ -1332,6 +1844,8 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(iter_get_arr_safe),
 	AMX_DECLARE_NATIVE(iter_get_str_safe),
 	AMX_DECLARE_NATIVE(iter_get_str_safe_s),
+	AMX_DECLARE_NATIVE(iter_get_many),
+	AMX_DECLARE_NATIVE(iter_get_keys_values),
 
 	AMX_DECLARE_NATIVE(iter_set),
 	AMX_DECLARE_NATIVE(iter_set_arr),
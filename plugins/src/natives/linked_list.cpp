@@ -30,9 +30,7 @@ public:
 			amx_LogicError(errors::out_of_range, "index");
 			return 0;
 		}else{
-			auto it = ptr->begin();
-			std::advance(it, index);
-			ptr->insert(it, Factory(amx, params[Indices]...));
+			ptr->insert(ptr->iter_at(index), Factory(amx, params[Indices]...));
 			return index;
 		}
 	}
@@ -297,9 +295,7 @@ namespace Natives
 			amx_LogicError(errors::out_of_range, "index");
 			return 0;
 		}else{
-			auto it = ptr->begin();
-			std::advance(it, params[3]);
-			ptr->insert(it, ptr2->begin(), ptr2->end());
+			ptr->insert(ptr->iter_at(params[3]), ptr2->begin(), ptr2->end());
 			return params[3];
 		}
 	}
@@ -380,9 +376,7 @@ namespace Natives
 		linked_list_t *ptr;
 		if(!linked_list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "linked list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-		auto it = ptr->begin();
-		std::advance(it, params[2]);
-		ptr->erase(it);
+		ptr->erase(ptr->iter_at(params[2]));
 		return 1;
 	}
 
@@ -393,8 +387,7 @@ namespace Natives
 		linked_list_t *ptr;
 		if(!linked_list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "linked list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-		auto it = ptr->begin();
-		std::advance(it, params[2]);
+		auto it = ptr->iter_at(params[2]);
 		(*it)->release();
 		ptr->erase(it);
 		return 1;
@@ -4,9 +4,11 @@
 #include "modules/variants.h"
 #include "modules/expressions.h"
 #include "modules/tag_ops.h"
+#include "utils/parallel_sort.h"
 
 #include <vector>
 #include <algorithm>
+#include <iterator>
 
 template <size_t... Indices>
 class value_at
@@ -54,7 +56,7 @@ public:
 	static cell AMX_NATIVE_CALL list_get(AMX *amx, cell *params)
 	{
 		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
 		return Factory(amx, (*ptr)[params[2]], params[Indices]...);
@@ -65,7 +67,7 @@ public:
 	static cell AMX_NATIVE_CALL list_find(AMX *amx, cell *params)
 	{
 		cell index = optparam(3, 0);
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(index < 0)
 		{
@@ -74,14 +76,7 @@ public:
 		if(index != ptr->size())
 		{
 			if(index < 0 || static_cast<ucell>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-			auto find = Factory(amx, params[Indices]...);
-			for(size_t i = static_cast<size_t>(index); i < ptr->size(); i++)
-			{
-				if((*ptr)[i] == find)
-				{
-					return static_cast<cell>(i);
-				}
-			}
+			return ptr->find(Factory(amx, params[Indices]...), static_cast<size_t>(index));
 		}
 		return -1;
 	}
@@ -91,7 +86,7 @@ public:
 	static cell AMX_NATIVE_CALL list_find_last(AMX *amx, cell *params)
 	{
 		cell index = optparam(3, -1);
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(index < 0)
 		{
@@ -100,15 +95,7 @@ public:
 		if(index != -1)
 		{
 			if(index < 0 || static_cast<ucell>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
-			auto find = Factory(amx, params[Indices]...);
-			while(index >= 0)
-			{
-				if((*ptr)[index] == find)
-				{
-					return index;
-				}
-				index--;
-			}
+			return ptr->find_last(Factory(amx, params[Indices]...), index);
 		}
 		return -1;
 	}
@@ -134,9 +121,9 @@ public:
 	template <value_ftype Factory>
 	static cell AMX_NATIVE_CALL list_count(AMX *amx, cell *params)
 	{
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
-		return std::count(ptr->begin(), ptr->end(), Factory(amx, params[Indices]...));
+		return static_cast<cell>(ptr->count(Factory(amx, params[Indices]...)));
 	}
 };
 
@@ -277,9 +264,15 @@ namespace Natives
 		list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		auto l = list_pool.add();
-		for(auto &&obj : *ptr)
+		if(ptr->clone_is_copy())
 		{
-			l->push_back(obj.clone());
+			l->share(*ptr);
+		}else{
+			const list_t &source = *ptr;
+			for(auto &&obj : source)
+			{
+				l->push_back(obj.clone());
+			}
 		}
 		return list_pool.get_id(l);
 	}
@@ -287,7 +280,7 @@ namespace Natives
 	// native list_size(List:list);
 	AMX_DEFINE_NATIVE_TAG(list_size, 1, cell)
 	{
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		return static_cast<cell>(ptr->size());
 	}
@@ -295,7 +288,7 @@ namespace Natives
 	// native list_capacity(List:list);
 	AMX_DEFINE_NATIVE_TAG(list_capacity, 1, cell)
 	{
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		return static_cast<cell>(ptr->capacity());
 	}
@@ -360,7 +353,7 @@ namespace Natives
 		if(index < -1) amx_LogicError(errors::out_of_range, "index");
 		list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
-		list_t *ptr2;
+		const list_t *ptr2;
 		if(!list_pool.get_by_id(params[2], ptr2)) amx_LogicError(errors::pointer_invalid, "list", params[2]);
 		if(index == -1)
 		{
@@ -377,6 +370,38 @@ namespace Natives
 		}
 	}
 
+	// native list_add_cells(List:list, const AnyTag:values[], index=-1, count=sizeof(values), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(list_add_cells, 5, cell)
+	{
+		cell index = params[3];
+		if(index < -1) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "count");
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		if(index != -1 && static_cast<ucell>(index) > ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		const cell *arr = amx_GetAddrSafe(amx, params[2]);
+		ucell count = params[4];
+		auto tag = tags::find_tag(amx, params[5]);
+		if(index == -1 || static_cast<ucell>(index) == ptr->size())
+		{
+			index = static_cast<cell>(ptr->size());
+			ptr->reserve(ptr->size() + count);
+			for(ucell i = 0; i < count; i++)
+			{
+				ptr->push_back(dyn_object(arr[i], tag));
+			}
+		}else{
+			std::vector<dyn_object> values;
+			values.reserve(count);
+			for(ucell i = 0; i < count; i++)
+			{
+				values.emplace_back(arr[i], tag);
+			}
+			ptr->insert(ptr->begin() + index, std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+		}
+		return index;
+	}
+
 	// native list_add_args(tag_id=tagof(arg0), List:list, AnyTag:arg0, AnyTag:...);
 	AMX_DEFINE_NATIVE_TAG(list_add_args, 2, cell)
 	{
@@ -517,6 +542,30 @@ namespace Natives
 		return value_at<3, 4>::list_get<dyn_func_arr>(amx, params);
 	}
 
+	// native list_get_cells(List:list, start, AnyTag:values[], count=sizeof(values), offset=0);
+	AMX_DEFINE_NATIVE_TAG(list_get_cells, 4, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "start");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "count");
+		cell offset = optparam(5, 0);
+		const list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		ucell start = params[2];
+		if(start > ptr->size()) amx_LogicError(errors::out_of_range, "start");
+		cell *arr = amx_GetAddrSafe(amx, params[3]);
+		ucell count = params[4];
+		if(count > ptr->size() - start)
+		{
+			count = ptr->size() - start;
+		}
+		auto it = ptr->begin() + start;
+		for(ucell i = 0; i < count; i++, ++it)
+		{
+			arr[i] = it->get_cell(offset);
+		}
+		return static_cast<cell>(count);
+	}
+
 	// native String:list_get_str_s(List:list, index);
 	AMX_DEFINE_NATIVE_TAG(list_get_str_s, 2, string)
 	{
@@ -565,6 +614,34 @@ namespace Natives
 		return value_at<3, 4, 5>::list_set<dyn_func_arr>(amx, params);
 	}
 
+	// native list_set_range(List:list, index, const AnyTag:values[], count=sizeof(values), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(list_set_range, 5, cell)
+	{
+		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "count");
+		list_t *ptr;
+		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
+		ucell index = params[2];
+		if(index > ptr->size()) amx_LogicError(errors::out_of_range, "index");
+		const cell *arr = amx_GetAddrSafe(amx, params[3]);
+		ucell count = params[4];
+		auto tag = tags::find_tag(amx, params[5]);
+		if(index + count > ptr->size())
+		{
+			ptr->reserve(index + count);
+		}
+		ucell i = 0;
+		for(; i < count && index + i < ptr->size(); i++)
+		{
+			(*ptr)[index + i] = dyn_object(arr[i], tag);
+		}
+		for(; i < count; i++)
+		{
+			ptr->push_back(dyn_object(arr[i], tag));
+		}
+		return static_cast<cell>(count);
+	}
+
 	// native list_set_str(List:list, index, const value[]);
 	AMX_DEFINE_NATIVE_TAG(list_set_str, 3, cell)
 	{
@@ -640,7 +717,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(list_tagof, 2, cell)
 	{
 		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
 		auto &obj = (*ptr)[params[2]];
@@ -651,7 +728,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(list_sizeof, 2, cell)
 	{
 		if(params[2] < 0) amx_LogicError(errors::out_of_range, "index");
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		if(static_cast<ucell>(params[2]) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
 		auto &obj = (*ptr)[params[2]];
@@ -722,7 +799,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(list_find_if, 2, cell)
 	{
 		cell index = optparam(3, 0);
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		expression *expr;
 		if(!expression_pool.get_by_id(params[2], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[2]);
@@ -755,7 +832,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(list_find_last_if, 2, cell)
 	{
 		cell index = optparam(3, -1);
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		expression *expr;
 		if(!expression_pool.get_by_id(params[2], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[2]);
@@ -874,7 +951,7 @@ namespace Natives
 	// native list_count_if(List:list, Expression:pred);
 	AMX_DEFINE_NATIVE_TAG(list_count_if, 2, cell)
 	{
-		list_t *ptr;
+		const list_t *ptr;
 		if(!list_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		expression *expr;
 		if(!expression_pool.get_by_id(params[2], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[2]);
@@ -931,6 +1008,21 @@ namespace Natives
 		}
 	};
 
+	// large lists are sorted on multiple threads if the comparisons do not call any code
+	template <class Iterator, class Compare>
+	static void sort_list(Iterator begin, Iterator end, Compare comp, bool stable, bool parallel)
+	{
+		if(parallel)
+		{
+			aux::parallel_sort(begin, end, comp, stable);
+		}else if(stable)
+		{
+			std::stable_sort(begin, end, comp);
+		}else{
+			std::sort(begin, end, comp);
+		}
+	}
+
 	// native list_sort(List:list, offset=0, size=1, bool:reverse=false, bool:stable=true);
 	AMX_DEFINE_NATIVE_TAG(list_sort, 1, cell)
 	{
@@ -958,42 +1050,28 @@ namespace Natives
 
 		bool simple = offset == 0 && size == -1;
 
+		if(ptr->radix_sort(offset, size, reverse))
+		{
+			return 1;
+		}
+
+		bool parallel = ptr->pure_order();
 		if(!reverse)
 		{
 			auto begin = ptr->begin(), end = ptr->end();
-			if(stable)
+			if(simple)
 			{
-				if(simple)
-				{
-					std::stable_sort(begin, end);
-				}else{
-					std::stable_sort(begin, end, cell_sorter(offset, size));
-				}
+				sort_list(begin, end, std::less<dyn_object>(), stable, parallel);
 			}else{
-				if(simple)
-				{
-					std::sort(begin, end);
-				}else{
-					std::sort(begin, end, cell_sorter(offset, size));
-				}
+				sort_list(begin, end, cell_sorter(offset, size), stable, parallel);
 			}
 		}else{
 			auto begin = ptr->rbegin(), end = ptr->rend();
-			if(stable)
+			if(simple)
 			{
-				if(simple)
-				{
-					std::stable_sort(begin, end);
-				}else{
-					std::stable_sort(begin, end, cell_sorter(offset, size));
-				}
+				sort_list(begin, end, std::less<dyn_object>(), stable, parallel);
 			}else{
-				if(simple)
-				{
-					std::sort(begin, end);
-				}else{
-					std::sort(begin, end, cell_sorter(offset, size));
-				}
+				sort_list(begin, end, cell_sorter(offset, size), stable, parallel);
 			}
 		}
 		return 1;
@@ -1084,6 +1162,7 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(list_add_str_s),
 	AMX_DECLARE_NATIVE(list_add_var),
 	AMX_DECLARE_NATIVE(list_add_list),
+	AMX_DECLARE_NATIVE(list_add_cells),
 	AMX_DECLARE_NATIVE(list_add_args),
 	AMX_DECLARE_NATIVE(list_add_args_str),
 	AMX_DECLARE_NATIVE(list_add_args_var),
@@ -1098,6 +1177,7 @@ static AMX_NATIVE_INFO native_list[] =
 
 	AMX_DECLARE_NATIVE(list_get),
 	AMX_DECLARE_NATIVE(list_get_arr),
+	AMX_DECLARE_NATIVE(list_get_cells),
 	AMX_DECLARE_NATIVE(list_get_str_s),
 	AMX_DECLARE_NATIVE(list_get_var),
 	AMX_DECLARE_NATIVE(list_get_safe),
@@ -1107,6 +1187,7 @@ static AMX_NATIVE_INFO native_list[] =
 
 	AMX_DECLARE_NATIVE(list_set),
 	AMX_DECLARE_NATIVE(list_set_arr),
+	AMX_DECLARE_NATIVE(list_set_range),
 	AMX_DECLARE_NATIVE(list_set_str),
 	AMX_DECLARE_NATIVE(list_set_str_s),
 	AMX_DECLARE_NATIVE(list_set_var),
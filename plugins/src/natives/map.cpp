@@ -3,9 +3,86 @@
 #include "modules/containers.h"
 #include "modules/variants.h"
 #include "modules/expressions.h"
+#include "modules/strings.h"
 #include <iterator>
 #include <algorithm>
 
+// Finds a key produced by a factory; typed maps are searched without constructing the key
+template <class Factory, Factory KeyFactory>
+struct map_key
+{
+	static bool typed(const map_t &map)
+	{
+		return false;
+	}
+
+	template <class Map, class... Args>
+	static auto find(Map &map, AMX *amx, Args... args) -> decltype(map.find(dyn_object()))
+	{
+		return map.find(KeyFactory(amx, args...));
+	}
+};
+
+template <>
+struct map_key<dyn_object(&)(AMX*, cell, cell), dyn_func>
+{
+	static bool typed(const map_t &map)
+	{
+		return map.lookup_kind() == map_t::key_kind::cell;
+	}
+
+	template <class Map>
+	static auto find(Map &map, AMX *amx, cell value, cell tag_id) -> decltype(map.find(dyn_object()))
+	{
+		tag_ptr tag = tags::find_tag(amx, tag_id);
+		if(tag->uid == tags::tag_cell && typed(map))
+		{
+			return map.find_cell(value);
+		}
+		return map.find(dyn_object(value, tag));
+	}
+};
+
+template <>
+struct map_key<dyn_object(&)(AMX*, cell), dyn_func_str>
+{
+	static bool typed(const map_t &map)
+	{
+		return map.lookup_kind() == map_t::key_kind::string;
+	}
+
+	template <class Map>
+	static auto find(Map &map, AMX *amx, cell amx_addr) -> decltype(map.find(dyn_object()))
+	{
+		if(typed(map))
+		{
+			cell *str = amx_GetAddrSafe(amx, amx_addr);
+			return map.find_string(str, dyn_object::string_size(str));
+		}
+		return map.find(dyn_func_str(amx, amx_addr));
+	}
+};
+
+template <>
+struct map_key<dyn_object(&)(AMX*, cell), dyn_func_str_s>
+{
+	static bool typed(const map_t &map)
+	{
+		return map.lookup_kind() == map_t::key_kind::string;
+	}
+
+	template <class Map>
+	static auto find(Map &map, AMX *amx, cell str) -> decltype(map.find(dyn_object()))
+	{
+		strings::cell_string *ptr;
+		if(typed(map) && strings::pool.get_by_id(str, ptr))
+		{
+			return map.find_string(ptr->data(), ptr->size());
+		}
+		return map.find(dyn_func_str_s(amx, str));
+	}
+};
+
 template <size_t... KeyIndices>
 class key_at
 {
@@ -25,6 +102,14 @@ public:
 		{
 			map_t *ptr;
 			if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+			if(map_key<key_ftype, KeyFactory>::typed(*ptr))
+			{
+				const map_t &map = *ptr;
+				if(map_key<key_ftype, KeyFactory>::find(map, amx, params[KeyIndices]...) != map.end())
+				{
+					return 0;
+				}
+			}
 			auto ret = ptr->insert(KeyFactory(amx, params[KeyIndices]...), ValueFactory(amx, params[ValueIndices]...));
 			return static_cast<cell>(ret.second);
 		}
@@ -35,6 +120,15 @@ public:
 		{
 			map_t *ptr;
 			if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
+			if(map_key<key_ftype, KeyFactory>::typed(*ptr))
+			{
+				auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
+				if(it != ptr->end())
+				{
+					it->second = ValueFactory(amx, params[ValueIndices]...);
+					return 1;
+				}
+			}
 			(*ptr)[KeyFactory(amx, params[KeyIndices]...)] = ValueFactory(amx, params[ValueIndices]...);
 			return 1;
 		}
@@ -43,9 +137,9 @@ public:
 		template <key_ftype KeyFactory, result_ftype ValueFactory>
 		static cell AMX_NATIVE_CALL map_get(AMX *amx, cell *params)
 		{
-			map_t *ptr;
+			const map_t *ptr;
 			if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-			auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+			auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 			if(it != ptr->end())
 			{
 				return ValueFactory(amx, it->second, params[ValueIndices]...);
@@ -61,7 +155,7 @@ public:
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 		if(it != ptr->end())
 		{
 			ptr->erase(it);
@@ -76,7 +170,7 @@ public:
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 		if(it != ptr->end())
 		{
 			it->first.release();
@@ -91,9 +185,9 @@ public:
 	template <key_ftype KeyFactory>
 	static cell AMX_NATIVE_CALL map_has_key(AMX *amx, cell *params)
 	{
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 		if(it != ptr->end())
 		{
 			return 1;
@@ -108,7 +202,7 @@ public:
 		if(params[3] < 0) amx_LogicError(errors::out_of_range, "offset");
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 		if(it != ptr->end())
 		{
 			auto &obj = it->second;
@@ -124,9 +218,9 @@ public:
 	template <key_ftype KeyFactory>
 	static cell AMX_NATIVE_CALL map_tagof(AMX *amx, cell *params)
 	{
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 		if(it != ptr->end())
 		{
 			return it->second.get_tag(amx);
@@ -139,9 +233,9 @@ public:
 	template <key_ftype KeyFactory>
 	static cell AMX_NATIVE_CALL map_sizeof(AMX *amx, cell *params)
 	{
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto it = ptr->find(KeyFactory(amx, params[KeyIndices]...));
+		auto it = map_key<key_ftype, KeyFactory>::find(*ptr, amx, params[KeyIndices]...);
 		if(it != ptr->end())
 		{
 			return it->second.get_size();
@@ -164,7 +258,7 @@ public:
 	{
 		cell index = params[2];
 		if(index < 0) amx_LogicError(errors::out_of_range, "index");
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		if(static_cast<size_t>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
 		auto it = ptr->begin();
@@ -183,7 +277,7 @@ public:
 	{
 		cell index = params[2];
 		if(index < 0) amx_LogicError(errors::out_of_range, "index");
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		if(static_cast<size_t>(index) >= ptr->size()) amx_LogicError(errors::out_of_range, "index");
 		auto it = ptr->begin();
@@ -200,7 +294,7 @@ public:
 	template <value_ftype ValueFactory>
 	static cell AMX_NATIVE_CALL map_count(AMX *amx, cell *params)
 	{
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		auto find = ValueFactory(amx, params[ValueIndices]...);
 		return std::count_if(ptr->begin(), ptr->end(), [&](const std::pair<const dyn_object, dyn_object> &pair)
@@ -212,11 +306,21 @@ public:
 
 namespace Natives
 {
-	// native Map:map_new(bool:ordered=false);
+	// native Map:map_new(bool:ordered=false, map_key_kind:key_kind=map_key_any);
 	AMX_DEFINE_NATIVE_TAG(map_new, 0, map)
 	{
 		bool ordered = optparam(1, 0);
-		return map_pool.get_id(map_pool.emplace(ordered));
+		auto kind = map_t::key_kind::generic;
+		switch(optparam(2, 0))
+		{
+			case 1:
+				kind = map_t::key_kind::cell;
+				break;
+			case 2:
+				kind = map_t::key_kind::string;
+				break;
+		}
+		return map_pool.get_id(map_pool.emplace(ordered, kind));
 	}
 
 	// native Map:map_new_args(key_tag_id=tagof(arg0), TagTag:value_tag_id=tagof(arg1), AnyTag:arg0, AnyTag:arg1, AnyTag:...);
@@ -567,11 +671,16 @@ namespace Natives
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		auto m = map_pool.add();
-		m->set_ordered(ptr->ordered());
-		for(auto &&pair : *ptr)
+		auto m = map_pool.emplace(ptr->ordered(), ptr->get_key_kind());
+		if(ptr->clone_is_copy())
 		{
-			m->insert(pair.first.clone(), pair.second.clone());
+			m->share(*ptr);
+		}else{
+			const map_t &source = *ptr;
+			for(auto &&pair : source)
+			{
+				m->insert(pair.first.clone(), pair.second.clone());
+			}
 		}
 		return map_pool.get_id(m);
 	}
@@ -579,7 +688,7 @@ namespace Natives
 	// native map_size(Map:map);
 	AMX_DEFINE_NATIVE_TAG(map_size, 1, cell)
 	{
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		return static_cast<cell>(ptr->size());
 	}
@@ -587,7 +696,7 @@ namespace Natives
 	// native map_capacity(Map:map);
 	AMX_DEFINE_NATIVE_TAG(map_capacity, 1, cell)
 	{
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		return static_cast<cell>(ptr->capacity());
 	}
@@ -608,7 +717,7 @@ namespace Natives
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		map_t(ptr->ordered()).swap(*ptr);
+		map_t(ptr->ordered(), ptr->get_key_kind()).swap(*ptr);
 		return 1;
 	}
 
@@ -617,7 +726,7 @@ namespace Natives
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		map_t old(ptr->ordered());
+		map_t old(ptr->ordered(), ptr->get_key_kind());
 		ptr->swap(old);
 		for(auto &pair : old)
 		{
@@ -639,7 +748,7 @@ namespace Natives
 	// native bool:map_is_ordered(Map:map);
 	AMX_DEFINE_NATIVE_TAG(map_is_ordered, 1, bool)
 	{
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		return ptr->ordered();
 	}
@@ -799,7 +908,7 @@ namespace Natives
 	{
 		map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
-		map_t *ptr2;
+		const map_t *ptr2;
 		if(!map_pool.get_by_id(params[1], ptr2)) amx_LogicError(errors::pointer_invalid, "map", params[2]);
 		if(params[3])
 		{
@@ -1840,7 +1949,7 @@ namespace Natives
 	// native map_count_if(Map:map, Expression:pred);
 	AMX_DEFINE_NATIVE_TAG(map_count_if, 2, cell)
 	{
-		map_t *ptr;
+		const map_t *ptr;
 		if(!map_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "map", params[1]);
 		expression *expr;
 		if(!expression_pool.get_by_id(params[2], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[2]);
@@ -6,7 +6,7 @@
 #include "modules/strings.h"
 #include "modules/containers.h"
 #include "modules/guards.h"
-#include "utils/shared_id_set_pool.h"
+#include "utils/slot_map_pool.h"
 #include <limits>
 
 cell pawn_call(AMX *amx, cell paramsize, cell *params, size_t args_start, bool native, bool try_, std::string *msg, AMX *target_amx);
@@ -262,6 +262,24 @@ namespace Natives
 		return value_at<2>::pool_add<dyn_func_var>(amx, params);
 	}
 
+	// native pool_add_cells(Pool:pool, const AnyTag:values[], indices[], count=sizeof(values), TagTag:tag_id=tagof(values));
+	AMX_DEFINE_NATIVE_TAG(pool_add_cells, 5, cell)
+	{
+		if(params[4] < 0) amx_LogicError(errors::out_of_range, "count");
+		pool_t *ptr;
+		if(!pool_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "pool", params[1]);
+		const cell *arr = amx_GetAddrSafe(amx, params[2]);
+		cell *indices = amx_GetAddrSafe(amx, params[3]);
+		ucell count = params[4];
+		auto tag = tags::find_tag(amx, params[5]);
+		ptr->reserve(ptr->num_elements() + count);
+		for(ucell i = 0; i < count; i++)
+		{
+			indices[i] = static_cast<cell>(ptr->push_back(dyn_object(arr[i], tag)));
+		}
+		return static_cast<cell>(count);
+	}
+
 	// native bool:pool_remove(Pool:pool, index);
 	AMX_DEFINE_NATIVE_TAG(pool_remove, 2, bool)
 	{
@@ -657,6 +675,7 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(pool_add_str),
 	AMX_DECLARE_NATIVE(pool_add_str_s),
 	AMX_DECLARE_NATIVE(pool_add_var),
+	AMX_DECLARE_NATIVE(pool_add_cells),
 
 	AMX_DECLARE_NATIVE(pool_remove),
 	AMX_DECLARE_NATIVE(pool_remove_deep),
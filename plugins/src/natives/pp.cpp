@@ -9,9 +9,11 @@
 #include "modules/variants.h"
 #include "modules/guards.h"
 #include "modules/containers.h"
+#include "modules/spatial.h"
 #include "modules/amxhook.h"
 #include "modules/expressions.h"
 #include "modules/amxutils.h"
+#include "modules/stats.h"
 #include "utils/systools.h"
 
 #include <cstring>
@@ -24,6 +26,17 @@
 #include <chrono>
 #include <time.h>
 
+static dyn_object stats_key(const char *name)
+{
+	strings::cell_string str(name, name + std::strlen(name));
+	return dyn_object(str.c_str(), str.size() + 1, tags::find_tag(tags::tag_char));
+}
+
+static void stats_set(map_t &map, const char *name, size_t value)
+{
+	map.insert(stats_key(name), dyn_object(static_cast<cell>(value), tags::find_tag(tags::tag_cell)));
+}
+
 namespace Natives
 {
 	// native pp_version();
@@ -152,6 +165,30 @@ namespace Natives
 		return pool_pool.size();
 	}
 
+	// native pp_num_heaps();
+	AMX_DEFINE_NATIVE_TAG(pp_num_heaps, 0, cell)
+	{
+		return heap_pool.size();
+	}
+
+	// native pp_num_deques();
+	AMX_DEFINE_NATIVE_TAG(pp_num_deques, 0, cell)
+	{
+		return deque_pool.size();
+	}
+
+	// native pp_num_bitsets();
+	AMX_DEFINE_NATIVE_TAG(pp_num_bitsets, 0, cell)
+	{
+		return bitset_pool.size();
+	}
+
+	// native pp_num_spatials();
+	AMX_DEFINE_NATIVE_TAG(pp_num_spatials, 0, cell)
+	{
+		return spatial_pool.size();
+	}
+
 	// native pp_num_guards();
 	AMX_DEFINE_NATIVE_TAG(pp_num_guards, 0, cell)
 	{
@@ -268,13 +305,63 @@ namespace Natives
 		return amxhook::hook_count();
 	}
 
+	// native Map:pp_stats();
+	AMX_DEFINE_NATIVE_TAG(pp_stats, 0, map)
+	{
+		auto result = map_pool.add();
+		for(size_t i = 0; i < stats::count(); i++)
+		{
+			auto value = stats::get(i);
+			auto &entry = map_pool.add();
+			stats_set(*entry, "live", value.live);
+			stats_set(*entry, "peak", value.peak);
+			stats_set(*entry, "allocations", value.allocations);
+			stats_set(*entry, "frees", value.frees);
+			stats_set(*entry, "bytes", value.bytes);
+			result->insert(stats_key(stats::name(i)), dyn_object(map_pool.get_id(entry), tags::find_tag(tags::tag_map)));
+		}
+		return map_pool.get_id(result);
+	}
+
+	// native pp_stats_reset();
+	AMX_DEFINE_NATIVE_TAG(pp_stats_reset, 0, cell)
+	{
+		stats::reset();
+		return 1;
+	}
+
 	// native pp_collect();
 	AMX_DEFINE_NATIVE_TAG(pp_collect, 0, cell)
 	{
 		gc_collect();
+		gc_finish();
 		return 1;
 	}
 
+	// native pp_max_collect_objects(count);
+	AMX_DEFINE_NATIVE_TAG(pp_max_collect_objects, 1, cell)
+	{
+		cell oldvalue = static_cast<cell>(gc_max_objects);
+		gc_max_objects = params[1] > 0 ? static_cast<size_t>(params[1]) : 0;
+		return oldvalue;
+	}
+
+	// native pp_max_collect_time(microseconds);
+	AMX_DEFINE_NATIVE_TAG(pp_max_collect_time, 1, cell)
+	{
+		cell oldvalue = static_cast<cell>(gc_max_time);
+		gc_max_time = params[1] > 0 ? static_cast<size_t>(params[1]) : 0;
+		return oldvalue;
+	}
+
+	// native pp_max_rehash_slots(count);
+	AMX_DEFINE_NATIVE_TAG(pp_max_rehash_slots, 1, cell)
+	{
+		cell oldvalue = static_cast<cell>(map_rehash_slots);
+		map_rehash_slots = params[1] > 0 ? static_cast<size_t>(params[1]) : 0;
+		return oldvalue;
+	}
+
 	// native pp_num_natives();
 	AMX_DEFINE_NATIVE_TAG(pp_num_natives, 0, cell)
 	{
@@ -599,6 +686,10 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(pp_num_linked_lists),
 	AMX_DECLARE_NATIVE(pp_num_maps),
 	AMX_DECLARE_NATIVE(pp_num_pools),
+	AMX_DECLARE_NATIVE(pp_num_heaps),
+	AMX_DECLARE_NATIVE(pp_num_deques),
+	AMX_DECLARE_NATIVE(pp_num_bitsets),
+	AMX_DECLARE_NATIVE(pp_num_spatials),
 	AMX_DECLARE_NATIVE(pp_num_guards),
 	AMX_DECLARE_NATIVE(pp_num_amx_guards),
 	AMX_DECLARE_NATIVE(pp_num_amx_vars),
@@ -610,9 +701,14 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(pp_num_global_expressions),
 	AMX_DECLARE_NATIVE(pp_max_hooked_natives),
 	AMX_DECLARE_NATIVE(pp_num_hooked_natives),
+	AMX_DECLARE_NATIVE(pp_stats),
+	AMX_DECLARE_NATIVE(pp_stats_reset),
 	AMX_DECLARE_NATIVE(pp_entry),
 	AMX_DECLARE_NATIVE(pp_entry_s),
 	AMX_DECLARE_NATIVE(pp_collect),
+	AMX_DECLARE_NATIVE(pp_max_collect_objects),
+	AMX_DECLARE_NATIVE(pp_max_collect_time),
+	AMX_DECLARE_NATIVE(pp_max_rehash_slots),
 	AMX_DECLARE_NATIVE(pp_num_natives),
 	AMX_DECLARE_NATIVE(pp_max_recursion),
 	AMX_DECLARE_NATIVE(pp_toggle_exec_hook),
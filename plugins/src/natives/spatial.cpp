@@ -0,0 +1,391 @@
+#include "natives.h"
+#include "errors.h"
+#include "modules/spatial.h"
+#include "modules/variants.h"
+#include "modules/iterators.h"
+
+template <size_t... Indices>
+class value_at
+{
+	using value_ftype = typename dyn_factory<Indices...>::type;
+	using result_ftype = typename dyn_result<Indices...>::type;
+
+public:
+	// native spatial_add(Spatial:spatial, Float:x, Float:y, Float:z, value, ...);
+	template <value_ftype Factory>
+	static cell AMX_NATIVE_CALL spatial_add(AMX *amx, cell *params)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		return static_cast<cell>(ptr->add(amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4]), Factory(amx, params[Indices]...)));
+	}
+
+	// native spatial_get(Spatial:spatial, id, ...);
+	template <result_ftype Factory>
+	static cell AMX_NATIVE_CALL spatial_get(AMX *amx, cell *params)
+	{
+		const spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[2] < 0 || !ptr->has(params[2])) amx_LogicError(errors::element_not_present);
+		return Factory(amx, (*ptr)[params[2]].value, params[Indices]...);
+	}
+
+	// native spatial_set(Spatial:spatial, id, value, ...);
+	template <value_ftype Factory>
+	static cell AMX_NATIVE_CALL spatial_set(AMX *amx, cell *params)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[2] < 0 || !ptr->has(params[2])) amx_LogicError(errors::element_not_present);
+		(*ptr)[params[2]].value = Factory(amx, params[Indices]...);
+		return 1;
+	}
+};
+
+namespace Natives
+{
+	// native Spatial:spatial_new(Float:cell_size=10.0);
+	AMX_DEFINE_NATIVE_TAG(spatial_new, 0, spatial)
+	{
+		float cell_size = 10.0f;
+		if(params[0] / sizeof(cell) >= 1)
+		{
+			cell_size = amx_ctof(params[1]);
+		}
+		if(!(cell_size > 0)) amx_LogicError(errors::out_of_range, "cell_size");
+		return spatial_pool.get_id(spatial_pool.emplace(cell_size));
+	}
+
+	// native bool:spatial_valid(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_valid, 1, bool)
+	{
+		spatial_t *ptr;
+		return spatial_pool.get_by_id(params[1], ptr);
+	}
+
+	// native spatial_delete(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_delete, 1, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		return spatial_pool.remove(ptr);
+	}
+
+	// native spatial_delete_deep(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_delete_deep, 1, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		spatial_t old(ptr->get_cell_size());
+		std::swap(old, *ptr);
+		spatial_pool.remove(ptr);
+		old.for_each([](dyn_object &obj)
+		{
+			obj.release();
+		});
+		return 1;
+	}
+
+	// native Spatial:spatial_clone(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_clone, 1, spatial)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		auto &s = spatial_pool.emplace(*ptr);
+		if(!ptr->clone_is_copy())
+		{
+			s->for_each([](dyn_object &obj)
+			{
+				obj = obj.clone();
+			});
+		}
+		return spatial_pool.get_id(s);
+	}
+
+	// native spatial_size(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_size, 1, cell)
+	{
+		const spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		return static_cast<cell>(ptr->size());
+	}
+
+	// native Float:spatial_cell_size(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_cell_size, 1, float)
+	{
+		const spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		float cell_size = ptr->get_cell_size();
+		return amx_ftoc(cell_size);
+	}
+
+	// native spatial_clear(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_clear, 1, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		ptr->clear();
+		return 1;
+	}
+
+	// native spatial_clear_deep(Spatial:spatial);
+	AMX_DEFINE_NATIVE_TAG(spatial_clear_deep, 1, cell)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		spatial_t old(ptr->get_cell_size());
+		std::swap(old, *ptr);
+		old.for_each([](dyn_object &obj)
+		{
+			obj.release();
+		});
+		return 1;
+	}
+
+	// native spatial_add(Spatial:spatial, Float:x, Float:y, Float:z, AnyTag:value, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(spatial_add, 6, cell)
+	{
+		return value_at<5, 6>::spatial_add<dyn_func>(amx, params);
+	}
+
+	// native spatial_add_arr(Spatial:spatial, Float:x, Float:y, Float:z, const AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(spatial_add_arr, 7, cell)
+	{
+		return value_at<5, 6, 7>::spatial_add<dyn_func_arr>(amx, params);
+	}
+
+	// native spatial_add_str(Spatial:spatial, Float:x, Float:y, Float:z, const value[]);
+	AMX_DEFINE_NATIVE_TAG(spatial_add_str, 5, cell)
+	{
+		return value_at<5>::spatial_add<dyn_func_str>(amx, params);
+	}
+
+	// native spatial_add_str_s(Spatial:spatial, Float:x, Float:y, Float:z, ConstStringTag:value);
+	AMX_DEFINE_NATIVE_TAG(spatial_add_str_s, 5, cell)
+	{
+		return value_at<5>::spatial_add<dyn_func_str_s>(amx, params);
+	}
+
+	// native spatial_add_var(Spatial:spatial, Float:x, Float:y, Float:z, ConstVariantTag:value);
+	AMX_DEFINE_NATIVE_TAG(spatial_add_var, 5, cell)
+	{
+		return value_at<5>::spatial_add<dyn_func_var>(amx, params);
+	}
+
+	// native bool:spatial_has(Spatial:spatial, id);
+	AMX_DEFINE_NATIVE_TAG(spatial_has, 2, bool)
+	{
+		const spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		return params[2] >= 0 && ptr->has(params[2]);
+	}
+
+	// native bool:spatial_remove(Spatial:spatial, id);
+	AMX_DEFINE_NATIVE_TAG(spatial_remove, 2, bool)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[2] < 0 || !ptr->has(params[2]))
+		{
+			return 0;
+		}
+		ptr->remove(params[2]);
+		return 1;
+	}
+
+	// native bool:spatial_remove_deep(Spatial:spatial, id);
+	AMX_DEFINE_NATIVE_TAG(spatial_remove_deep, 2, bool)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[2] < 0 || !ptr->has(params[2]))
+		{
+			return 0;
+		}
+		ptr->remove(params[2]).release();
+		return 1;
+	}
+
+	// native bool:spatial_move(Spatial:spatial, id, Float:x, Float:y, Float:z);
+	AMX_DEFINE_NATIVE_TAG(spatial_move, 5, bool)
+	{
+		spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[2] < 0)
+		{
+			return 0;
+		}
+		return ptr->move(params[2], amx_ctof(params[3]), amx_ctof(params[4]), amx_ctof(params[5]));
+	}
+
+	// native spatial_get_pos(Spatial:spatial, id, &Float:x, &Float:y, &Float:z);
+	AMX_DEFINE_NATIVE_TAG(spatial_get_pos, 5, cell)
+	{
+		const spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[2] < 0 || !ptr->has(params[2])) amx_LogicError(errors::element_not_present);
+		const auto &e = (*ptr)[params[2]];
+		float x = e.x, y = e.y, z = e.z;
+		*amx_GetAddrSafe(amx, params[3]) = amx_ftoc(x);
+		*amx_GetAddrSafe(amx, params[4]) = amx_ftoc(y);
+		*amx_GetAddrSafe(amx, params[5]) = amx_ftoc(z);
+		return 1;
+	}
+
+	// native spatial_get(Spatial:spatial, id, offset=0);
+	AMX_DEFINE_NATIVE(spatial_get, 3)
+	{
+		return value_at<3>::spatial_get<dyn_func>(amx, params);
+	}
+
+	// native spatial_get_arr(Spatial:spatial, id, AnyTag:value[], size=sizeof(value));
+	AMX_DEFINE_NATIVE_TAG(spatial_get_arr, 4, cell)
+	{
+		return value_at<3, 4>::spatial_get<dyn_func_arr>(amx, params);
+	}
+
+	// native String:spatial_get_str_s(Spatial:spatial, id);
+	AMX_DEFINE_NATIVE_TAG(spatial_get_str_s, 2, string)
+	{
+		return value_at<>::spatial_get<dyn_func_str_s>(amx, params);
+	}
+
+	// native Variant:spatial_get_var(Spatial:spatial, id);
+	AMX_DEFINE_NATIVE_TAG(spatial_get_var, 2, variant)
+	{
+		return value_at<>::spatial_get<dyn_func_var>(amx, params);
+	}
+
+	// native spatial_set(Spatial:spatial, id, AnyTag:value, TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(spatial_set, 4, cell)
+	{
+		return value_at<3, 4>::spatial_set<dyn_func>(amx, params);
+	}
+
+	// native spatial_set_arr(Spatial:spatial, id, const AnyTag:value[], size=sizeof(value), TagTag:tag_id=tagof(value));
+	AMX_DEFINE_NATIVE_TAG(spatial_set_arr, 5, cell)
+	{
+		return value_at<3, 4, 5>::spatial_set<dyn_func_arr>(amx, params);
+	}
+
+	// native spatial_set_str(Spatial:spatial, id, const value[]);
+	AMX_DEFINE_NATIVE_TAG(spatial_set_str, 3, cell)
+	{
+		return value_at<3>::spatial_set<dyn_func_str>(amx, params);
+	}
+
+	// native spatial_set_str_s(Spatial:spatial, id, ConstStringTag:value);
+	AMX_DEFINE_NATIVE_TAG(spatial_set_str_s, 3, cell)
+	{
+		return value_at<3>::spatial_set<dyn_func_str_s>(amx, params);
+	}
+
+	// native spatial_set_var(Spatial:spatial, id, ConstVariantTag:value);
+	AMX_DEFINE_NATIVE_TAG(spatial_set_var, 3, cell)
+	{
+		return value_at<3>::spatial_set<dyn_func_var>(amx, params);
+	}
+
+	// native spatial_tagof(Spatial:spatial, id);
+	AMX_DEFINE_NATIVE_TAG(spatial_tagof, 2, cell)
+	{
+		const spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[2] < 0 || !ptr->has(params[2])) amx_LogicError(errors::element_not_present);
+		return (*ptr)[params[2]].value.get_tag(amx);
+	}
+
+	// native spatial_sizeof(Spatial:spatial, id);
+	AMX_DEFINE_NATIVE_TAG(spatial_sizeof, 2, cell)
+	{
+		const spatial_t *ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		if(params[2] < 0 || !ptr->has(params[2])) amx_LogicError(errors::element_not_present);
+		return (*ptr)[params[2]].value.get_size();
+	}
+
+	// native Iter:spatial_query_radius(Spatial:spatial, Float:x, Float:y, Float:z, Float:radius, bool:sorted=false);
+	AMX_DEFINE_NATIVE_TAG(spatial_query_radius, 5, iter)
+	{
+		std::shared_ptr<spatial_t> ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		auto results = ptr->query_radius(amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4]), amx_ctof(params[5]), optparam(6, 0));
+		auto &iter = iter_pool.emplace_derived<spatial_iterator_t>(ptr, std::move(results));
+		return iter_pool.get_id(iter);
+	}
+
+	// native Iter:spatial_query_box(Spatial:spatial, Float:min_x, Float:min_y, Float:min_z, Float:max_x, Float:max_y, Float:max_z);
+	AMX_DEFINE_NATIVE_TAG(spatial_query_box, 7, iter)
+	{
+		std::shared_ptr<spatial_t> ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		auto results = ptr->query_box(amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4]), amx_ctof(params[5]), amx_ctof(params[6]), amx_ctof(params[7]));
+		auto &iter = iter_pool.emplace_derived<spatial_iterator_t>(ptr, std::move(results));
+		return iter_pool.get_id(iter);
+	}
+
+	// native Iter:spatial_query_nearest(Spatial:spatial, Float:x, Float:y, Float:z, count=1, Float:max_distance=-1.0);
+	AMX_DEFINE_NATIVE_TAG(spatial_query_nearest, 4, iter)
+	{
+		cell count = optparam(5, 1);
+		if(count < 0) amx_LogicError(errors::out_of_range, "count");
+		std::shared_ptr<spatial_t> ptr;
+		if(!spatial_pool.get_by_id(params[1], ptr)) amx_LogicError(errors::pointer_invalid, "spatial", params[1]);
+		float max_distance = -1.0f;
+		if(params[0] / sizeof(cell) >= 6)
+		{
+			max_distance = amx_ctof(params[6]);
+		}
+		auto results = ptr->query_nearest(amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4]), count, max_distance);
+		auto &iter = iter_pool.emplace_derived<spatial_iterator_t>(ptr, std::move(results));
+		return iter_pool.get_id(iter);
+	}
+}
+
+static AMX_NATIVE_INFO native_list[] =
+{
+	AMX_DECLARE_NATIVE(spatial_new),
+	AMX_DECLARE_NATIVE(spatial_valid),
+	AMX_DECLARE_NATIVE(spatial_delete),
+	AMX_DECLARE_NATIVE(spatial_delete_deep),
+	AMX_DECLARE_NATIVE(spatial_clone),
+	AMX_DECLARE_NATIVE(spatial_size),
+	AMX_DECLARE_NATIVE(spatial_cell_size),
+	AMX_DECLARE_NATIVE(spatial_clear),
+	AMX_DECLARE_NATIVE(spatial_clear_deep),
+
+	AMX_DECLARE_NATIVE(spatial_add),
+	AMX_DECLARE_NATIVE(spatial_add_arr),
+	AMX_DECLARE_NATIVE(spatial_add_str),
+	AMX_DECLARE_NATIVE(spatial_add_str_s),
+	AMX_DECLARE_NATIVE(spatial_add_var),
+
+	AMX_DECLARE_NATIVE(spatial_has),
+	AMX_DECLARE_NATIVE(spatial_remove),
+	AMX_DECLARE_NATIVE(spatial_remove_deep),
+	AMX_DECLARE_NATIVE(spatial_move),
+	AMX_DECLARE_NATIVE(spatial_get_pos),
+
+	AMX_DECLARE_NATIVE(spatial_get),
+	AMX_DECLARE_NATIVE(spatial_get_arr),
+	AMX_DECLARE_NATIVE(spatial_get_str_s),
+	AMX_DECLARE_NATIVE(spatial_get_var),
+
+	AMX_DECLARE_NATIVE(spatial_set),
+	AMX_DECLARE_NATIVE(spatial_set_arr),
+	AMX_DECLARE_NATIVE(spatial_set_str),
+	AMX_DECLARE_NATIVE(spatial_set_str_s),
+	AMX_DECLARE_NATIVE(spatial_set_var),
+
+	AMX_DECLARE_NATIVE(spatial_tagof),
+	AMX_DECLARE_NATIVE(spatial_sizeof),
+
+	AMX_DECLARE_NATIVE(spatial_query_radius),
+	AMX_DECLARE_NATIVE(spatial_query_box),
+	AMX_DECLARE_NATIVE(spatial_query_nearest),
+};
+
+int RegisterSpatialNatives(AMX *amx)
+{
+	return amx_Register(amx, native_list, sizeof(native_list) / sizeof(*native_list));
+}
@@ -86,15 +86,9 @@ namespace Natives
 		return strings::create(addr, size, false, flags & 1, flags & 2);
 	}
 
-	// native String:str_new_static(const str[], str_create_mode:mode=str_preserve, size=sizeof(str));
-	AMX_DEFINE_NATIVE_TAG(str_new_static, 3, string)
+	static cell static_length(const cell *addr, cell size, bool &packed)
 	{
-		cell *addr = amx_GetAddrSafe(amx, params[1]);
-		int flags = params[2];
-		cell size = params[3];
-		if(size < 0) amx_LogicError(errors::out_of_range, "size");
-		if(size == 0) return strings::pool.get_id(strings::pool.add());
-		bool packed = static_cast<ucell>(*addr) > UNPACKEDMAX;
+		packed = static_cast<ucell>(*addr) > UNPACKEDMAX;
 		if(packed)
 		{
 			cell last = addr[size - 1];
@@ -109,9 +103,66 @@ namespace Natives
 			size -= 1;
 		}
 		if(size < 0) size = 0;
+		return size;
+	}
+
+	// Interned strings are shared by everyone who interned the same value, so they cannot be modified
+	static void check_mutable(cell id)
+	{
+		decltype(strings::pool)::ref_container *str;
+		if(strings::pool.get_by_id(id, str) && str->is_interned()) amx_LogicError(errors::operation_not_supported, "string");
+	}
+
+	// native String:str_new_static(const str[], str_create_mode:mode=str_preserve, size=sizeof(str));
+	AMX_DEFINE_NATIVE_TAG(str_new_static, 3, string)
+	{
+		cell *addr = amx_GetAddrSafe(amx, params[1]);
+		int flags = params[2];
+		cell size = params[3];
+		if(size < 0) amx_LogicError(errors::out_of_range, "size");
+		if(size == 0) return strings::pool.get_id(strings::pool.add());
+		bool packed;
+		size = static_length(addr, size, packed);
 		return strings::create(addr, size, packed, flags & 1, flags & 2);
 	}
 
+	// native ConstString:str_intern(const str[], str_create_mode:mode=str_preserve, size=sizeof(str));
+	AMX_DEFINE_NATIVE_TAG(str_intern, 3, string)
+	{
+		cell *addr = amx_GetAddrSafe(amx, params[1]);
+		int flags = params[2];
+		cell size = params[3];
+		if(size < 0) amx_LogicError(errors::out_of_range, "size");
+		if(size == 0) return strings::intern(cell_string());
+		bool packed;
+		size = static_length(addr, size, packed);
+		return strings::intern(addr, size, packed, flags & 1, flags & 2);
+	}
+
+	// native ConstString:str_intern_s(ConstStringTag:str);
+	AMX_DEFINE_NATIVE_TAG(str_intern_s, 1, string)
+	{
+		decltype(strings::pool)::ref_container *str;
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(str == nullptr)
+		{
+			return strings::intern(cell_string());
+		}
+		if(str->is_interned())
+		{
+			return params[1];
+		}
+		return strings::intern(cell_string(**str));
+	}
+
+	// native bool:str_is_interned(ConstStringTag:str);
+	AMX_DEFINE_NATIVE_TAG(str_is_interned, 1, bool)
+	{
+		decltype(strings::pool)::ref_container *str;
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		return str != nullptr && str->is_interned();
+	}
+
 	// native String:str_new_buf(size);
 	AMX_DEFINE_NATIVE_TAG(str_new_buf, 1, string)
 	{
@@ -124,7 +175,8 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_addr, 1, cell)
 	{
 		std::shared_ptr<decltype(strings::pool)::ref_container> str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		if(str == nullptr)
 		{
 			return strings::pool.get_null_address(amx);
@@ -137,7 +189,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_addr_const, 1, cell)
 	{
 		std::shared_ptr<decltype(strings::pool)::ref_container> str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr)
 		{
 			return strings::pool.get_null_address(amx);
@@ -151,6 +203,7 @@ namespace Natives
 	{
 		std::shared_ptr<decltype(strings::pool)::ref_container> str;
 		if(!strings::pool.get_by_id(params[1], str)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		if(str == nullptr)
 		{
 			amx_LogicError(errors::operation_not_supported, "string");
@@ -195,7 +248,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_clone, 1, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr)
 		{
 			return strings::pool.get_id(strings::pool.add());
@@ -208,8 +261,8 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_cat, 2, string)
 	{
 		cell_string *str1, *str2;
-		if((!strings::pool.get_by_id(params[1], str1) && str1 != nullptr)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
-		if((!strings::pool.get_by_id(params[2], str2) && str2 != nullptr)) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if((!strings::pool.get_by_id(params[1], str1) && params[1] != 0)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if((!strings::pool.get_by_id(params[2], str2) && params[2] != 0)) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 		
 		if(str1 == nullptr && str2 == nullptr)
 		{
@@ -259,7 +312,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_val_var, 1, string)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(!var)
 		{
 			return strings::pool.get_id(strings::pool.add());
@@ -322,7 +375,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_split, 2, list)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr)
 		{
 			return list_pool.get_id(list_pool.add());
@@ -335,9 +388,9 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_split_s, 2, list)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		cell_string *delims;
-		if(!strings::pool.get_by_id(params[2], delims) && delims != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], delims) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 		return strings::select_iterator<str_split_base>(delims, amx, str);
 	}
 
@@ -379,7 +432,7 @@ namespace Natives
 		list_t *list;
 		if(!list_pool.get_by_id(params[1], list)) amx_LogicError(errors::pointer_invalid, "list", params[1]);
 		cell_string *delim;
-		if(!strings::pool.get_by_id(params[1], delim) && delim != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[1], delim) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 		return strings::select_iterator<str_join_base>(delim, amx, list);
 	}
 
@@ -387,7 +440,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_len, 1, cell)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr) return 0;
 		return static_cast<cell>(str->size());
 	}
@@ -396,7 +449,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_capacity, 1, cell)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr) return 0;
 		return static_cast<cell>(str->capacity());
 	}
@@ -409,7 +462,7 @@ namespace Natives
 		cell *addr = amx_GetAddrSafe(amx, params[2]);
 
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		if(str == nullptr)
 		{
@@ -458,6 +511,7 @@ namespace Natives
 	{
 		cell_string *str;
 		if(!strings::pool.get_by_id(params[1], str)) return 0xFFFFFF00;
+		check_mutable(params[1]);
 
 		if(strings::clamp_pos(*str, params[2]))
 		{
@@ -473,8 +527,9 @@ namespace Natives
 	{
 		cell_string *str1;
 		if(!strings::pool.get_by_id(params[1], str1)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		cell_string *str2;
-		if(!strings::pool.get_by_id(params[2], str2) && str2 != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str2) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		if(str2 == nullptr)
 		{
@@ -490,8 +545,9 @@ namespace Natives
 	{
 		cell_string *str1;
 		if(!strings::pool.get_by_id(params[1], str1)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		cell_string *str2;
-		if(!strings::pool.get_by_id(params[2], str2) && str2 != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str2) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 		if(str2 != nullptr)
 		{
 			str1->append(*str2);
@@ -504,8 +560,9 @@ namespace Natives
 	{
 		cell_string *str1;
 		if(!strings::pool.get_by_id(params[1], str1)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		cell_string *str2;
-		if(!strings::pool.get_by_id(params[2], str2) && str2 != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str2) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 		if(str2 != nullptr)
 		{
 			strings::clamp_pos(*str1, params[3]);
@@ -519,6 +576,7 @@ namespace Natives
 	{
 		cell_string *str;
 		if(!strings::pool.get_by_id(params[1], str)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 
 		cell start = optparam(2, 0);
 		cell end = optparam(3, std::numeric_limits<cell>::max());
@@ -537,7 +595,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_sub, 1, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr) return strings::pool.get_id(strings::pool.add());
 
 		cell start = optparam(2, 0);
@@ -555,9 +613,9 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_cmp, 2, bool)
 	{
 		cell_string *str1;
-		if(!strings::pool.get_by_id(params[1], str1) && str1 != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str1) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		cell_string *str2;
-		if(!strings::pool.get_by_id(params[2], str2) && str2 != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str2) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		if(str1 == nullptr && str2 == nullptr) return 1;
 		if(str1 == nullptr)
@@ -575,7 +633,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_empty, 1, bool)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr) return 1;
 		return str->empty();
 	}
@@ -584,9 +642,9 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_eq, 2, bool)
 	{
 		cell_string *str1;
-		if(!strings::pool.get_by_id(params[1], str1) && str1 != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str1) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		cell_string *str2;
-		if(!strings::pool.get_by_id(params[2], str2) && str2 != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str2) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		if(str1 == nullptr && str2 == nullptr) return 1;
 		if(str1 == nullptr)
@@ -604,7 +662,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_findc, 2, cell)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr) return -1;
 
 		cell offset = optparam(3, 0);
@@ -616,7 +674,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_find, 2, cell)
 	{
 		cell_string *str1;
-		if(!strings::pool.get_by_id(params[1], str1) && str1 != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str1) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		cell_string *str2;
 		if(!strings::pool.get_by_id(params[2], str2)) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 		if(str1 == nullptr) return str2->empty() ? 0 : -1;
@@ -642,7 +700,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_count_chars, 2, cell)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr) return 0;
 
 		char *encoding;
@@ -660,7 +718,8 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_clear, 1, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		if(str != nullptr)
 		{
 			str->clear();
@@ -673,7 +732,8 @@ namespace Natives
 	{
 		if(params[2] < 0) amx_LogicError(errors::out_of_range, "size");
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && (params[2] != 0 || str != nullptr)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && (params[2] != 0 || params[1] != 0)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		if(str != nullptr)
 		{
 			str->resize(static_cast<size_t>(params[2]), optparam(3, 0));
@@ -686,7 +746,7 @@ namespace Natives
 	{
 		if(params[2] < 0) amx_LogicError(errors::out_of_range, "size");
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && (params[2] != 0 || str != nullptr)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && (params[2] != 0 || params[1] != 0)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str != nullptr)
 		{
 			str->reserve(static_cast<size_t>(params[2]));
@@ -708,7 +768,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_format_s, 1, string)
 	{
 		cell_string *strformat;
-		if(!strings::pool.get_by_id(params[1], strformat) && strformat != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], strformat) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		cell_string target;
 		if(strformat != nullptr)
 		{
@@ -722,6 +782,7 @@ namespace Natives
 	{
 		cell_string *str;
 		if(!strings::pool.get_by_id(params[1], str)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		
 		cell *format = amx_GetAddrSafe(amx, params[2]);
 
@@ -736,9 +797,10 @@ namespace Natives
 	{
 		cell_string *str;
 		if(!strings::pool.get_by_id(params[1], str)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		
 		cell_string *strformat;
-		if(!strings::pool.get_by_id(params[2], strformat) && strformat != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], strformat) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		cell_string buffer;
 		if(strformat != nullptr)
@@ -754,6 +816,7 @@ namespace Natives
 	{
 		cell_string *str;
 		if(!strings::pool.get_by_id(params[1], str)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		
 		cell *format = amx_GetAddrSafe(amx, params[2]);
 
@@ -766,9 +829,10 @@ namespace Natives
 	{
 		cell_string *str;
 		if(!strings::pool.get_by_id(params[1], str)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		
 		cell_string *strformat;
-		if(!strings::pool.get_by_id(params[2], strformat) && strformat != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], strformat) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 		if(strformat != nullptr)
 		{
 			strings::format(amx, *str, *strformat, params[0] / sizeof(cell) - 2, params + 3);
@@ -780,7 +844,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_to_lower, 1, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr)
 		{
 			return strings::pool.get_id(strings::pool.add());
@@ -798,7 +862,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_to_upper, 1, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr)
 		{
 			return strings::pool.get_id(strings::pool.add());
@@ -816,7 +880,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_convert, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr)
 		{
 			return strings::pool.get_id(strings::pool.add());
@@ -835,7 +899,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_collation_key, 1, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 		if(str == nullptr)
 		{
 			return strings::pool.get_id(strings::pool.add());
@@ -855,7 +919,8 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_set_to_lower, 1, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 
 		char *encoding;
 		amx_OptStrParam(amx, 2, encoding, nullptr);
@@ -871,7 +936,8 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_set_to_upper, 1, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 
 		char *encoding;
 		amx_OptStrParam(amx, 2, encoding, nullptr);
@@ -887,7 +953,8 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_set_convert, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 
 		char *from_encoding, *to_encoding;
 		amx_StrParam(amx, params[2], from_encoding);
@@ -906,7 +973,8 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_set_collation_key, 1, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 
 		bool is_primary = static_cast<bool>(optparam(2, 1));
 
@@ -925,7 +993,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_match, 2, bool)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[2]);
 
@@ -944,10 +1012,10 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_match_s, 2, bool)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[2], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], pattern) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		cell *pos = optparamref(3, 0);
 		cell options = optparam(4, 0);
@@ -965,7 +1033,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_extract, 2, list)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[2]);
 
@@ -984,10 +1052,10 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_extract_s, 2, list)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[2], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], pattern) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		cell *pos = optparamref(3, 0);
 		cell options = optparam(4, 0);
@@ -1005,7 +1073,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_replace, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[2]);
 
@@ -1028,13 +1096,13 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_replace_s, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[2], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], pattern) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		cell_string *replacement;
-		if(!strings::pool.get_by_id(params[3], replacement) && replacement != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[3]);
+		if(!strings::pool.get_by_id(params[3], replacement) && params[3] != 0) amx_LogicError(errors::pointer_invalid, "string", params[3]);
 
 		cell *pos = optparamref(4, 0);
 		cell options = optparam(5, 0);
@@ -1054,7 +1122,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_replace_list, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[2]);
 
@@ -1078,10 +1146,10 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_replace_list_s, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[2], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], pattern) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		list_t *replacement;
 		if(!list_pool.get_by_id(params[3], replacement)) amx_LogicError(errors::pointer_invalid, "list", params[3]);
@@ -1104,7 +1172,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_replace_func, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[2]);
 
@@ -1140,10 +1208,10 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_replace_func_s, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[2], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], pattern) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		const char *fname;
 		amx_StrParam(amx, params[3], fname);
@@ -1178,7 +1246,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_replace_expr, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[2]);
 
@@ -1202,10 +1270,10 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(str_replace_expr_s, 3, string)
 	{
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[1], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		if(!strings::pool.get_by_id(params[1], str) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "string", params[1]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[2], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], pattern) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		expression *expr;
 		if(!expression_pool.get_by_id(params[3], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[3]);
@@ -1229,9 +1297,10 @@ namespace Natives
 	{
 		cell_string *target;
 		if(!strings::pool.get_by_id(params[1], target)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[2], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[3]);
 
@@ -1262,15 +1331,16 @@ namespace Natives
 	{
 		cell_string *target;
 		if(!strings::pool.get_by_id(params[1], target)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[2], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[3], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[3]);
+		if(!strings::pool.get_by_id(params[3], pattern) && params[3] != 0) amx_LogicError(errors::pointer_invalid, "string", params[3]);
 
 		cell_string *replacement;
-		if(!strings::pool.get_by_id(params[4], replacement) && replacement != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[4]);
+		if(!strings::pool.get_by_id(params[4], replacement) && params[4] != 0) amx_LogicError(errors::pointer_invalid, "string", params[4]);
 
 		cell *pos = optparamref(5, 0);
 		cell options = optparam(6, 0);
@@ -1305,9 +1375,10 @@ namespace Natives
 	{
 		cell_string *target;
 		if(!strings::pool.get_by_id(params[1], target)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[2], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[3]);
 
@@ -1339,12 +1410,13 @@ namespace Natives
 	{
 		cell_string *target;
 		if(!strings::pool.get_by_id(params[1], target)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[2], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[3], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[3]);
+		if(!strings::pool.get_by_id(params[3], pattern) && params[3] != 0) amx_LogicError(errors::pointer_invalid, "string", params[3]);
 
 		list_t *replacement;
 		if(!list_pool.get_by_id(params[4], replacement)) amx_LogicError(errors::pointer_invalid, "list", params[4]);
@@ -1381,9 +1453,10 @@ namespace Natives
 	{
 		cell_string *target;
 		if(!strings::pool.get_by_id(params[1], target)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[2], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[3]);
 
@@ -1427,12 +1500,13 @@ namespace Natives
 	{
 		cell_string *target;
 		if(!strings::pool.get_by_id(params[1], target)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[2], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[3], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[3]);
+		if(!strings::pool.get_by_id(params[3], pattern) && params[3] != 0) amx_LogicError(errors::pointer_invalid, "string", params[3]);
 
 		const char *fname;
 		amx_StrParam(amx, params[4], fname);
@@ -1481,9 +1555,10 @@ namespace Natives
 	{
 		cell_string *target;
 		if(!strings::pool.get_by_id(params[1], target)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 		
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[2], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		cell *pattern = amx_GetAddrSafe(amx, params[3]);
 
@@ -1515,12 +1590,13 @@ namespace Natives
 	{
 		cell_string *target;
 		if(!strings::pool.get_by_id(params[1], target)) amx_LogicError(errors::pointer_invalid, "string", params[1]);
+		check_mutable(params[1]);
 
 		cell_string *str;
-		if(!strings::pool.get_by_id(params[2], str) && str != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[2]);
+		if(!strings::pool.get_by_id(params[2], str) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "string", params[2]);
 
 		std::shared_ptr<cell_string> pattern;
-		if(!strings::pool.get_by_id(params[3], pattern) && pattern != nullptr) amx_LogicError(errors::pointer_invalid, "string", params[3]);
+		if(!strings::pool.get_by_id(params[3], pattern) && params[3] != 0) amx_LogicError(errors::pointer_invalid, "string", params[3]);
 
 		expression *expr;
 		if(!expression_pool.get_by_id(params[4], expr)) amx_LogicError(errors::pointer_invalid, "expression", params[4]);
@@ -1560,6 +1636,9 @@ static AMX_NATIVE_INFO native_list[] =
 	AMX_DECLARE_NATIVE(str_new),
 	AMX_DECLARE_NATIVE(str_new_arr),
 	AMX_DECLARE_NATIVE(str_new_static),
+	AMX_DECLARE_NATIVE(str_intern),
+	AMX_DECLARE_NATIVE(str_intern_s),
+	AMX_DECLARE_NATIVE(str_is_interned),
 	AMX_DECLARE_NATIVE(str_new_buf),
 	AMX_DECLARE_NATIVE(str_addr),
 	AMX_DECLARE_NATIVE(str_addr_const),
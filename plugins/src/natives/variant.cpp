@@ -79,7 +79,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_addr, 1, cell)
 	{
 		std::shared_ptr<decltype(variants::pool)::ref_container> var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return variants::pool.get_null_address(amx);
@@ -96,7 +96,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_addr_const, 1, cell)
 	{
 		std::shared_ptr<decltype(variants::pool)::ref_container> var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return variants::pool.get_null_address(amx);
@@ -154,7 +154,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_clone, 1, variant)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return 0;
@@ -334,7 +334,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_tagof, 1, cell)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return 0x80000000;
@@ -346,7 +346,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_tag_uid, 1, cell)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return tags::tag_cell;
@@ -358,7 +358,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_sizeof, 1, cell)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return 0;
@@ -380,7 +380,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_rank, 1, cell)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		return var == nullptr ? -1 : var->get_rank();
 	}
 	
@@ -389,9 +389,9 @@ namespace Natives
 	static cell AMX_NATIVE_CALL var_bin_op(AMX *amx, cell *params)
 	{
 		dyn_object *var1;
-		if(!variants::pool.get_by_id(params[1], var1) && var1 != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var1) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		dyn_object *var2;
-		if(!variants::pool.get_by_id(params[2], var2) && var2 != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[2]);
+		if(!variants::pool.get_by_id(params[2], var2) && params[2] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[2]);
 		if(var1 == nullptr || var2 == nullptr)
 		{
 			return 0;
@@ -435,7 +435,7 @@ namespace Natives
 	static cell AMX_NATIVE_CALL var_un_op(AMX *amx, cell *params)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return 0;
@@ -467,8 +467,8 @@ namespace Natives
 	static cell AMX_NATIVE_CALL var_log_op(AMX *amx, cell *params)
 	{
 		dyn_object *var1, *var2;
-		if((!variants::pool.get_by_id(params[1], var1) && var1 != nullptr)) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
-		if((!variants::pool.get_by_id(params[2], var2) && var2 != nullptr)) amx_LogicError(errors::pointer_invalid, "variant", params[2]);
+		if((!variants::pool.get_by_id(params[1], var1) && params[1] != 0)) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if((!variants::pool.get_by_id(params[2], var2) && params[2] != 0)) amx_LogicError(errors::pointer_invalid, "variant", params[2]);
 		bool init1 = false, init2 = false;
 		if(var1 == nullptr)
 		{
@@ -532,7 +532,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_not, 1, bool)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return true;
@@ -544,7 +544,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_call_op, 2, variant)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return 0;
@@ -565,7 +565,7 @@ namespace Natives
 	AMX_DEFINE_NATIVE_TAG(var_call_op_raw, 2, variant)
 	{
 		dyn_object *var;
-		if(!variants::pool.get_by_id(params[1], var) && var != nullptr) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
+		if(!variants::pool.get_by_id(params[1], var) && params[1] != 0) amx_LogicError(errors::pointer_invalid, "variant", params[1]);
 		if(var == nullptr)
 		{
 			return 0;
@@ -5,6 +5,7 @@
 #include "modules/tag_ops.h"
 #include "modules/containers.h"
 #include "../fixes/linux.h"
+#include "utils/cell_hash.h"
 #include <cmath>
 #include <string>
 #include <cstring>
@@ -17,6 +18,27 @@ bool memequal(void const* ptr1, void const* ptr2, size_t size)
 	return !std::memcmp(ptr1, ptr2, size);
 }
 
+cell *dyn_object::alloc_array(cell size)
+{
+	if(size <= inline_size)
+	{
+		inline_array = true;
+		return inline_data;
+	}
+	inline_array = false;
+	array_data = new cell[size];
+	return array_data;
+}
+
+void dyn_object::free_array() noexcept
+{
+	if(!inline_array)
+	{
+		delete[] array_data;
+	}
+	inline_array = false;
+}
+
 dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell tag_id) : rank(1), tag(tags::find_tag(amx, tag_id))
 {
 	if(size < 0)
@@ -25,13 +47,13 @@ dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell tag_id) : rank
 	}
 	if(arr != nullptr)
 	{
-		array_data = new cell[size + 2];
-		std::memcpy(array_data + 1, arr, size * sizeof(cell));
-		array_data[size + 1] = 0;
+		alloc_array(size + 2);
+		std::memcpy(array_ptr() + 1, arr, size * sizeof(cell));
+		array_ptr()[size + 1] = 0;
 	}else{
-		array_data = new cell[size + 2]();
+		std::fill_n(alloc_array(size + 2), size + 2, 0);
 	}
-	array_data[0] = size + 1;
+	array_ptr()[0] = size + 1;
 	init_op();
 }
 
@@ -101,18 +123,18 @@ dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, tag_ptr
 			find_array_end(amx, last);
 		}
 		cell length = last - arr;
-		array_data = new cell[length + 2];
-		std::memcpy(array_data + 1, arr, length * sizeof(cell));
-		array_data[length + 1] = 0;
-		array_data[0] = length + 1;
+		alloc_array(length + 2);
+		std::memcpy(array_ptr() + 1, arr, length * sizeof(cell));
+		array_ptr()[length + 1] = 0;
+		array_ptr()[0] = length + 1;
 	}else{
 		cell length = size + size * size2;
-		array_data = new cell[length + 2]();
+		std::fill_n(alloc_array(length + 2), length + 2, 0);
 		for(cell i = 0; i < size; i++)
 		{
-			array_data[1 + i] = (size + i * size2 - i) * sizeof(cell);
+			array_ptr()[1 + i] = (size + i * size2 - i) * sizeof(cell);
 		}
-		array_data[0] = length + 1;
+		array_ptr()[0] = length + 1;
 	}
 	init_op();
 }
@@ -150,23 +172,23 @@ dyn_object::dyn_object(AMX *amx, const cell *arr, cell size, cell size2, cell si
 			find_array_end(amx, last);
 		}
 		cell length = last - arr;
-		array_data = new cell[length + 2];
-		std::memcpy(array_data + 1, arr, length * sizeof(cell));
-		array_data[length + 1] = 0;
-		array_data[0] = length + 1;
+		alloc_array(length + 2);
+		std::memcpy(array_ptr() + 1, arr, length * sizeof(cell));
+		array_ptr()[length + 1] = 0;
+		array_ptr()[0] = length + 1;
 	}else{
 		cell length = size + size * size2 + size * size2 * size3;
-		array_data = new cell[length + 2]();
+		std::fill_n(alloc_array(length + 2), length + 2, 0);
 		for(cell i = 0; i < size; i++)
 		{
-			array_data[1 + i] = (size + i * size2 - i) * sizeof(cell);
+			array_ptr()[1 + i] = (size + i * size2 - i) * sizeof(cell);
 			for(cell j = 0; j < size2; j++)
 			{
 				cell ofs = size + i * size + j;
-				array_data[1 + ofs] = (size + size * size2 + i * size2 * size3 + j * size2 - ofs) * sizeof(cell);
+				array_ptr()[1 + ofs] = (size + size * size2 + i * size2 * size3 + j * size2 - ofs) * sizeof(cell);
 			}
 		}
-		array_data[0] = length + 1;
+		array_ptr()[0] = length + 1;
 	}
 	init_op();
 }
@@ -175,23 +197,16 @@ dyn_object::dyn_object(const cell *str) : rank(1), tag(tags::find_tag(tags::tag_
 {
 	if(str == nullptr || !str[0])
 	{
-		array_data = new cell[3]{2, 0, 0};
+		std::fill_n(alloc_array(3), 3, 0);
+		array_ptr()[0] = 2;
 		return;
 	}
-	int len;
-	amx_StrLen(str, &len);
-	size_t size;
-	if(str[0] & 0xFF000000)
-	{
-		size = 1 + ((len - 1) / sizeof(cell));
-	}else{
-		size = len;
-	}
-	array_data = new cell[size + 3];
-	array_data[0] = size + 2;
-	std::memcpy(array_data + 1, str, size * sizeof(cell));
-	array_data[size + 2] = 0;
-	array_data[size + 1] = 0;
+	cell size = string_size(str);
+	alloc_array(size + 3);
+	array_ptr()[0] = size + 2;
+	std::memcpy(array_ptr() + 1, str, size * sizeof(cell));
+	array_ptr()[size + 2] = 0;
+	array_ptr()[size + 1] = 0;
 }
 
 dyn_object::dyn_object(cell value, tag_ptr tag, bool assign) noexcept : rank(0), cell_value(value), tag(tag)
@@ -206,13 +221,13 @@ dyn_object::dyn_object(const cell *arr, cell size, tag_ptr tag) : rank(1), tag(t
 {
 	if(arr != nullptr)
 	{
-		array_data = new cell[size + 2];
-		std::memcpy(array_data + 1, arr, size * sizeof(cell));
-		array_data[size + 1] = 0;
+		alloc_array(size + 2);
+		std::memcpy(array_ptr() + 1, arr, size * sizeof(cell));
+		array_ptr()[size + 1] = 0;
 	}else{
-		array_data = new cell[size + 2]();
+		std::fill_n(alloc_array(size + 2), size + 2, 0);
 	}
-	array_data[0] = size + 1;
+	array_ptr()[0] = size + 1;
 	init_op();
 }
 
@@ -220,12 +235,12 @@ dyn_object::dyn_object(const dyn_object &obj, bool assign) : rank(obj.rank), tag
 {
 	if(rank > 0)
 	{
-		if(obj.array_data != nullptr)
+		if(obj.array_ptr() != nullptr)
 		{
 			cell size = obj.data_size();
-			array_data = new cell[size + 1];
-			std::memcpy(array_data, obj.array_data, size * sizeof(cell));
-			array_data[size] = 0;
+			alloc_array(size + 1);
+			std::memcpy(array_ptr(), obj.array_ptr(), size * sizeof(cell));
+			array_ptr()[size] = 0;
 		}else{
 			array_data = nullptr;
 		}
@@ -254,7 +269,7 @@ cell dyn_object::data_size() const
 		case 0:
 			return 1;
 		default:
-			return array_data == nullptr ? 0 : array_data[0];
+			return array_ptr() == nullptr ? 0 : array_ptr()[0];
 	}
 }
 
@@ -264,14 +279,14 @@ cell dyn_object::array_start() const
 	{
 		return 0;
 	}else{
-		cell *b = array_data + 1;
+		const cell *b = array_ptr() + 1;
 		auto dim = rank;
 		while(dim > 1)
 		{
-			b = (cell*)((char*)b + *b);
+			b = (const cell*)((const char*)b + *b);
 			dim--;
 		}
-		return b - array_data;
+		return b - array_ptr();
 	}
 }
 
@@ -355,7 +370,7 @@ const cell *dyn_object::get_array(const cell *indices, cell num_indices, cell &s
 			}
 		}
 
-		block = array_data + 1;
+		block = array_ptr() + 1;
 		cell data_begin = this->begin() - block, data_end = this->end() - block;
 		begin = 0;
 		end = rank >= 2 ? block[0] / sizeof(cell) : data_end;
@@ -428,7 +443,7 @@ const cell *dyn_object::get_cell_addr(const cell *indices, cell num_indices) con
 		return nullptr;
 	}
 
-	const cell *block = array_data + 1;
+	const cell *block = array_ptr() + 1;
 	cell data_begin = begin() - block, data_end = end() - block;
 	cell begin = 0, end = rank >= 2 ? block[0] / sizeof(cell) : data_end;
 	for(cell i = 0; i < num_indices; i++)
@@ -500,7 +515,7 @@ cell dyn_object::store(AMX *amx) const
 		cell size = data_size() - 1;
 		cell amx_addr, *addr;
 		amx_AllotSafe(amx, size, &amx_addr, &addr);
-		std::memcpy(addr, array_data + 1, size * sizeof(cell));
+		std::memcpy(addr, array_ptr() + 1, size * sizeof(cell));
 
 		cell begin = array_start() - 1;
 		assign_op(addr + begin, size - begin);
@@ -514,7 +529,7 @@ void dyn_object::load(AMX *amx, cell amx_addr)
 	{
 		cell size = data_size() - 1;
 		cell *addr = amx_GetAddrSafe(amx, amx_addr);
-		std::memcpy(array_data + 1, addr, size * sizeof(cell));
+		std::memcpy(array_ptr() + 1, addr, size * sizeof(cell));
 
 		assign_op();
 	}
@@ -531,7 +546,7 @@ cell *dyn_object::begin()
 	{
 		return &cell_value;
 	}else{
-		return &array_data[array_start()];
+		return &array_ptr()[array_start()];
 	}
 }
 
@@ -541,7 +556,7 @@ cell *dyn_object::end()
 	{
 		return &cell_value + 1;
 	}else{
-		return array_data + data_size();
+		return array_ptr() + data_size();
 	}
 }
 
@@ -551,7 +566,7 @@ cell *dyn_object::data_begin()
 	{
 		return &cell_value;
 	}else{
-		return array_data + 1;
+		return array_ptr() + 1;
 	}
 }
 
@@ -561,7 +576,7 @@ const cell *dyn_object::begin() const
 	{
 		return &cell_value;
 	}else{
-		return &array_data[array_start()];
+		return &array_ptr()[array_start()];
 	}
 }
 
@@ -571,7 +586,7 @@ const cell *dyn_object::end() const
 	{
 		return &cell_value + 1;
 	}else{
-		return array_data + data_size();
+		return array_ptr() + data_size();
 	}
 }
 
@@ -581,7 +596,7 @@ const cell *dyn_object::data_begin() const
 	{
 		return &cell_value;
 	}else{
-		return array_data + 1;
+		return array_ptr() + 1;
 	}
 }
 
@@ -595,6 +610,15 @@ cell dyn_object::array_size() const
 	}
 }
 
+size_t dyn_object::buffer_size() const
+{
+	if(is_array() && !inline_array)
+	{
+		return (data_size() + 1) * sizeof(cell);
+	}
+	return 0;
+}
+
 cell dyn_object::get_size(const cell *indices, cell num_indices) const
 {
 	if(is_cell())
@@ -615,7 +639,7 @@ cell dyn_object::get_size(const cell *indices, cell num_indices) const
 		}
 	}
 
-	const cell *block = array_data + 1;
+	const cell *block = array_ptr() + 1;
 	cell data_begin = begin() - block, data_end = end() - block;
 	cell begin = 0, end = rank >= 2 ? block[0] / sizeof(cell) : data_end;
 	bool cells = false;
@@ -640,26 +664,57 @@ cell dyn_object::get_size(const cell *indices, cell num_indices) const
 	return end - begin;
 }
 
-template <class T>
-inline void hash_combine(size_t& seed, const T& v)
-{
-	std::hash<T> hasher;
-	seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-}
+using aux::hash_combine;
 
 size_t dyn_object::get_hash() const
 {
 	size_t hash = 0;
 	if(empty()) return 0;
 
-	const tag_operations &ops = tag->get_ops();
-	for(auto it = begin(); it != end(); it++)
+	hash = tag->get_ops().hash(tag, begin(), end() - begin());
+	hash_combine(hash, tag->find_top_base());
+	return hash;
+}
+
+// The same as get_hash, for the operations of cell and char
+size_t dyn_object::hash_cell(cell value)
+{
+	size_t hash = aux::hash_cells(&value, 1);
+	hash_combine(hash, tags::find_tag(tags::tag_cell)->find_top_base());
+	return hash;
+}
+
+size_t dyn_object::hash_string(const cell *str, cell size)
+{
+	aux::cell_hasher hasher;
+	hasher.add(str, size);
+	hasher.add(cell(0));
+	size_t hash = hasher.finish();
+	hash_combine(hash, tags::find_tag(tags::tag_char)->find_top_base());
+	return hash;
+}
+
+// Number of cells a string occupies, without the terminating cell
+cell dyn_object::string_size(const cell *str)
+{
+	if(str == nullptr || !str[0])
 	{
-		hash_combine(hash, ops.hash(tag, *it));
+		return 0;
 	}
+	int len;
+	amx_StrLen(str, &len);
+	if(str[0] & 0xFF000000)
+	{
+		return 1 + ((len - 1) / sizeof(cell));
+	}
+	return len;
+}
 
-	hash_combine(hash, tag->find_top_base());
-	return hash;
+bool dyn_object::plain_tag(tag_ptr tag)
+{
+	// tags without their own operations use the ones of their base
+	static const tag_operations &cell_ops = tags::find_tag(tags::tag_cell)->get_ops();
+	return &tag->get_ops() == &cell_ops;
 }
 
 void dyn_object::acquire() const
@@ -725,6 +780,27 @@ dyn_object dyn_object::clone() const
 	return copy;
 }
 
+bool dyn_object::clone_is_copy() const
+{
+	if(empty())
+	{
+		return true;
+	}
+	// only the built-in value tags are known to clone cells to themselves
+	switch(tag->uid)
+	{
+		case tags::tag_cell:
+		case tags::tag_bool:
+		case tags::tag_char:
+		case tags::tag_float:
+		case tags::tag_signed:
+		case tags::tag_unsigned:
+			return true;
+		default:
+			return false;
+	}
+}
+
 dyn_object dyn_object::call_op(op_type type, cell *args, size_t numargs, bool wrap) const
 {
 	dyn_object result = dyn_object(*this, false);
@@ -802,7 +878,7 @@ bool dyn_object::struct_compatible(const dyn_object &obj) const noexcept
 	{
 		cell ofs = array_start();
 		if(ofs != obj.array_start()) return false;
-		if(!memequal(array_data, obj.array_data, ofs * sizeof(cell))) return false;
+		if(!memequal(array_ptr(), obj.array_ptr(), ofs * sizeof(cell))) return false;
 	}
 	return true;
 }
@@ -1199,18 +1275,18 @@ dyn_object &dyn_object::operator=(const dyn_object &obj)
 	collect_op();
 	if(is_array())
 	{
-		delete[] array_data;
+		free_array();
 	}
 	rank = obj.rank;
 	tag = obj.tag;
 	if(rank > 0)
 	{
-		if(obj.array_data != nullptr)
+		if(obj.array_ptr() != nullptr)
 		{
 			cell size = obj.data_size();
-			array_data = new cell[size + 1];
-			std::memcpy(array_data, obj.array_data, size * sizeof(cell));
-			array_data[size] = 0;
+			alloc_array(size + 1);
+			std::memcpy(array_ptr(), obj.array_ptr(), size * sizeof(cell));
+			array_ptr()[size] = 0;
 		}else{
 			array_data = nullptr;
 		}
@@ -1227,17 +1303,11 @@ dyn_object &dyn_object::operator=(dyn_object &&obj) noexcept
 	collect_op();
 	if(is_array())
 	{
-		delete[] array_data;
+		free_array();
 	}
 	rank = obj.rank;
 	tag = obj.tag;
-	if(rank > 0)
-	{
-		array_data = obj.array_data;
-	}else{
-		cell_value = obj.cell_value;
-	}
-	obj.array_data = nullptr;
+	take_value(obj);
 	obj.rank = 1;
 	return *this;
 }
@@ -1246,24 +1316,9 @@ void dyn_object::swap(dyn_object &other) noexcept
 {
 	if(this != &other)
 	{
-		if(is_cell())
-		{
-			if(other.is_cell())
-			{
-				std::swap(cell_value, other.cell_value);
-			}else{
-				cell c = cell_value;
-				array_data = other.array_data;
-				other.cell_value = c;
-			}
-		}else if(other.is_cell())
-		{
-			cell c = other.cell_value;
-			other.array_data = array_data;
-			cell_value = c;
-		}else{
-			std::swap(array_data, other.array_data);
-		}
+		// nothing points into the objects, so the cell or the array can be swapped as raw storage
+		std::swap(inline_data, other.inline_data);
+		std::swap(inline_array, other.inline_array);
 		std::swap(rank, other.rank);
 		std::swap(tag, other.tag);
 	}
@@ -1275,13 +1330,26 @@ dyn_object::~dyn_object()
 	{
 		if(is_array())
 		{
+			cell *data = array_ptr();
 			cell *begin = this->begin();
 			cell *end = this->end();
-			cell *data = array_data;
+			bool heap = !inline_array;
+			// the inline array is overwritten by the null pointer, so the cells are collected from a copy
+			cell local[inline_size];
+			if(!heap)
+			{
+				std::memcpy(local, inline_data, sizeof(local));
+				begin = local + (begin - data);
+				end = local + (end - data);
+			}
 			rank = 1;
+			inline_array = false;
 			array_data = nullptr;
 			collect_op(begin, end - begin);
-			delete[] data;
+			if(heap)
+			{
+				delete[] data;
+			}
 		}else{
 			cell value = cell_value;
 			rank = 1;
@@ -9,10 +9,15 @@
 
 class dyn_object
 {
+	// small arrays (including the header and the terminating cell) are stored in place of the pointer
+	static constexpr cell inline_size = 4;
+
 	unsigned char rank;
+	bool inline_array = false;
 	union{
 		cell cell_value;
 		cell *array_data;
+		cell inline_data[inline_size];
 	};
 	tag_ptr tag;
 
@@ -53,13 +58,7 @@ public:
 
 	dyn_object(dyn_object &&obj) noexcept : rank(obj.rank), tag(obj.tag)
 	{
-		if(rank > 0)
-		{
-			array_data = obj.array_data;
-		}else{
-			cell_value = obj.cell_value;
-		}
-		obj.array_data = nullptr;
+		take_value(obj);
 		obj.rank = 1;
 	}
 
@@ -79,11 +78,17 @@ public:
 	cell array_start() const;
 	cell data_size() const;
 	cell array_size() const;
+	size_t buffer_size() const;
 	size_t get_hash() const;
+	static size_t hash_cell(cell value);
+	static size_t hash_string(const cell *str, cell size);
+	static cell string_size(const cell *str);
+	static bool plain_tag(tag_ptr tag);
 	void acquire() const;
 	void release() const;
 	std::weak_ptr<const void> handle() const;
 	dyn_object clone() const;
+	bool clone_is_copy() const;
 	dyn_object call_op(op_type type, cell *args, size_t numargs, bool wrap) const;
 
 	bool tag_assignable(AMX *amx, cell tag_id) const
@@ -133,17 +138,17 @@ public:
 
 	bool empty() const
 	{
-		return rank > 0 ? array_data == nullptr || *array_data <= 1 : false;
+		return rank > 0 ? array_ptr() == nullptr || *array_ptr() <= 1 : false;
 	}
 
 	bool is_null() const
 	{
-		return rank > 0 && array_data == nullptr;
+		return rank > 0 && array_ptr() == nullptr;
 	}
 
 	bool is_array() const
 	{
-		return rank > 0 && array_data != nullptr;
+		return rank > 0 && array_ptr() != nullptr;
 	}
 
 	bool is_cell() const
@@ -158,6 +163,23 @@ public:
 
 	cell get_specifier() const;
 
+	// Compares the cells directly; only valid if the tags are known to compare by value
+	bool cell_equals(cell value) const
+	{
+		return rank == 0 && cell_value == value;
+	}
+
+	// Cells of a plain tag are compared only by their values
+	bool is_plain_cell(tag_ptr tag) const
+	{
+		return rank == 0 && this->tag == tag;
+	}
+
+	bool string_equals(const cell *str, cell size) const
+	{
+		return rank == 1 && array_ptr() != nullptr && array_ptr()[0] == size + 2 && array_ptr()[size + 1] == 0 && !std::memcmp(array_ptr() + 1, str, size * sizeof(cell));
+	}
+
 	cell &operator[](cell index)
 	{
 		return begin()[index];
@@ -206,6 +228,28 @@ public:
 	~dyn_object();
 
 private:
+	cell *alloc_array(cell size);
+	void free_array() noexcept;
+
+	cell *array_ptr() noexcept
+	{
+		return inline_array ? inline_data : array_data;
+	}
+
+	const cell *array_ptr() const noexcept
+	{
+		return inline_array ? inline_data : array_data;
+	}
+
+	// Moves the cell or the array of another object here; the other object is left with a null array
+	void take_value(dyn_object &obj) noexcept
+	{
+		std::memcpy(inline_data, obj.inline_data, sizeof(inline_data));
+		inline_array = obj.inline_array;
+		obj.inline_array = false;
+		obj.array_data = nullptr;
+	}
+
 	dyn_object(cell value, tag_ptr tag, bool assign) noexcept;
 	dyn_object(const dyn_object &obj, bool assign);
 	bool init_op();
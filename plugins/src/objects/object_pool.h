@@ -2,10 +2,11 @@
 #define OBJECT_POOL_H_INCLUDED
 
 #include "main.h"
-#include "utils/shared_id_set_pool.h"
+#include "utils/slot_map_pool.h"
+#include "utils/region_allocator.h"
 #include "sdk/amx/amx.h"
 #include <vector>
-#include <unordered_map>
+#include <cstdint>
 #include <type_traits>
 #include <memory>
 
@@ -13,10 +14,19 @@ template <class ObjType>
 class object_pool
 {
 public:
-	class ref_container_simple
+	class ref_container_simple : public aux::slot_map_hook
 	{
+		friend class object_pool<ObjType>;
+
 		ObjType object;
 		unsigned int ref_count = 0;
+		bool global = false;
+		bool in_region = false;
+		bool pinned = false;
+		bool interned = false;
+		object_pool<ObjType> *cache_owner = nullptr;
+		const void *cache_addr = nullptr;
+		size_t interned_hash = 0;
 
 	public:
 		ref_container_simple() = default;
@@ -44,6 +54,14 @@ public:
 			obj.ref_count = -1;
 		}
 
+		~ref_container_simple()
+		{
+			if(cache_owner)
+			{
+				cache_owner->remove_cache(*this);
+			}
+		}
+
 		ObjType *operator->()
 		{
 			return &object;
@@ -117,11 +135,34 @@ public:
 		{
 			return ref_count == 0;
 		}
+
+		// Interned objects are shared by everyone who requested the same value, so they must not be modified
+		void set_interned(size_t hash)
+		{
+			interned = true;
+			interned_hash = hash;
+		}
+
+		bool is_interned() const
+		{
+			return interned;
+		}
+
+		size_t get_interned_hash() const
+		{
+			return interned_hash;
+		}
 	};
 
-	class ref_container_virtual
+	class ref_container_virtual : public aux::slot_map_hook
 	{
+		friend class object_pool<ObjType>;
+
 		unsigned int ref_count = 0;
+		bool global = false;
+		bool pinned = false;
+		object_pool<ObjType> *cache_owner = nullptr;
+		const void *cache_addr = nullptr;
 
 	public:
 		ref_container_virtual()
@@ -192,7 +233,13 @@ public:
 			return *this;
 		}
 
-		virtual ~ref_container_virtual() = default;
+		virtual ~ref_container_virtual()
+		{
+			if(cache_owner)
+			{
+				cache_owner->remove_cache(*this);
+			}
+		}
 
 		bool acquire()
 		{
@@ -221,49 +268,233 @@ public:
 	typedef decltype(&static_cast<ObjType*>(nullptr)->operator[](0)) inner_ptr;
 	typedef decltype(&static_cast<const ObjType*>(nullptr)->operator[](0)) const_inner_ptr;
 
-	typedef aux::shared_id_set_pool<ref_container> list_type;
+	typedef aux::slot_map_pool<ref_container> list_type;
 
 private:
-	list_type global_object_list;
-	list_type local_object_list;
-	std::unordered_map<const_inner_ptr, std::pair<std::weak_ptr<ref_container>, cell>> inner_cache;
+	aux::region local_region;
+	list_type object_list;
+	std::vector<cell> local_ids;
+	size_t local_count = 0;
+	// global objects still in the region, because something else referred to them when they were acquired
+	std::vector<cell> unpromoted_ids;
+	std::vector<std::shared_ptr<ref_container>> pending;
+	// objects released while collecting are added to pending instead of waiting for the next tick
+	bool collecting = false;
+
+	// Maps the addresses of buffers passed to the AMX to their objects.
+	// A cached object points back to the pool and removes its entry when destroyed, so the entries never dangle.
+	struct cache_entry
+	{
+		const void *addr;
+		ref_container *obj;
+		cell options;
+	};
+	std::vector<cache_entry> cache_table;
+	size_t cache_count = 0;
+
+	size_t cache_bucket(const void *addr) const
+	{
+		return static_cast<size_t>((reinterpret_cast<uintptr_t>(addr) / sizeof(cell)) * 2654435761u) & (cache_table.size() - 1);
+	}
+
+	const cache_entry *find_entry(const void *addr) const
+	{
+		if(cache_count == 0)
+		{
+			return nullptr;
+		}
+		size_t mask = cache_table.size() - 1;
+		for(size_t i = cache_bucket(addr); ; i = (i + 1) & mask)
+		{
+			const cache_entry &entry = cache_table[i];
+			if(!entry.obj)
+			{
+				return nullptr;
+			}
+			if(entry.addr == addr)
+			{
+				return &entry;
+			}
+		}
+	}
+
+	void insert_entry(const void *addr, ref_container *obj, cell options)
+	{
+		if((cache_count + 1) * 2 > cache_table.size())
+		{
+			auto old_table = std::move(cache_table);
+			cache_table.assign(old_table.empty() ? 16 : old_table.size() * 2, cache_entry{nullptr, nullptr, 0});
+			cache_count = 0;
+			for(const auto &entry : old_table)
+			{
+				if(entry.obj)
+				{
+					insert_entry(entry.addr, entry.obj, entry.options);
+				}
+			}
+		}
+		size_t mask = cache_table.size() - 1;
+		for(size_t i = cache_bucket(addr); ; i = (i + 1) & mask)
+		{
+			cache_entry &entry = cache_table[i];
+			if(!entry.obj)
+			{
+				entry = cache_entry{addr, obj, options};
+				++cache_count;
+				return;
+			}
+			if(entry.addr == addr)
+			{
+				if(entry.obj != obj)
+				{
+					entry.obj->cache_owner = nullptr;
+				}
+				entry.obj = obj;
+				entry.options = options;
+				return;
+			}
+		}
+	}
+
+	void remove_cache(ref_container &obj)
+	{
+		obj.cache_owner = nullptr;
+		auto entry = find_entry(obj.cache_addr);
+		if(!entry || entry->obj != &obj)
+		{
+			return;
+		}
+		size_t mask = cache_table.size() - 1;
+		size_t i = entry - cache_table.data();
+		size_t j = i;
+		while(true)
+		{
+			j = (j + 1) & mask;
+			const cache_entry &next = cache_table[j];
+			if(!next.obj)
+			{
+				break;
+			}
+			size_t k = cache_bucket(next.addr);
+			if(i <= j ? (i < k && k <= j) : (i < k || k <= j))
+			{
+				continue;
+			}
+			cache_table[i] = next;
+			i = j;
+		}
+		cache_table[i] = cache_entry{nullptr, nullptr, 0};
+		--cache_count;
+	}
+
+	void clear_cache()
+	{
+		for(const auto &entry : cache_table)
+		{
+			if(entry.obj)
+			{
+				entry.obj->cache_owner = nullptr;
+			}
+		}
+		cache_table.clear();
+		cache_count = 0;
+	}
+
+	object_ptr add_local(const std::shared_ptr<ref_container> &obj)
+	{
+		local_ids.push_back(object_list.get_id(obj));
+		++local_count;
+		return *obj;
+	}
+
+	// New objects are allocated in the region, since most of them are freed by the next collection
+	template <class... Args>
+	std::shared_ptr<ref_container> make_local(Args &&...args)
+	{
+		auto ptr = std::allocate_shared<ref_container>(aux::region_allocator<ref_container>(local_region), std::forward<Args>(args)...);
+		ptr->in_region = true;
+		return ptr;
+	}
+
+	// Moves an object out of the region, if nothing else refers to it and its address is not used.
+	// Returns false if it has to stay in the region for now.
+	template <class Container>
+	bool promote(Container &obj, std::true_type)
+	{
+		if(obj.in_region && !obj.pinned)
+		{
+			if(obj.cache_owner)
+			{
+				return false;
+			}
+			auto ptr = object_list.get(&obj);
+			if(ptr.use_count() != 2)
+			{
+				return false;
+			}
+			auto moved = std::make_shared<ref_container>(std::move(obj));
+			moved->global = obj.global;
+			object_list.replace(&obj, std::move(moved));
+		}
+		return true;
+	}
+
+	template <class Container>
+	bool promote(Container &obj, std::false_type)
+	{
+		return true;
+	}
+
+	// Global objects that outlive the tick are moved out of the region once nothing refers to them,
+	// so that they don't keep their chunks alive
+	void promote_later()
+	{
+		auto ids = std::move(unpromoted_ids);
+		unpromoted_ids.clear();
+		for(cell id : ids)
+		{
+			ref_container *obj;
+			if(object_list.get_by_id(id, obj) && obj->global && !obj->pinned)
+			{
+				if(!promote(*obj, std::is_same<ref_container, ref_container_simple>()))
+				{
+					unpromoted_ids.push_back(id);
+				}
+			}
+		}
+	}
 
 public:
 	object_ptr add()
 	{
-		return *local_object_list.add();
+		return add_local(object_list.add(make_local()));
 	}
 
 	object_ptr add(ObjType &&obj)
 	{
-		return *local_object_list.emplace(std::move(obj));
+		return add_local(object_list.add(make_local(std::move(obj))));
 	}
 
 	object_ptr add(ref_container &&obj)
 	{
-		return *local_object_list.add(std::move(obj));
+		return add_local(object_list.add(make_local(std::move(obj))));
 	}
 
 	object_ptr add(std::shared_ptr<ref_container> &&obj)
 	{
-		return *local_object_list.add(std::move(obj));
+		return add_local(object_list.add(std::move(obj)));
 	}
 
-	/*object_ptr add(std::unique_ptr<ref_container> &&obj)
-	{
-		return *local_object_list.add(std::move(obj));
-	}*/
-
 	template <class... Args>
 	object_ptr emplace(Args &&...args)
 	{
-		return *local_object_list.emplace(std::forward<Args>(args)...);
+		return add_local(object_list.add(make_local(std::forward<Args>(args)...)));
 	}
 
 	template <class Type, class... Args>
 	object_ptr emplace_derived(Args &&...args)
 	{
-		return *local_object_list.template emplace_derived<Type>(std::forward<Args>(args)...);
+		return add_local(object_list.template emplace_derived<Type>(std::forward<Args>(args)...));
 	}
 
 	cell get_relative_address(AMX *amx, const_object_ptr obj) const
@@ -293,13 +524,13 @@ public:
 		bool local = obj.local();
 		if(obj.acquire())
 		{
-			if(local)
+			if(local && !obj.global && object_list.contains(&obj))
 			{
-				auto it = local_object_list.find(&obj);
-				if(it != local_object_list.end())
+				obj.global = true;
+				--local_count;
+				if(!promote(obj, std::is_same<ref_container, ref_container_simple>()))
 				{
-					auto ptr = local_object_list.extract(it);
-					global_object_list.add(std::move(ptr));
+					unpromoted_ids.push_back(object_list.get_id(&obj));
 				}
 			}
 			return true;
@@ -311,13 +542,19 @@ public:
 	{
 		if(obj.release())
 		{
-			if(obj.local())
+			if(obj.local() && obj.global && object_list.contains(&obj))
 			{
-				auto it = global_object_list.find(&obj);
-				if(it != global_object_list.end())
+				obj.global = false;
+				if(collecting)
 				{
-					auto ptr = global_object_list.extract(it);
-					local_object_list.add(std::move(ptr));
+					if(obj.cache_owner)
+					{
+						remove_cache(obj);
+					}
+					pending.push_back(object_list.extract(&obj));
+				}else{
+					local_ids.push_back(object_list.get_id(&obj));
+					++local_count;
 				}
 			}
 			return true;
@@ -327,64 +564,53 @@ public:
 
 	void set_cache(const std::shared_ptr<ref_container> &obj, cell options)
 	{
-		auto addr = &(*obj)->operator[](0);
-		auto result = inner_cache.emplace(std::piecewise_construct, std::forward_as_tuple(addr), std::forward_as_tuple(obj, options));
-		if(!result.second)
+		ref_container &container = *obj;
+		const void *addr = &container->operator[](0);
+		if(container.cache_owner)
 		{
-			auto &record = result.first->second;
-			record.first = obj;
-			record.second = options;
+			remove_cache(container);
 		}
+		insert_entry(addr, &container, options);
+		container.cache_owner = this;
+		container.cache_addr = addr;
 	}
 
 	bool find_cache(const_inner_ptr ptr, ref_container *&obj) const
 	{
-		auto it = inner_cache.find(ptr);
-		if(it != inner_cache.end())
+		if(auto entry = find_entry(ptr))
 		{
-			if(auto lock = it->second.first.lock())
-			{
-				obj = lock.get();
-				return true;
-			}
+			obj = entry->obj;
+			return true;
 		}
 		return false;
 	}
 
 	bool find_cache(const_inner_ptr ptr, ref_container *&obj, cell &options) const
 	{
-		auto it = inner_cache.find(ptr);
-		if(it != inner_cache.end())
+		if(auto entry = find_entry(ptr))
 		{
-			if(auto lock = it->second.first.lock())
-			{
-				obj = lock.get();
-				options = it->second.second;
-				return true;
-			}
+			obj = entry->obj;
+			options = entry->options;
+			return true;
 		}
 		return false;
 	}
 
 	bool find_cache(const_inner_ptr ptr, ref_container *&obj, cell &options, int &pack, int &use_wchar, size_t &size) const
 	{
-		auto it = inner_cache.find(ptr);
-		if(it != inner_cache.end())
+		if(auto entry = find_entry(ptr))
 		{
-			if(auto lock = it->second.first.lock())
+			obj = entry->obj;
+			options = entry->options;
+			if(options & 2)
 			{
-				obj = lock.get();
-				options = it->second.second;
-				if(options & 2)
-				{
-					pack = (options & 4) != 0;
-				}
-				if(options & 8)
-				{
-					use_wchar = (options & 16) != 0;
-				}
-				return true;
+				pack = (options & 4) != 0;
+			}
+			if(options & 8)
+			{
+				use_wchar = (options & 16) != 0;
 			}
+			return true;
 		}
 		return false;
 	}
@@ -398,99 +624,130 @@ public:
 
 	bool remove(object_ptr obj)
 	{
-		auto it = global_object_list.find(&obj);
-		if(it != global_object_list.end())
+		if(object_list.contains(&obj))
 		{
-			global_object_list.erase(it);
-			return true;
-		}
-		it = local_object_list.find(&obj);
-		if(it != local_object_list.end())
-		{
-			local_object_list.erase(it);
-			return true;
+			if(!obj.global)
+			{
+				--local_count;
+			}
+			return object_list.remove(&obj);
 		}
 		return false;
 	}
 
 	bool remove_by_id(cell id)
 	{
-		auto obj = reinterpret_cast<ref_container*>(id);
-		auto it = global_object_list.find(obj);
-		if(it != global_object_list.end())
+		ref_container *obj;
+		if(object_list.get_by_id(id, obj))
 		{
-			global_object_list.erase(it);
-			return true;
-		}
-		it = local_object_list.find(obj);
-		if(it != local_object_list.end())
-		{
-			local_object_list.erase(it);
-			return true;
+			return remove(*obj);
 		}
 		return false;
 	}
 
 	void clear()
 	{
-		inner_cache.clear();
-		auto tmp = std::move(local_object_list);
-		tmp.clear();
-		auto list = std::move(global_object_list);
+		clear_cache();
+		local_ids.clear();
+		local_count = 0;
+		unpromoted_ids.clear();
+		auto list = std::move(object_list);
 		list.clear();
+		auto objects = std::move(pending);
+		pending.clear();
 	}
 
+	// Local objects are removed from the pool immediately, but their destruction is left to collect_pending
 	void clear_tmp()
 	{
-		inner_cache.clear();
-		auto tmp = std::move(local_object_list);
-		tmp.clear();
+		clear_cache();
+		auto ids = std::move(local_ids);
+		local_ids.clear();
+		for(cell id : ids)
+		{
+			ref_container *obj;
+			if(object_list.get_by_id(id, obj) && !obj->global)
+			{
+				--local_count;
+				pending.push_back(object_list.extract(obj));
+			}
+		}
+		promote_later();
 	}
 
-	bool get_by_id(cell id, ref_container *&obj)
+	size_t collect_pending(size_t count)
 	{
-		obj = reinterpret_cast<ref_container*>(id);
-
-		if(local_object_list.find(obj) != local_object_list.end())
+		size_t num = 0;
+		while(num < count && !pending.empty())
 		{
-			return true;
+			auto obj = std::move(pending.back());
+			pending.pop_back();
+			obj = nullptr;
+			num++;
 		}
-		if(global_object_list.find(obj) != global_object_list.end())
+		return num;
+	}
+
+	size_t pending_size() const
+	{
+		return pending.size();
+	}
+
+	// Used only while the pending objects of all pools are destroyed, when no code can refer to a released object
+	void set_collecting(bool value)
+	{
+		collecting = value;
+	}
+
+	// The function returns the number of bytes owned by an object in addition to its size
+	template <class Func>
+	aux::pool_stats get_stats(Func measure) const
+	{
+		auto stats = object_list.get_stats([&](const ref_container &obj)
 		{
-			return true;
+			return measure(*obj);
+		});
+		for(const auto &obj : pending)
+		{
+			stats.bytes += sizeof(ref_container) + measure(**obj);
 		}
-		return false;
+		stats.bytes += local_ids.capacity() * sizeof(cell);
+		stats.bytes += unpromoted_ids.capacity() * sizeof(cell);
+		stats.bytes += pending.capacity() * sizeof(std::shared_ptr<ref_container>);
+		stats.bytes += cache_table.capacity() * sizeof(cache_entry);
+		return stats;
 	}
 
-	bool get_by_id(cell id, ObjType *&obj)
+	void reset_stats()
 	{
-		auto ptr = reinterpret_cast<ref_container*>(id);
+		object_list.reset_stats();
+	}
 
-		if(local_object_list.find(ptr) != local_object_list.end())
+	bool get_by_id(cell id, ref_container *&obj)
+	{
+		if(object_list.get_by_id(id, obj))
 		{
-			obj = *ptr;
 			return true;
 		}
-		if(global_object_list.find(ptr) != global_object_list.end())
+		obj = nullptr;
+		return false;
+	}
+
+	bool get_by_id(cell id, ObjType *&obj)
+	{
+		ref_container *ptr;
+		if(object_list.get_by_id(id, ptr))
 		{
 			obj = *ptr;
 			return true;
 		}
-		obj = reinterpret_cast<ObjType*>(id);
+		obj = nullptr;
 		return false;
 	}
 
 	bool get_by_id(cell id, std::shared_ptr<ref_container> &obj)
 	{
-		if(local_object_list.get_by_id(id, obj))
-		{
-			return true;
-		}
-		if(global_object_list.get_by_id(id, obj))
-		{
-			return true;
-		}
-		return false;
+		return object_list.get_by_id(id, obj);
 	}
 
 	bool get_by_id(cell id, std::shared_ptr<ObjType> &obj)
@@ -517,32 +774,49 @@ public:
 
 	cell get_id(const_object_ptr obj) const
 	{
-		return reinterpret_cast<cell>(&obj);
+		return object_list.get_id(&obj);
 	}
 
+	// Objects with other owners are not moved, so the pointer stays valid
 	std::shared_ptr<ref_container> get(object_ptr obj)
 	{
-		auto it = local_object_list.find(&obj);
-		if(it != local_object_list.end())
-		{
-			return it->second;
-		}
-		it = global_object_list.find(&obj);
-		if(it != global_object_list.end())
+		return object_list.get(&obj);
+	}
+
+	// Gets an object that will not be moved, for code that keeps a weak reference to it.
+	// The object is moved out of the region first if possible, so it doesn't keep its chunk alive.
+	bool get_pinned(cell id, std::shared_ptr<ref_container> &obj)
+	{
+		ref_container *ptr;
+		if(!object_list.get_by_id(id, ptr))
 		{
-			return it->second;
+			return false;
 		}
-		return {};
+		promote(*ptr, std::is_same<ref_container, ref_container_simple>());
+		object_list.get_by_id(id, obj);
+		obj->pinned = true;
+		return true;
+	}
+
+	// Prevents the object from being moved, for code that stores its address without owning it
+	void pin(object_ptr obj)
+	{
+		obj.pinned = true;
 	}
 
 	size_t local_size() const
 	{
-		return local_object_list.size();
+		return local_count;
+	}
+
+	~object_pool()
+	{
+		clear_cache();
 	}
 
 	size_t global_size() const
 	{
-		return global_object_list.size();
+		return object_list.size() - local_count;
 	}
 };
 
@@ -30,16 +30,18 @@ namespace aux
 		struct element_type
 		{
 			bool assigned;
+			// changed when the element is erased, so old iterators to the slot can be detected
+			unsigned int generation;
 			union {
 				Type value;
 			};
 
-			element_type() : assigned(false)
+			element_type() : assigned(false), generation(0)
 			{
 
 			}
 
-			element_type(const element_type &obj) : assigned(obj.assigned)
+			element_type(const element_type &obj) : assigned(obj.assigned), generation(obj.generation)
 			{
 				if(assigned)
 				{
@@ -47,7 +49,7 @@ namespace aux
 				}
 			}
 
-			element_type(element_type &&obj) noexcept(noexcept(new(nullptr) Type(std::move(obj.value)))) : assigned(obj.assigned)
+			element_type(element_type &&obj) noexcept(noexcept(new(nullptr) Type(std::move(obj.value)))) : assigned(obj.assigned), generation(obj.generation)
 			{
 				if(assigned)
 				{
@@ -70,6 +72,7 @@ namespace aux
 						new (&value) Type(obj.value);
 					}
 					assigned = obj.assigned;
+					generation = obj.generation;
 				}
 				return *this;
 			}
@@ -89,6 +92,7 @@ namespace aux
 						new (&value) Type(std::move(obj.value));
 					}
 					assigned = obj.assigned;
+					generation = obj.generation;
 				}
 				return *this;
 			}
@@ -130,6 +134,7 @@ namespace aux
 			element_type *elem;
 			block_info *block;
 			size_t index;
+			unsigned int generation;
 
 		public:
 			typedef std::ptrdiff_t difference_type;
@@ -138,12 +143,12 @@ namespace aux
 			typedef Type &reference;
 			typedef std::bidirectional_iterator_tag iterator_category;
 
-			iterator() noexcept : elem(nullptr)
+			iterator() noexcept : elem(nullptr), generation(0)
 			{
 
 			}
 
-			iterator(element_type *elem, block_info *block, size_t index) noexcept : elem(elem), block(block), index(index)
+			iterator(element_type *elem, block_info *block, size_t index) noexcept : elem(elem), block(block), index(index), generation(elem->generation)
 			{
 
 			}
@@ -220,6 +225,7 @@ namespace aux
 						++index;
 					}
 				}while(!elem->assigned);
+				generation = elem->generation;
 				return *this;
 			}
 
@@ -291,6 +297,7 @@ namespace aux
 						--index;
 					}
 				}while(!elem->assigned);
+				generation = elem->generation;
 				return *this;
 			}
 
@@ -611,6 +618,7 @@ namespace aux
 			++next;
 			auto &elem = *pos.elem;
 			elem.assigned = false;
+			++elem.generation;
 			elem.value.~Type();
 			auto block = pos.block;
 			while(block != nullptr)
@@ -732,6 +740,12 @@ namespace aux
 			return block ? block->num_elements : 0;
 		}
 
+		// Whether the element at the position was not erased since the position was obtained
+		bool alive(const iterator &it) const
+		{
+			return it.elem == nullptr || (it.elem->assigned && it.elem->generation == it.generation);
+		}
+
 		void swap(block_pool<Type, BlockSize> &obj)
 		{
 			std::swap(data, obj.data);
@@ -0,0 +1,947 @@
+#ifndef BTREE_MAP_H_INCLUDED
+#define BTREE_MAP_H_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace aux
+{
+	// Ordered map storing its elements in B-tree nodes, so that neighbouring keys
+	// share cache lines. Every node also counts the elements in its subtree.
+	// Iterators are invalidated by any insertion or erasure, since elements move between nodes.
+	template <class Key, class Value, class Compare = std::less<Key>>
+	class btree_map
+	{
+	public:
+		typedef Key key_type;
+		typedef Value mapped_type;
+		typedef std::pair<const Key, Value> value_type;
+		typedef value_type &reference;
+		typedef const value_type &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+	private:
+		static constexpr size_t max_values = 15;
+		static constexpr size_t min_values = (max_values - 1) / 2;
+
+		struct internal_node;
+
+		struct node
+		{
+			internal_node *parent = nullptr;
+			size_t position = 0;
+			size_t count = 0;
+			size_t total = 0;
+			bool leaf;
+			typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type values[max_values];
+
+			node(bool leaf) : leaf(leaf)
+			{
+
+			}
+
+			value_type &value(size_t index)
+			{
+				return *reinterpret_cast<value_type*>(&values[index]);
+			}
+
+			node *&child(size_t index);
+		};
+
+		struct internal_node : public node
+		{
+			node *children[max_values + 1];
+
+			internal_node() : node(false), children()
+			{
+
+			}
+		};
+
+		node *root = nullptr;
+		size_t count = 0;
+		size_t leaves = 0;
+		size_t internals = 0;
+
+		template <bool Const>
+		class basic_iterator
+		{
+			friend class btree_map;
+
+			template <bool OtherConst>
+			friend class basic_iterator;
+
+			node *n;
+			size_t pos;
+
+			basic_iterator(node *n, size_t pos) : n(n), pos(pos)
+			{
+
+			}
+
+		public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef typename btree_map::value_type value_type;
+			typedef typename btree_map::difference_type difference_type;
+			typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+			typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+
+			basic_iterator() : n(nullptr), pos(0)
+			{
+
+			}
+
+			template <bool OtherConst, class = typename std::enable_if<Const && !OtherConst>::type>
+			basic_iterator(const basic_iterator<OtherConst> &it) : n(it.n), pos(it.pos)
+			{
+
+			}
+
+			reference operator*() const
+			{
+				return n->value(pos);
+			}
+
+			pointer operator->() const
+			{
+				return &n->value(pos);
+			}
+
+			basic_iterator &operator++()
+			{
+				if(!n->leaf)
+				{
+					n = n->child(pos + 1);
+					while(!n->leaf)
+					{
+						n = n->child(0);
+					}
+					pos = 0;
+				}else{
+					++pos;
+					// the end is the position past the last value of the root
+					while(pos == n->count && n->parent != nullptr)
+					{
+						pos = n->position;
+						n = n->parent;
+					}
+				}
+				return *this;
+			}
+
+			basic_iterator operator++(int)
+			{
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			basic_iterator &operator--()
+			{
+				if(!n->leaf)
+				{
+					n = n->child(pos);
+					while(!n->leaf)
+					{
+						n = n->child(n->count);
+					}
+					pos = n->count - 1;
+				}else if(pos > 0)
+				{
+					--pos;
+				}else{
+					while(n->position == 0 && n->parent != nullptr)
+					{
+						n = n->parent;
+					}
+					pos = n->position - 1;
+					n = n->parent;
+				}
+				return *this;
+			}
+
+			basic_iterator operator--(int)
+			{
+				auto tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			bool operator==(const basic_iterator &obj) const
+			{
+				return n == obj.n && pos == obj.pos;
+			}
+
+			bool operator!=(const basic_iterator &obj) const
+			{
+				return n != obj.n || pos != obj.pos;
+			}
+		};
+
+	public:
+		typedef basic_iterator<false> iterator;
+		typedef basic_iterator<true> const_iterator;
+
+	private:
+		static bool less(const Key &a, const Key &b)
+		{
+			return Compare()(a, b);
+		}
+
+		// the moved-from key is destroyed immediately, so it is never observed
+		static void relocate(node *dest, size_t dest_index, node *src, size_t src_index)
+		{
+			value_type &value = src->value(src_index);
+			new (&dest->values[dest_index]) value_type(std::move(const_cast<Key&>(value.first)), std::move(value.second));
+			value.~value_type();
+		}
+
+		static void set_child(internal_node *parent, size_t index, node *child)
+		{
+			parent->children[index] = child;
+			child->parent = parent;
+			child->position = index;
+		}
+
+		static size_t subtree_size(node *n)
+		{
+			size_t total = n->count;
+			if(!n->leaf)
+			{
+				for(size_t i = 0; i <= n->count; i++)
+				{
+					total += n->child(i)->total;
+				}
+			}
+			return total;
+		}
+
+		node *new_node(bool leaf)
+		{
+			if(leaf)
+			{
+				++leaves;
+				return new node(true);
+			}
+			++internals;
+			return new internal_node();
+		}
+
+		void delete_node(node *n)
+		{
+			if(n->leaf)
+			{
+				delete n;
+				--leaves;
+			}else{
+				delete static_cast<internal_node*>(n);
+				--internals;
+			}
+		}
+
+		void destroy(node *n)
+		{
+			for(size_t i = 0; i < n->count; i++)
+			{
+				n->value(i).~value_type();
+			}
+			if(!n->leaf)
+			{
+				for(size_t i = 0; i <= n->count; i++)
+				{
+					destroy(n->child(i));
+				}
+			}
+			delete_node(n);
+		}
+
+		node *copy(const node *src, internal_node *parent, size_t position)
+		{
+			node *n = new_node(src->leaf);
+			n->parent = parent;
+			n->position = position;
+			try{
+				for(; n->count < src->count; n->count++)
+				{
+					new (&n->values[n->count]) value_type(const_cast<node*>(src)->value(n->count));
+				}
+				if(!n->leaf)
+				{
+					for(size_t i = 0; i <= src->count; i++)
+					{
+						static_cast<internal_node*>(n)->children[i] = copy(const_cast<node*>(src)->child(i), static_cast<internal_node*>(n), i);
+					}
+				}
+			}catch(...)
+			{
+				destroy_partial(n);
+				throw;
+			}
+			n->total = src->total;
+			return n;
+		}
+
+		// destroys a node whose values are constructed up to count and children may be missing
+		void destroy_partial(node *n)
+		{
+			for(size_t i = 0; i < n->count; i++)
+			{
+				n->value(i).~value_type();
+			}
+			if(!n->leaf)
+			{
+				for(size_t i = 0; i <= n->count; i++)
+				{
+					if(node *c = n->child(i))
+					{
+						destroy(c);
+					}
+				}
+			}
+			delete_node(n);
+		}
+
+		// first index in a node whose key is not less (or, if Upper, greater) than the key
+		template <bool Upper>
+		static size_t bound_in(node *n, const Key &key)
+		{
+			size_t lo = 0, hi = n->count;
+			while(lo < hi)
+			{
+				size_t mid = (lo + hi) / 2;
+				if(Upper ? !less(key, n->value(mid).first) : less(n->value(mid).first, key))
+				{
+					lo = mid + 1;
+				}else{
+					hi = mid;
+				}
+			}
+			return lo;
+		}
+
+		iterator end_iter() const
+		{
+			return iterator(root, root == nullptr ? 0 : root->count);
+		}
+
+		template <bool Upper>
+		iterator bound(const Key &key) const
+		{
+			iterator result = end_iter();
+			node *n = root;
+			while(n != nullptr)
+			{
+				size_t i = bound_in<Upper>(n, key);
+				if(i < n->count)
+				{
+					result = iterator(n, i);
+				}
+				if(n->leaf)
+				{
+					break;
+				}
+				n = n->child(i);
+			}
+			return result;
+		}
+
+		// Splits a full node in two, moving its middle value to the parent
+		void split(node *n)
+		{
+			internal_node *parent = n->parent;
+			if(parent == nullptr)
+			{
+				parent = static_cast<internal_node*>(new_node(false));
+				set_child(parent, 0, n);
+				parent->total = n->total;
+				root = parent;
+			}else if(parent->count == max_values)
+			{
+				split(parent);
+				parent = n->parent;
+			}
+
+			size_t mid = n->count / 2;
+			node *right = new_node(n->leaf);
+			right->count = n->count - mid - 1;
+			for(size_t i = 0; i < right->count; i++)
+			{
+				relocate(right, i, n, mid + 1 + i);
+			}
+			if(!n->leaf)
+			{
+				for(size_t i = 0; i <= right->count; i++)
+				{
+					set_child(static_cast<internal_node*>(right), i, n->child(mid + 1 + i));
+				}
+			}
+
+			size_t position = n->position;
+			for(size_t i = parent->count; i > position; i--)
+			{
+				relocate(parent, i, parent, i - 1);
+				set_child(parent, i + 1, parent->children[i]);
+			}
+			relocate(parent, position, n, mid);
+			set_child(parent, position + 1, right);
+			parent->count++;
+
+			n->count = mid;
+			n->total = subtree_size(n);
+			right->total = subtree_size(right);
+		}
+
+		// Returns a leaf position where a value can be constructed, splitting the leaf if it is full
+		iterator prepare_insert(node *n, size_t index)
+		{
+			if(n->count == max_values)
+			{
+				size_t mid = n->count / 2;
+				split(n);
+				if(index > mid)
+				{
+					index -= mid + 1;
+					n = n->parent->children[n->position + 1];
+				}
+			}
+			for(size_t i = n->count; i > index; i--)
+			{
+				relocate(n, i, n, i - 1);
+			}
+			return iterator(n, index);
+		}
+
+		// Restores the values after prepare_insert if the construction failed
+		void cancel_insert(iterator it)
+		{
+			node *n = it.n;
+			for(size_t i = it.pos; i < n->count; i++)
+			{
+				relocate(n, i, n, i + 1);
+			}
+		}
+
+		void commit_insert(iterator it)
+		{
+			it.n->count++;
+			for(node *n = it.n; n != nullptr; n = n->parent)
+			{
+				n->total++;
+			}
+			count++;
+		}
+
+		// Finds the leaf position where a key belongs, or the element with the same key
+		std::pair<iterator, bool> find_insert(const Key &key)
+		{
+			if(root == nullptr)
+			{
+				root = new_node(true);
+			}
+			node *n = root;
+			while(true)
+			{
+				size_t i = bound_in<false>(n, key);
+				if(i < n->count && !less(key, n->value(i).first))
+				{
+					return std::make_pair(iterator(n, i), false);
+				}
+				if(n->leaf)
+				{
+					return std::make_pair(iterator(n, i), true);
+				}
+				n = n->child(i);
+			}
+		}
+
+		template <class KeyArg, class... Args>
+		std::pair<iterator, bool> try_emplace_key(KeyArg &&key, Args&&... args)
+		{
+			auto pair = find_insert(key);
+			if(!pair.second)
+			{
+				return pair;
+			}
+			iterator it = prepare_insert(pair.first.n, pair.first.pos);
+			try{
+				new (&it.n->values[it.pos]) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<KeyArg>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+			}catch(...)
+			{
+				cancel_insert(it);
+				throw;
+			}
+			commit_insert(it);
+			return std::make_pair(it, true);
+		}
+
+		// moves the last value of the left child through the parent to the right child
+		void rotate_right(internal_node *parent, size_t index)
+		{
+			node *left = parent->child(index);
+			node *right = parent->child(index + 1);
+			for(size_t i = right->count; i > 0; i--)
+			{
+				relocate(right, i, right, i - 1);
+			}
+			relocate(right, 0, parent, index);
+			relocate(parent, index, left, left->count - 1);
+			size_t moved = 1;
+			if(!right->leaf)
+			{
+				for(size_t i = right->count + 1; i > 0; i--)
+				{
+					set_child(static_cast<internal_node*>(right), i, right->child(i - 1));
+				}
+				node *c = left->child(left->count);
+				set_child(static_cast<internal_node*>(right), 0, c);
+				moved += c->total;
+			}
+			left->count--;
+			right->count++;
+			left->total -= moved;
+			right->total += moved;
+		}
+
+		// moves the first value of the right child through the parent to the left child
+		void rotate_left(internal_node *parent, size_t index)
+		{
+			node *left = parent->child(index);
+			node *right = parent->child(index + 1);
+			relocate(left, left->count, parent, index);
+			relocate(parent, index, right, 0);
+			for(size_t i = 0; i + 1 < right->count; i++)
+			{
+				relocate(right, i, right, i + 1);
+			}
+			size_t moved = 1;
+			if(!right->leaf)
+			{
+				node *c = right->child(0);
+				set_child(static_cast<internal_node*>(left), left->count + 1, c);
+				moved += c->total;
+				for(size_t i = 0; i < right->count; i++)
+				{
+					set_child(static_cast<internal_node*>(right), i, right->child(i + 1));
+				}
+			}
+			left->count++;
+			right->count--;
+			left->total += moved;
+			right->total -= moved;
+		}
+
+		// merges the right child and the value between the children into the left child
+		void merge(internal_node *parent, size_t index)
+		{
+			node *left = parent->child(index);
+			node *right = parent->child(index + 1);
+			relocate(left, left->count, parent, index);
+			for(size_t i = 0; i < right->count; i++)
+			{
+				relocate(left, left->count + 1 + i, right, i);
+			}
+			if(!left->leaf)
+			{
+				for(size_t i = 0; i <= right->count; i++)
+				{
+					set_child(static_cast<internal_node*>(left), left->count + 1 + i, right->child(i));
+				}
+			}
+			left->count += 1 + right->count;
+			left->total += 1 + right->total;
+			right->count = 0;
+			delete_node(right);
+
+			for(size_t i = index; i + 1 < parent->count; i++)
+			{
+				relocate(parent, i, parent, i + 1);
+				set_child(parent, i + 1, parent->children[i + 2]);
+			}
+			parent->count--;
+		}
+
+		void rebalance(node *n)
+		{
+			while(n != root && n->count < min_values)
+			{
+				internal_node *parent = n->parent;
+				size_t position = n->position;
+				if(position > 0 && parent->child(position - 1)->count > min_values)
+				{
+					rotate_right(parent, position - 1);
+					return;
+				}
+				if(position < parent->count && parent->child(position + 1)->count > min_values)
+				{
+					rotate_left(parent, position);
+					return;
+				}
+				if(position > 0)
+				{
+					merge(parent, position - 1);
+				}else{
+					merge(parent, position);
+				}
+				n = parent;
+			}
+			if(root->count == 0)
+			{
+				node *old = root;
+				if(root->leaf)
+				{
+					root = nullptr;
+				}else{
+					root = root->child(0);
+					root->parent = nullptr;
+					root->position = 0;
+				}
+				delete_node(old);
+			}
+		}
+
+		iterator at_rank(size_t rank) const
+		{
+			if(rank >= count)
+			{
+				return end_iter();
+			}
+			node *n = root;
+			while(!n->leaf)
+			{
+				for(size_t i = 0; ; i++)
+				{
+					size_t total = n->child(i)->total;
+					if(rank < total)
+					{
+						n = n->child(i);
+						break;
+					}
+					rank -= total;
+					if(rank == 0)
+					{
+						return iterator(n, i);
+					}
+					rank--;
+				}
+			}
+			return iterator(n, rank);
+		}
+
+	public:
+		btree_map() = default;
+
+		template <class InputIterator>
+		btree_map(InputIterator first, InputIterator last) : btree_map()
+		{
+			insert(first, last);
+		}
+
+		btree_map(const btree_map &obj) : count(obj.count)
+		{
+			if(obj.root != nullptr)
+			{
+				root = copy(obj.root, nullptr, 0);
+			}
+		}
+
+		btree_map(btree_map &&obj) noexcept : root(obj.root), count(obj.count), leaves(obj.leaves), internals(obj.internals)
+		{
+			obj.root = nullptr;
+			obj.count = 0;
+			obj.leaves = 0;
+			obj.internals = 0;
+		}
+
+		btree_map &operator=(const btree_map &obj)
+		{
+			if(this != &obj)
+			{
+				btree_map tmp(obj);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		btree_map &operator=(btree_map &&obj) noexcept
+		{
+			if(this != &obj)
+			{
+				btree_map tmp(std::move(obj));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		Value &operator[](const Key &key)
+		{
+			return try_emplace_key(key).first->second;
+		}
+
+		Value &operator[](Key &&key)
+		{
+			return try_emplace_key(std::move(key)).first->second;
+		}
+
+		iterator begin()
+		{
+			if(root == nullptr)
+			{
+				return end();
+			}
+			node *n = root;
+			while(!n->leaf)
+			{
+				n = n->child(0);
+			}
+			return iterator(n, 0);
+		}
+
+		iterator end()
+		{
+			return end_iter();
+		}
+
+		const_iterator begin() const
+		{
+			return const_cast<btree_map*>(this)->begin();
+		}
+
+		const_iterator end() const
+		{
+			return const_cast<btree_map*>(this)->end();
+		}
+
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		size_type size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		// Bytes allocated for the nodes, including the unused space in them
+		size_t memory_size() const
+		{
+			return leaves * sizeof(node) + internals * sizeof(internal_node);
+		}
+
+		void clear()
+		{
+			if(root != nullptr)
+			{
+				destroy(root);
+				root = nullptr;
+			}
+			count = 0;
+		}
+
+		iterator find(const Key &key)
+		{
+			iterator it = lower_bound(key);
+			if(it != end() && !less(key, it->first))
+			{
+				return it;
+			}
+			return end();
+		}
+
+		const_iterator find(const Key &key) const
+		{
+			return const_cast<btree_map*>(this)->find(key);
+		}
+
+		iterator lower_bound(const Key &key)
+		{
+			return bound<false>(key);
+		}
+
+		const_iterator lower_bound(const Key &key) const
+		{
+			return bound<false>(key);
+		}
+
+		iterator upper_bound(const Key &key)
+		{
+			return bound<true>(key);
+		}
+
+		const_iterator upper_bound(const Key &key) const
+		{
+			return bound<true>(key);
+		}
+
+		// Number of elements before the position
+		size_t index_of(const_iterator it) const
+		{
+			node *n = it.n;
+			if(n == nullptr)
+			{
+				return 0;
+			}
+			size_t index = it.pos;
+			if(!n->leaf)
+			{
+				for(size_t i = 0; i <= it.pos; i++)
+				{
+					index += n->child(i)->total;
+				}
+			}
+			while(n->parent != nullptr)
+			{
+				internal_node *parent = n->parent;
+				index += n->position;
+				for(size_t i = 0; i < n->position; i++)
+				{
+					index += parent->children[i]->total;
+				}
+				n = parent;
+			}
+			return index;
+		}
+
+		iterator iter_at(size_t index)
+		{
+			return at_rank(index);
+		}
+
+		const_iterator iter_at(size_t index) const
+		{
+			return at_rank(index);
+		}
+
+		size_type erase(const Key &key)
+		{
+			iterator it = find(key);
+			if(it == end())
+			{
+				return 0;
+			}
+			erase(it);
+			return 1;
+		}
+
+		iterator erase(iterator it)
+		{
+			size_t index = index_of(it);
+			node *n = it.n;
+			size_t pos = it.pos;
+			n->value(pos).~value_type();
+			if(!n->leaf)
+			{
+				// the value is replaced by its predecessor, which is removed from its leaf instead
+				node *leaf = n->child(pos);
+				while(!leaf->leaf)
+				{
+					leaf = leaf->child(leaf->count);
+				}
+				relocate(n, pos, leaf, leaf->count - 1);
+				n = leaf;
+				pos = leaf->count - 1;
+			}else{
+				for(size_t i = pos; i + 1 < n->count; i++)
+				{
+					relocate(n, i, n, i + 1);
+				}
+			}
+			n->count--;
+			for(node *p = n; p != nullptr; p = p->parent)
+			{
+				p->total--;
+			}
+			count--;
+			rebalance(n);
+			return at_rank(index);
+		}
+
+		std::pair<iterator, bool> insert(const value_type &val)
+		{
+			return try_emplace_key(val.first, val.second);
+		}
+
+		std::pair<iterator, bool> insert(value_type &&val)
+		{
+			// the key is const, so it can only be copied
+			return try_emplace_key(val.first, std::move(val.second));
+		}
+
+		template <class KeyArg, class ValueArg, class = typename std::enable_if<std::is_same<typename std::decay<KeyArg>::type, Key>::value>::type>
+		std::pair<iterator, bool> emplace(KeyArg &&key, ValueArg &&value)
+		{
+			return try_emplace_key(std::forward<KeyArg>(key), std::forward<ValueArg>(value));
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			// the key is not known until the element is constructed
+			typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+			value_type &value = *new (&storage) value_type(std::forward<Args>(args)...);
+			std::pair<iterator, bool> pair;
+			try{
+				pair = find_insert(value.first);
+				if(pair.second)
+				{
+					pair.first = prepare_insert(pair.first.n, pair.first.pos);
+				}
+			}catch(...)
+			{
+				value.~value_type();
+				throw;
+			}
+			if(pair.second)
+			{
+				new (&pair.first.n->values[pair.first.pos]) value_type(std::move(const_cast<Key&>(value.first)), std::move(value.second));
+				commit_insert(pair.first);
+			}
+			value.~value_type();
+			return pair;
+		}
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last)
+		{
+			for(; first != last; ++first)
+			{
+				insert(*first);
+			}
+		}
+
+		void swap(btree_map &obj) noexcept
+		{
+			std::swap(root, obj.root);
+			std::swap(count, obj.count);
+			std::swap(leaves, obj.leaves);
+			std::swap(internals, obj.internals);
+		}
+
+		~btree_map()
+		{
+			clear();
+		}
+	};
+
+	template <class Key, class Value, class Compare>
+	auto btree_map<Key, Value, Compare>::node::child(size_t index) -> node*&
+	{
+		return static_cast<internal_node*>(this)->children[index];
+	}
+}
+
+#endif
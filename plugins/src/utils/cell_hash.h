@@ -0,0 +1,124 @@
+#ifndef CELL_HASH_H_INCLUDED
+#define CELL_HASH_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace aux
+{
+	// Non-cryptographic hash of a sequence of 32-bit cells, in the style of wyhash.
+	// Four cells are consumed at a time by two independent multiply-mix lanes,
+	// so the loop has no dependency between neighbouring blocks and pipelines well.
+	// Only 32x32-bit multiplications are used, which keeps it fast on 32-bit targets.
+	// Cells can be added one at a time or in bulk; the result depends only on the
+	// sequence of cells, not on how it was split.
+	class cell_hasher
+	{
+		static constexpr uint64_t secret0 = 0xa0761d6478bd642full;
+		static constexpr uint64_t secret1 = 0xe7037ed1a0b428dbull;
+		static constexpr uint64_t secret2 = 0x8ebc6af09c88c6e3ull;
+		static constexpr uint64_t secret3 = 0x589965cc75374cc3ull;
+
+		uint64_t lane0 = secret0;
+		uint64_t lane1 = secret1;
+		uint64_t length = 0;
+		uint32_t buffer[4];
+		unsigned buffered = 0;
+
+		static uint64_t rot32(uint64_t x)
+		{
+			return (x >> 32) | (x << 32);
+		}
+
+		static uint64_t mix(uint64_t a, uint64_t b)
+		{
+			uint64_t hh = (a >> 32) * (b >> 32);
+			uint64_t hl = (a >> 32) * static_cast<uint32_t>(b);
+			uint64_t lh = static_cast<uint32_t>(a) * (b >> 32);
+			uint64_t ll = static_cast<uint64_t>(static_cast<uint32_t>(a)) * static_cast<uint32_t>(b);
+			return (rot32(hl) ^ hh) ^ (rot32(lh) ^ ll);
+		}
+
+		static uint64_t join(uint32_t lo, uint32_t hi)
+		{
+			return static_cast<uint64_t>(lo) | (static_cast<uint64_t>(hi) << 32);
+		}
+
+		void block(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3)
+		{
+			lane0 = mix(join(c0, c1) ^ secret1, lane0 ^ secret2);
+			lane1 = mix(join(c2, c3) ^ secret3, lane1 ^ secret0);
+		}
+
+	public:
+		template <class Cell>
+		void add(Cell value)
+		{
+			static_assert(sizeof(Cell) == sizeof(uint32_t), "cells must be 32-bit");
+			buffer[buffered++] = static_cast<uint32_t>(value);
+			length++;
+			if(buffered == 4)
+			{
+				block(buffer[0], buffer[1], buffer[2], buffer[3]);
+				buffered = 0;
+			}
+		}
+
+		template <class Cell>
+		void add(const Cell *data, size_t size)
+		{
+			static_assert(sizeof(Cell) == sizeof(uint32_t), "cells must be 32-bit");
+			while(buffered != 0 && size > 0)
+			{
+				add(*data++);
+				size--;
+			}
+			length += size & ~size_t(3);
+			for(; size >= 4; size -= 4, data += 4)
+			{
+				block(static_cast<uint32_t>(data[0]), static_cast<uint32_t>(data[1]), static_cast<uint32_t>(data[2]), static_cast<uint32_t>(data[3]));
+			}
+			while(size > 0)
+			{
+				add(*data++);
+				size--;
+			}
+		}
+
+		size_t finish() const
+		{
+			uint32_t tail[4] = {0, 0, 0, 0};
+			for(unsigned i = 0; i < buffered; i++)
+			{
+				tail[i] = buffer[i];
+			}
+			uint64_t seed = lane0 ^ rot32(lane1);
+			uint64_t a = join(tail[0], tail[1]) ^ secret1;
+			uint64_t b = join(tail[2], tail[3]) ^ seed;
+			uint64_t result = mix(secret1 ^ (length << 2), mix(a, b) ^ secret2);
+			if(sizeof(size_t) < sizeof(uint64_t))
+			{
+				return static_cast<size_t>(result ^ (result >> 32));
+			}
+			return static_cast<size_t>(result);
+		}
+	};
+
+	template <class T>
+	inline void hash_combine(size_t &seed, const T &v)
+	{
+		std::hash<T> hasher;
+		seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
+	template <class Cell>
+	inline size_t hash_cells(const Cell *data, size_t size)
+	{
+		cell_hasher hasher;
+		hasher.add(data, size);
+		return hasher.finish();
+	}
+}
+
+#endif
@@ -0,0 +1,890 @@
+#ifndef FLAT_HASH_MAP_H_INCLUDED
+#define FLAT_HASH_MAP_H_INCLUDED
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace aux
+{
+	// Open-addressing hash map with linear probing. Every slot has a control byte
+	// (empty, deleted, or the low 7 bits of the hash of its key), and the full hash
+	// is cached next to the element, so probing rarely touches keys of other elements
+	// and growing the table never calls the hash function again.
+	// Iterators are invalidated by rehashing, but not by erasing other elements;
+	// alive tells whether the element of an iterator was erased, even if its slot was reused.
+	// A large table is grown incrementally: the old table is kept next to the new one
+	// and its elements are moved over a few at a time by later insertions or rehash_step,
+	// so no single insertion has to move all of them.
+	template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+	class flat_hash_map
+	{
+	public:
+		typedef Key key_type;
+		typedef Value mapped_type;
+		typedef std::pair<const Key, Value> value_type;
+		typedef value_type &reference;
+		typedef const value_type &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+	private:
+		typedef signed char ctrl_t;
+
+		static constexpr ctrl_t ctrl_empty = -128;
+		static constexpr ctrl_t ctrl_deleted = -2;
+		static constexpr ctrl_t ctrl_sentinel = -1;
+		static constexpr size_t npos = static_cast<size_t>(-1);
+		static constexpr size_t min_capacity = 8;
+		// tables with fewer elements are rehashed at once
+		static constexpr size_t incremental_threshold = 16384;
+		// slots of the old table moved by every insertion
+		static constexpr size_t insert_step = 32;
+
+		struct slot
+		{
+			size_t hash;
+			// changed when the element is erased
+			unsigned int generation;
+			value_type value;
+		};
+
+		// ctrls[0] and ctrls[cap + 1] are sentinels, ctrls[i + 1] belongs to slots[i]
+		ctrl_t *ctrls;
+		slot *slots;
+		size_t cap;
+		size_t count;
+		size_t deleted;
+
+		// the table being emptied by an incremental rehash; count includes its elements
+		ctrl_t *old_ctrls;
+		slot *old_slots;
+		size_t old_cap;
+		size_t old_count;
+		size_t old_pos;
+
+		static ctrl_t *empty_ctrls()
+		{
+			static ctrl_t ctrls[2] = {ctrl_sentinel, ctrl_sentinel};
+			return ctrls;
+		}
+
+		template <bool Const>
+		class basic_iterator
+		{
+			friend class flat_hash_map;
+
+			template <bool OtherConst>
+			friend class basic_iterator;
+
+			const ctrl_t *ctrl;
+			slot *ptr;
+			const flat_hash_map *owner;
+			unsigned int generation;
+
+			basic_iterator(const ctrl_t *ctrl, slot *ptr, const flat_hash_map *owner) : ctrl(ctrl), ptr(ptr), owner(owner)
+			{
+				load_generation();
+			}
+
+			// the end has no slot
+			void load_generation()
+			{
+				generation = *ctrl >= 0 ? ptr->generation : 0;
+			}
+
+			// the elements of the old table follow those of the new one
+			void skip_free()
+			{
+				while(true)
+				{
+					while(*ctrl < ctrl_sentinel)
+					{
+						++ctrl;
+						++ptr;
+					}
+					if(owner->old_cap != 0 && ctrl == owner->ctrls + owner->cap + 1)
+					{
+						ctrl = owner->old_ctrls + 1;
+						ptr = owner->old_slots;
+					}else{
+						break;
+					}
+				}
+				load_generation();
+			}
+
+		public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef typename flat_hash_map::value_type value_type;
+			typedef typename flat_hash_map::difference_type difference_type;
+			typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+			typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+
+			basic_iterator() : ctrl(nullptr), ptr(nullptr), owner(nullptr), generation(0)
+			{
+
+			}
+
+			template <bool OtherConst, class = typename std::enable_if<Const && !OtherConst>::type>
+			basic_iterator(const basic_iterator<OtherConst> &it) : ctrl(it.ctrl), ptr(it.ptr), owner(it.owner), generation(it.generation)
+			{
+
+			}
+
+			reference operator*() const
+			{
+				return ptr->value;
+			}
+
+			pointer operator->() const
+			{
+				return &ptr->value;
+			}
+
+			basic_iterator &operator++()
+			{
+				++ctrl;
+				++ptr;
+				skip_free();
+				return *this;
+			}
+
+			basic_iterator operator++(int)
+			{
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			basic_iterator &operator--()
+			{
+				while(true)
+				{
+					--ctrl;
+					--ptr;
+					if(*ctrl == ctrl_sentinel && owner->old_cap != 0 && ctrl == owner->old_ctrls)
+					{
+						ctrl = owner->ctrls + owner->cap + 1;
+						ptr = owner->slots + owner->cap;
+					}else if(*ctrl >= ctrl_sentinel)
+					{
+						break;
+					}
+				}
+				load_generation();
+				return *this;
+			}
+
+			basic_iterator operator--(int)
+			{
+				auto tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			bool operator==(const basic_iterator &obj) const
+			{
+				return ctrl == obj.ctrl;
+			}
+
+			bool operator!=(const basic_iterator &obj) const
+			{
+				return ctrl != obj.ctrl;
+			}
+		};
+
+	public:
+		typedef basic_iterator<false> iterator;
+		typedef basic_iterator<true> const_iterator;
+
+	private:
+		// dyn_object hashes of plain cells are the cells themselves, so they have to be spread
+		static size_t mix(size_t hash)
+		{
+			hash ^= hash >> 16;
+			hash *= static_cast<size_t>(0x45D9F3BU);
+			hash ^= hash >> 16;
+			hash *= static_cast<size_t>(0x45D9F3BU);
+			hash ^= hash >> 16;
+			return hash;
+		}
+
+		static size_t hash_key(const Key &key)
+		{
+			return mix(Hash()(key));
+		}
+
+		static ctrl_t ctrl_of(size_t hash)
+		{
+			return static_cast<ctrl_t>(hash & 0x7F);
+		}
+
+		static size_t growth_limit(size_t cap)
+		{
+			return cap - cap / 8;
+		}
+
+		static size_t probe_start(size_t hash, size_t cap)
+		{
+			return (hash >> 7) & (cap - 1);
+		}
+
+		iterator make_iterator(size_t index) const
+		{
+			return iterator(ctrls + index + 1, slots + index, this);
+		}
+
+		iterator make_old_iterator(size_t index) const
+		{
+			return iterator(old_ctrls + index + 1, old_slots + index, this);
+		}
+
+		iterator make_end() const
+		{
+			return old_cap != 0 ? make_old_iterator(old_cap) : make_iterator(cap);
+		}
+
+		template <class Equal>
+		static size_t find_in(const ctrl_t *ctrls, const slot *slots, size_t cap, size_t hash, Equal &equal)
+		{
+			if(cap == 0)
+			{
+				return npos;
+			}
+			ctrl_t h = ctrl_of(hash);
+			size_t mask = cap - 1;
+			for(size_t i = probe_start(hash, cap); ; i = (i + 1) & mask)
+			{
+				ctrl_t c = ctrls[i + 1];
+				if(c == h && slots[i].hash == hash && equal(slots[i].value.first))
+				{
+					return i;
+				}else if(c == ctrl_empty)
+				{
+					return npos;
+				}
+			}
+		}
+
+		// looks in both tables, returning the end if the element is not found
+		template <class Equal>
+		iterator find_if(size_t hash, Equal equal) const
+		{
+			size_t index = find_in(ctrls, slots, cap, hash, equal);
+			if(index != npos)
+			{
+				return make_iterator(index);
+			}
+			if(old_count != 0)
+			{
+				index = find_in(old_ctrls, old_slots, old_cap, hash, equal);
+				if(index != npos)
+				{
+					return make_old_iterator(index);
+				}
+			}
+			return make_end();
+		}
+
+		iterator find_key(const Key &key, size_t hash) const
+		{
+			return find_if(hash, [&](const Key &other)
+			{
+				return KeyEqual()(other, key);
+			});
+		}
+
+		static size_t find_free(const ctrl_t *ctrls, size_t cap, size_t hash)
+		{
+			size_t mask = cap - 1;
+			size_t i = probe_start(hash, cap);
+			while(ctrls[i + 1] >= 0)
+			{
+				i = (i + 1) & mask;
+			}
+			return i;
+		}
+
+		bool in_old(const ctrl_t *ctrl) const
+		{
+			std::less<const ctrl_t*> less;
+			return old_cap != 0 && !less(ctrl, old_ctrls + 1) && less(ctrl, old_ctrls + old_cap + 1);
+		}
+
+		void allocate(size_t new_cap)
+		{
+			ctrl_t *new_ctrls = new ctrl_t[new_cap + 2];
+			try{
+				slots = static_cast<slot*>(::operator new(new_cap * sizeof(slot)));
+			}catch(...)
+			{
+				delete[] new_ctrls;
+				throw;
+			}
+			ctrls = new_ctrls;
+			cap = new_cap;
+			ctrls[0] = ctrls[cap + 1] = ctrl_sentinel;
+			std::memset(ctrls + 1, static_cast<unsigned char>(ctrl_empty), cap);
+			for(size_t i = 0; i < cap; i++)
+			{
+				slots[i].generation = 0;
+			}
+		}
+
+		void deallocate()
+		{
+			if(cap != 0)
+			{
+				delete[] ctrls;
+				::operator delete(slots);
+			}
+			ctrls = empty_ctrls();
+			slots = nullptr;
+			cap = 0;
+			deallocate_old();
+		}
+
+		void deallocate_old()
+		{
+			if(old_cap != 0)
+			{
+				delete[] old_ctrls;
+				::operator delete(old_slots);
+			}
+			old_ctrls = nullptr;
+			old_slots = nullptr;
+			old_cap = old_count = old_pos = 0;
+		}
+
+		static void destroy_in(ctrl_t *ctrls, slot *slots, size_t cap)
+		{
+			for(size_t i = 0; i < cap; i++)
+			{
+				if(ctrls[i + 1] >= 0)
+				{
+					slots[i].value.~value_type();
+				}
+			}
+		}
+
+		void destroy_all()
+		{
+			destroy_in(ctrls, slots, cap);
+			destroy_in(old_ctrls, old_slots, old_cap);
+		}
+
+		// the moved-from key is destroyed immediately, so it is never observed
+		static void relocate(slot &dest, slot &src)
+		{
+			new (&dest.value) value_type(std::move(const_cast<Key&>(src.value.first)), std::move(src.value.second));
+			dest.hash = src.hash;
+			src.value.~value_type();
+		}
+
+		// moves an element of the old table to the new one, where there is always space for it
+		void migrate(size_t index)
+		{
+			slot &src = old_slots[index];
+			size_t j = find_free(ctrls, cap, src.hash);
+			if(ctrls[j + 1] == ctrl_deleted)
+			{
+				--deleted;
+			}
+			relocate(slots[j], src);
+			ctrls[j + 1] = ctrl_of(slots[j].hash);
+			--old_count;
+		}
+
+		// The old table is emptied one cluster of occupied slots at a time. A lookup in the old table
+		// never leaves the cluster where it started, so it is not affected by the clusters already moved.
+		void migrate_slots(size_t budget)
+		{
+			size_t mask = old_cap - 1;
+			while(old_count != 0)
+			{
+				ctrl_t &c = old_ctrls[old_pos + 1];
+				if(c == ctrl_empty)
+				{
+					if(budget == 0)
+					{
+						break;
+					}
+				}else{
+					if(c >= 0)
+					{
+						migrate(old_pos);
+					}
+					c = ctrl_empty;
+				}
+				old_pos = (old_pos + 1) & mask;
+				if(budget != 0)
+				{
+					--budget;
+				}
+			}
+			if(old_count == 0)
+			{
+				deallocate_old();
+			}
+		}
+
+		void rehash(size_t new_cap)
+		{
+			finish_rehash();
+			ctrl_t *prev_ctrls = ctrls;
+			slot *prev_slots = slots;
+			size_t prev_cap = cap;
+			allocate(new_cap);
+			deleted = 0;
+			for(size_t i = 0; i < prev_cap; i++)
+			{
+				if(prev_ctrls[i + 1] >= 0)
+				{
+					size_t j = find_free(ctrls, cap, prev_slots[i].hash);
+					relocate(slots[j], prev_slots[i]);
+					ctrls[j + 1] = ctrl_of(slots[j].hash);
+				}
+			}
+			if(prev_cap != 0)
+			{
+				delete[] prev_ctrls;
+				::operator delete(prev_slots);
+			}
+		}
+
+		// moves the elements later, starting at an empty slot so that no cluster is split
+		void start_rehash(size_t new_cap)
+		{
+			finish_rehash();
+			size_t start = 0;
+			while(ctrls[start + 1] != ctrl_empty)
+			{
+				++start;
+			}
+			ctrl_t *prev_ctrls = ctrls;
+			slot *prev_slots = slots;
+			size_t prev_cap = cap;
+			allocate(new_cap);
+			old_ctrls = prev_ctrls;
+			old_slots = prev_slots;
+			old_cap = prev_cap;
+			old_count = count;
+			old_pos = start;
+			deleted = 0;
+		}
+
+		void grow(size_t new_cap)
+		{
+			if(count >= incremental_threshold)
+			{
+				start_rehash(new_cap);
+			}else{
+				rehash(new_cap);
+			}
+		}
+
+		// finds a free slot for a new element, growing the table if needed
+		size_t prepare_insert(size_t hash)
+		{
+			if(old_cap != 0)
+			{
+				migrate_slots(insert_step);
+			}
+			if(count + deleted >= growth_limit(cap))
+			{
+				if(cap == 0)
+				{
+					rehash(min_capacity);
+				}else if(count + 1 > growth_limit(cap) / 2)
+				{
+					grow(cap * 2);
+				}else{
+					// mostly deleted slots, so only clean them
+					grow(cap);
+				}
+			}
+			size_t index = find_free(ctrls, cap, hash);
+			slots[index].hash = hash;
+			return index;
+		}
+
+		void commit_insert(size_t index)
+		{
+			if(ctrls[index + 1] == ctrl_deleted)
+			{
+				--deleted;
+			}
+			ctrls[index + 1] = ctrl_of(slots[index].hash);
+			++count;
+		}
+
+		// no probe sequence continues past a slot followed by an empty one
+		static bool erase_in(ctrl_t *ctrls, slot *slots, size_t cap, size_t index)
+		{
+			slots[index].value.~value_type();
+			++slots[index].generation;
+			if(ctrls[((index + 1) & (cap - 1)) + 1] == ctrl_empty)
+			{
+				ctrls[index + 1] = ctrl_empty;
+				return false;
+			}else{
+				ctrls[index + 1] = ctrl_deleted;
+				return true;
+			}
+		}
+
+		void erase_at(iterator it)
+		{
+			if(in_old(it.ctrl))
+			{
+				erase_in(old_ctrls, old_slots, old_cap, it.ptr - old_slots);
+				--old_count;
+			}else if(erase_in(ctrls, slots, cap, it.ptr - slots))
+			{
+				++deleted;
+			}
+			--count;
+		}
+
+		template <class KeyArg, class... Args>
+		std::pair<iterator, bool> try_emplace_hashed(size_t hash, KeyArg &&key, Args&&... args)
+		{
+			auto it = find_key(key, hash);
+			if(it != end())
+			{
+				return std::make_pair(it, false);
+			}
+			size_t index = prepare_insert(hash);
+			new (&slots[index].value) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<KeyArg>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+			commit_insert(index);
+			return std::make_pair(make_iterator(index), true);
+		}
+
+	public:
+		flat_hash_map() : ctrls(empty_ctrls()), slots(nullptr), cap(0), count(0), deleted(0), old_ctrls(nullptr), old_slots(nullptr), old_cap(0), old_count(0), old_pos(0)
+		{
+
+		}
+
+		template <class InputIterator>
+		flat_hash_map(InputIterator first, InputIterator last) : flat_hash_map()
+		{
+			insert(first, last);
+		}
+
+		flat_hash_map(const flat_hash_map &obj) : flat_hash_map()
+		{
+			if(obj.count == 0)
+			{
+				return;
+			}
+			allocate(obj.cap);
+			try{
+				if(obj.old_cap != 0)
+				{
+					// the copy has all elements in one table
+					for(auto it = obj.begin(); it != obj.end(); ++it)
+					{
+						size_t j = find_free(ctrls, cap, it.ptr->hash);
+						new (&slots[j].value) value_type(*it);
+						slots[j].hash = it.ptr->hash;
+						ctrls[j + 1] = ctrl_of(slots[j].hash);
+						++count;
+					}
+				}else{
+					for(size_t i = 0; i < cap; i++)
+					{
+						ctrl_t c = obj.ctrls[i + 1];
+						if(c >= 0)
+						{
+							new (&slots[i].value) value_type(obj.slots[i].value);
+							slots[i].hash = obj.slots[i].hash;
+							++count;
+						}
+						ctrls[i + 1] = c;
+					}
+					deleted = obj.deleted;
+				}
+			}catch(...)
+			{
+				destroy_all();
+				deallocate();
+				throw;
+			}
+		}
+
+		flat_hash_map(flat_hash_map &&obj) noexcept : flat_hash_map()
+		{
+			swap(obj);
+		}
+
+		flat_hash_map &operator=(const flat_hash_map &obj)
+		{
+			if(this != &obj)
+			{
+				flat_hash_map tmp(obj);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		flat_hash_map &operator=(flat_hash_map &&obj) noexcept
+		{
+			if(this != &obj)
+			{
+				flat_hash_map tmp(std::move(obj));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		Value &operator[](const Key &key)
+		{
+			return try_emplace_hashed(hash_key(key), key).first->second;
+		}
+
+		Value &operator[](Key &&key)
+		{
+			size_t hash = hash_key(key);
+			return try_emplace_hashed(hash, std::move(key)).first->second;
+		}
+
+		iterator begin()
+		{
+			iterator it(ctrls + 1, slots, this);
+			it.skip_free();
+			return it;
+		}
+
+		iterator end()
+		{
+			return make_end();
+		}
+
+		const_iterator begin() const
+		{
+			return const_cast<flat_hash_map*>(this)->begin();
+		}
+
+		const_iterator end() const
+		{
+			return make_end();
+		}
+
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		size_type size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		// Number of elements that can be stored before the table is rehashed
+		size_type capacity() const
+		{
+			return growth_limit(cap) - deleted;
+		}
+
+		// Bytes allocated for the table, excluding memory owned by the elements
+		size_t memory_size() const
+		{
+			size_t size = cap == 0 ? 0 : cap * (sizeof(slot) + sizeof(ctrl_t)) + 2 * sizeof(ctrl_t);
+			if(old_cap != 0)
+			{
+				size += old_cap * (sizeof(slot) + sizeof(ctrl_t)) + 2 * sizeof(ctrl_t);
+			}
+			return size;
+		}
+
+		// Whether the element at the position was not erased since the position was obtained.
+		// The position must not have been invalidated by rehashing.
+		bool alive(const const_iterator &it) const
+		{
+			return it.ctrl == nullptr || *it.ctrl == ctrl_sentinel || (*it.ctrl >= 0 && it.ptr->generation == it.generation);
+		}
+
+		// Whether some elements are still in the old table after the table was grown
+		bool rehashing() const
+		{
+			return old_cap != 0;
+		}
+
+		// Moves the elements from about the given number of slots of the old table.
+		// Iterators to the moved elements are invalidated.
+		bool rehash_step(size_t budget)
+		{
+			if(old_cap != 0)
+			{
+				migrate_slots(budget == 0 ? 1 : budget);
+			}
+			return old_cap != 0;
+		}
+
+		void finish_rehash()
+		{
+			if(old_cap != 0)
+			{
+				migrate_slots(old_cap);
+			}
+		}
+
+		void reserve(size_type count)
+		{
+			if(count > capacity())
+			{
+				size_t new_cap = cap == 0 ? min_capacity : cap;
+				while(growth_limit(new_cap) < count)
+				{
+					new_cap *= 2;
+				}
+				grow(new_cap);
+			}
+		}
+
+		void clear()
+		{
+			destroy_all();
+			deallocate_old();
+			if(cap != 0)
+			{
+				std::memset(ctrls + 1, static_cast<unsigned char>(ctrl_empty), cap);
+			}
+			count = 0;
+			deleted = 0;
+		}
+
+		iterator find(const Key &key)
+		{
+			return find_key(key, hash_key(key));
+		}
+
+		const_iterator find(const Key &key) const
+		{
+			return find_key(key, hash_key(key));
+		}
+
+		// Finds an element without a key object, using the value Hash would produce for it
+		template <class Equal>
+		iterator find_hashed(size_t hash, Equal equal)
+		{
+			return find_if(mix(hash), equal);
+		}
+
+		template <class Equal>
+		const_iterator find_hashed(size_t hash, Equal equal) const
+		{
+			return find_if(mix(hash), equal);
+		}
+
+		size_type erase(const Key &key)
+		{
+			auto it = find_key(key, hash_key(key));
+			if(it == end())
+			{
+				return 0;
+			}
+			erase_at(it);
+			return 1;
+		}
+
+		iterator erase(iterator it)
+		{
+			erase_at(it);
+			return ++it;
+		}
+
+		std::pair<iterator, bool> insert(const value_type &val)
+		{
+			return try_emplace_hashed(hash_key(val.first), val.first, val.second);
+		}
+
+		std::pair<iterator, bool> insert(value_type &&val)
+		{
+			// the key is const, so it can only be copied
+			return try_emplace_hashed(hash_key(val.first), val.first, std::move(val.second));
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			// the key is not known until the element is constructed
+			typename std::aligned_storage<sizeof(slot), alignof(slot)>::type storage;
+			slot &tmp_slot = *reinterpret_cast<slot*>(&storage);
+			value_type &value = *new (&tmp_slot.value) value_type(std::forward<Args>(args)...);
+			size_t hash = hash_key(value.first);
+			auto it = find_key(value.first, hash);
+			if(it != end())
+			{
+				value.~value_type();
+				return std::make_pair(it, false);
+			}
+			size_t index;
+			try{
+				index = prepare_insert(hash);
+			}catch(...)
+			{
+				value.~value_type();
+				throw;
+			}
+			relocate(slots[index], tmp_slot);
+			slots[index].hash = hash;
+			commit_insert(index);
+			return std::make_pair(make_iterator(index), true);
+		}
+
+		template <class KeyArg, class ValueArg, class = typename std::enable_if<std::is_same<typename std::decay<KeyArg>::type, Key>::value>::type>
+		std::pair<iterator, bool> emplace(KeyArg &&key, ValueArg &&value)
+		{
+			size_t hash = hash_key(key);
+			return try_emplace_hashed(hash, std::forward<KeyArg>(key), std::forward<ValueArg>(value));
+		}
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last)
+		{
+			for(; first != last; ++first)
+			{
+				insert(*first);
+			}
+		}
+
+		void swap(flat_hash_map &obj) noexcept
+		{
+			std::swap(ctrls, obj.ctrls);
+			std::swap(slots, obj.slots);
+			std::swap(cap, obj.cap);
+			std::swap(count, obj.count);
+			std::swap(deleted, obj.deleted);
+			std::swap(old_ctrls, obj.old_ctrls);
+			std::swap(old_slots, obj.old_slots);
+			std::swap(old_cap, obj.old_cap);
+			std::swap(old_count, obj.old_count);
+			std::swap(old_pos, obj.old_pos);
+		}
+
+		~flat_hash_map()
+		{
+			destroy_all();
+			deallocate();
+		}
+	};
+}
+
+#endif
@@ -2,9 +2,9 @@
 #define HYBRID_MAP_H_INCLUDED
 
 #include "hybrid_cont.h"
+#include "flat_hash_map.h"
+#include "btree_map.h"
 
-#include <unordered_map>
-#include <map>
 #include <cstring>
 
 namespace aux
@@ -12,8 +12,8 @@ namespace aux
 	template <class Key, class Value>
 	class hybrid_map
 	{
-		typedef std::unordered_map<Key, Value> unordered_map;
-		typedef std::map<Key, Value> ordered_map;
+		typedef flat_hash_map<Key, Value> unordered_map;
+		typedef btree_map<Key, Value> ordered_map;
 		union {
 			unordered_map umap;
 			ordered_map omap;
@@ -294,7 +294,18 @@ namespace aux
 			{
 				return -1;
 			}else{
-				return static_cast<size_type>(umap.bucket_count() * umap.max_load_factor());
+				return umap.capacity();
+			}
+		}
+
+		// Bytes allocated by the container itself
+		size_t memory_size() const
+		{
+			if(ordered)
+			{
+				return omap.memory_size();
+			}else{
+				return umap.memory_size();
 			}
 		}
 
@@ -306,6 +317,23 @@ namespace aux
 			}
 		}
 
+		// Erasing from an ordered map moves other elements, so only positions in an unordered map are checked
+		bool alive(const iterator &it) const
+		{
+			return ordered || umap.alive(static_cast<const typename unordered_map::iterator&>(it));
+		}
+
+		// Only unordered maps are rehashed incrementally
+		bool rehashing() const
+		{
+			return !ordered && umap.rehashing();
+		}
+
+		bool rehash_step(size_type budget)
+		{
+			return !ordered && umap.rehash_step(budget);
+		}
+
 		void clear()
 		{
 			if(ordered)
@@ -336,6 +364,60 @@ namespace aux
 			}
 		}
 
+		// Only for ordered maps; the end is returned otherwise
+		iterator lower_bound(const Key &key)
+		{
+			if(ordered)
+			{
+				return omap.lower_bound(key);
+			}else{
+				return umap.end();
+			}
+		}
+
+		const_iterator lower_bound(const Key &key) const
+		{
+			if(ordered)
+			{
+				return omap.lower_bound(key);
+			}else{
+				return umap.end();
+			}
+		}
+
+		iterator upper_bound(const Key &key)
+		{
+			if(ordered)
+			{
+				return omap.upper_bound(key);
+			}else{
+				return umap.end();
+			}
+		}
+
+		const_iterator upper_bound(const Key &key) const
+		{
+			if(ordered)
+			{
+				return omap.upper_bound(key);
+			}else{
+				return umap.end();
+			}
+		}
+
+		// Only for unordered maps
+		template <class Equal>
+		iterator find_hashed(size_t hash, Equal equal)
+		{
+			return umap.find_hashed(hash, equal);
+		}
+
+		template <class Equal>
+		const_iterator find_hashed(size_t hash, Equal equal) const
+		{
+			return umap.find_hashed(hash, equal);
+		}
+
 		size_type erase(const Key &key)
 		{
 			if(ordered)
@@ -403,10 +485,13 @@ namespace aux
 			{
 				if(this->ordered)
 				{
-					std::unordered_map<Key, Value> map(std::make_move_iterator(omap.begin()), std::make_move_iterator(omap.end()));
+					// the table is allocated only once
+					unordered_map map;
+					map.reserve(omap.size());
+					map.insert(std::make_move_iterator(omap.begin()), std::make_move_iterator(omap.end()));
 					*this = std::move(map);
 				}else{
-					std::map<Key, Value> map(std::make_move_iterator(umap.begin()), std::make_move_iterator(umap.end()));
+					ordered_map map(std::make_move_iterator(umap.begin()), std::make_move_iterator(umap.end()));
 					*this = std::move(map);
 				}
 				return true;
@@ -418,10 +503,10 @@ namespace aux
 		{
 			if(ordered && map.ordered)
 			{
-				std::swap(omap, map.omap);
+				omap.swap(map.omap);
 			}else if(!ordered && !map.ordered)
 			{
-				std::swap(umap, map.umap);
+				umap.swap(map.umap);
 			}else{
 				hybrid_map<Key, Value> tmp(std::move(map));
 				map = std::move(*this);
@@ -319,6 +319,16 @@ namespace aux
 			}
 		}
 
+		bool alive(const iterator &it) const
+		{
+			if(ordered)
+			{
+				return bpool.alive(it);
+			}else{
+				return lpool.alive(it);
+			}
+		}
+
 		size_type index_of(iterator it) const
 		{
 			if(ordered)
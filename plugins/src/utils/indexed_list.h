@@ -0,0 +1,636 @@
+#ifndef INDEXED_LIST_H_INCLUDED
+#define INDEXED_LIST_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aux
+{
+	// Sequence stored in a randomized balanced tree ordered by position, where every node counts its subtree.
+	// Accessing an element by its index takes logarithmic time, and insertions or erasures
+	// do not invalidate iterators to other elements, like in std::list.
+	// The nodes are allocated in chunks and reused after an element is erased.
+	template <class Type>
+	class indexed_list
+	{
+	public:
+		typedef Type value_type;
+		typedef Type &reference;
+		typedef const Type &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+	private:
+		struct node
+		{
+			// the parent of the root is the header, which has the root as its left child
+			node *parent;
+			node *left;
+			node *right;
+			size_t size;
+			uint32_t priority;
+			typename std::aligned_storage<sizeof(Type), alignof(Type)>::type storage;
+
+			Type &value()
+			{
+				return *reinterpret_cast<Type*>(&storage);
+			}
+		};
+
+		typedef typename std::aligned_storage<sizeof(node), alignof(node)>::type node_storage;
+
+		static constexpr size_t min_chunk = 16;
+		static constexpr size_t max_chunk = 1024;
+
+		node header;
+		std::vector<std::unique_ptr<node_storage[]>> chunks;
+		size_t chunk_capacity = 0;
+		size_t chunk_used = 0;
+		node *free_nodes = nullptr;
+		size_t allocated = 0;
+		uint32_t seed = 2463534242u;
+
+		template <bool Const>
+		class basic_iterator
+		{
+			friend class indexed_list;
+
+			template <bool OtherConst>
+			friend class basic_iterator;
+
+			node *n;
+
+			basic_iterator(node *n) : n(n)
+			{
+
+			}
+
+		public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef typename indexed_list::value_type value_type;
+			typedef typename indexed_list::difference_type difference_type;
+			typedef typename std::conditional<Const, const Type*, Type*>::type pointer;
+			typedef typename std::conditional<Const, const Type&, Type&>::type reference;
+
+			basic_iterator() : n(nullptr)
+			{
+
+			}
+
+			template <bool OtherConst, class = typename std::enable_if<Const && !OtherConst>::type>
+			basic_iterator(const basic_iterator<OtherConst> &it) : n(it.n)
+			{
+
+			}
+
+			reference operator*() const
+			{
+				return n->value();
+			}
+
+			pointer operator->() const
+			{
+				return &n->value();
+			}
+
+			basic_iterator &operator++()
+			{
+				n = next(n);
+				return *this;
+			}
+
+			basic_iterator operator++(int)
+			{
+				auto tmp = *this;
+				n = next(n);
+				return tmp;
+			}
+
+			basic_iterator &operator--()
+			{
+				n = previous(n);
+				return *this;
+			}
+
+			basic_iterator operator--(int)
+			{
+				auto tmp = *this;
+				n = previous(n);
+				return tmp;
+			}
+
+			bool operator==(const basic_iterator &obj) const
+			{
+				return n == obj.n;
+			}
+
+			bool operator!=(const basic_iterator &obj) const
+			{
+				return n != obj.n;
+			}
+		};
+
+	public:
+		typedef basic_iterator<false> iterator;
+		typedef basic_iterator<true> const_iterator;
+
+	private:
+		static size_t size_of(const node *n)
+		{
+			return n != nullptr ? n->size : 0;
+		}
+
+		static void update(node *n)
+		{
+			n->size = size_of(n->left) + size_of(n->right) + 1;
+		}
+
+		static node *next(node *n)
+		{
+			if(n->right != nullptr)
+			{
+				n = n->right;
+				while(n->left != nullptr)
+				{
+					n = n->left;
+				}
+				return n;
+			}
+			// the header is reached from the last node, since the tree is its left subtree
+			while(n == n->parent->right)
+			{
+				n = n->parent;
+			}
+			return n->parent;
+		}
+
+		static node *previous(node *n)
+		{
+			if(n->left != nullptr)
+			{
+				n = n->left;
+				while(n->right != nullptr)
+				{
+					n = n->right;
+				}
+				return n;
+			}
+			while(n == n->parent->left)
+			{
+				n = n->parent;
+			}
+			return n->parent;
+		}
+
+		node *root() const
+		{
+			return header.left;
+		}
+
+		uint32_t next_priority()
+		{
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			return seed;
+		}
+
+		node *allocate()
+		{
+			node *n;
+			if(free_nodes != nullptr)
+			{
+				n = free_nodes;
+				free_nodes = n->parent;
+			}else{
+				if(chunk_used == chunk_capacity)
+				{
+					size_t capacity = chunks.empty() ? min_chunk : chunk_capacity < max_chunk ? chunk_capacity * 2 : max_chunk;
+					chunks.emplace_back(new node_storage[capacity]);
+					chunk_capacity = capacity;
+					chunk_used = 0;
+				}
+				n = reinterpret_cast<node*>(&chunks.back()[chunk_used++]);
+			}
+			allocated++;
+			return n;
+		}
+
+		void deallocate(node *n)
+		{
+			n->parent = free_nodes;
+			free_nodes = n;
+			allocated--;
+		}
+
+		// replaces the child of a node's parent
+		static void replace_child(node *n, node *child)
+		{
+			node *parent = n->parent;
+			if(parent->left == n)
+			{
+				parent->left = child;
+			}else{
+				parent->right = child;
+			}
+			if(child != nullptr)
+			{
+				child->parent = parent;
+			}
+		}
+
+		// moves a node in the place of its parent
+		static void rotate_up(node *n)
+		{
+			node *parent = n->parent;
+			replace_child(parent, n);
+			if(parent->left == n)
+			{
+				parent->left = n->right;
+				if(n->right != nullptr)
+				{
+					n->right->parent = parent;
+				}
+				n->right = parent;
+			}else{
+				parent->right = n->left;
+				if(n->left != nullptr)
+				{
+					n->left->parent = parent;
+				}
+				n->left = parent;
+			}
+			parent->parent = n;
+			update(parent);
+			update(n);
+		}
+
+		template <class... Args>
+		iterator emplace_node(const_iterator position, Args&&... args)
+		{
+			node *n = allocate();
+			try{
+				new (&n->storage) Type(std::forward<Args>(args)...);
+			}catch(...)
+			{
+				deallocate(n);
+				throw;
+			}
+			n->left = n->right = nullptr;
+			n->size = 1;
+			n->priority = next_priority();
+
+			// the new node is placed right before the position
+			node *pos = position.n;
+			if(pos->left == nullptr)
+			{
+				pos->left = n;
+			}else{
+				pos = pos->left;
+				while(pos->right != nullptr)
+				{
+					pos = pos->right;
+				}
+				pos->right = n;
+			}
+			n->parent = pos;
+			for(node *p = pos; p != &header; p = p->parent)
+			{
+				p->size++;
+			}
+			header.size++;
+
+			while(n->parent != &header && n->priority > n->parent->priority)
+			{
+				rotate_up(n);
+			}
+			return iterator(n);
+		}
+
+		void destroy(node *n)
+		{
+			while(n != nullptr)
+			{
+				destroy(n->right);
+				node *left = n->left;
+				n->value().~Type();
+				deallocate(n);
+				n = left;
+			}
+		}
+
+		void reset_header()
+		{
+			header.parent = nullptr;
+			header.left = nullptr;
+			header.right = nullptr;
+			header.size = 0;
+		}
+
+	public:
+		indexed_list()
+		{
+			reset_header();
+		}
+
+		indexed_list(const indexed_list &obj) : indexed_list()
+		{
+			insert(end(), obj.begin(), obj.end());
+		}
+
+		indexed_list(indexed_list &&obj) noexcept : indexed_list()
+		{
+			swap(obj);
+		}
+
+		template <class InputIterator>
+		indexed_list(InputIterator first, InputIterator last) : indexed_list()
+		{
+			insert(end(), first, last);
+		}
+
+		indexed_list &operator=(const indexed_list &obj)
+		{
+			if(this != &obj)
+			{
+				indexed_list tmp(obj);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		indexed_list &operator=(indexed_list &&obj) noexcept
+		{
+			if(this != &obj)
+			{
+				indexed_list tmp(std::move(obj));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		iterator begin()
+		{
+			node *n = &header;
+			while(n->left != nullptr)
+			{
+				n = n->left;
+			}
+			return iterator(n);
+		}
+
+		iterator end()
+		{
+			return iterator(&header);
+		}
+
+		const_iterator begin() const
+		{
+			return const_cast<indexed_list*>(this)->begin();
+		}
+
+		const_iterator end() const
+		{
+			return const_cast<indexed_list*>(this)->end();
+		}
+
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		size_type size() const
+		{
+			return header.size;
+		}
+
+		bool empty() const
+		{
+			return header.size == 0;
+		}
+
+		// Bytes allocated for the nodes, including the ones not in use
+		size_t memory_size() const
+		{
+			size_t count = 0, capacity = min_chunk;
+			for(size_t i = 0; i < chunks.size(); i++)
+			{
+				count += capacity;
+				capacity = capacity < max_chunk ? capacity * 2 : max_chunk;
+			}
+			return count * sizeof(node_storage);
+		}
+
+		// The position of the element with the index, or the end if there is none
+		iterator iter_at(size_t index)
+		{
+			node *n = root();
+			while(n != nullptr)
+			{
+				size_t left = size_of(n->left);
+				if(index < left)
+				{
+					n = n->left;
+				}else if(index == left)
+				{
+					return iterator(n);
+				}else{
+					index -= left + 1;
+					n = n->right;
+				}
+			}
+			return end();
+		}
+
+		const_iterator iter_at(size_t index) const
+		{
+			return const_cast<indexed_list*>(this)->iter_at(index);
+		}
+
+		// The number of elements before the position
+		size_t index_of(const_iterator position) const
+		{
+			node *n = position.n;
+			size_t index = size_of(n->left);
+			while(n != &header)
+			{
+				node *parent = n->parent;
+				if(parent->right == n)
+				{
+					index += size_of(parent->left) + 1;
+				}
+				n = parent;
+			}
+			return index;
+		}
+
+		reference operator[](size_t index)
+		{
+			return *iter_at(index);
+		}
+
+		const_reference operator[](size_t index) const
+		{
+			return *iter_at(index);
+		}
+
+		reference front()
+		{
+			return *begin();
+		}
+
+		reference back()
+		{
+			return *--end();
+		}
+
+		iterator insert(const_iterator position, const Type &value)
+		{
+			return emplace_node(position, value);
+		}
+
+		iterator insert(const_iterator position, Type &&value)
+		{
+			return emplace_node(position, std::move(value));
+		}
+
+		template <class... Args>
+		iterator emplace(const_iterator position, Args&&... args)
+		{
+			return emplace_node(position, std::forward<Args>(args)...);
+		}
+
+		template <class InputIterator>
+		iterator insert(const_iterator position, InputIterator first, InputIterator last)
+		{
+			iterator result(position.n);
+			bool inserted = false;
+			for(; first != last; ++first)
+			{
+				iterator it = emplace_node(position, *first);
+				if(!inserted)
+				{
+					result = it;
+					inserted = true;
+				}
+			}
+			return result;
+		}
+
+		void push_back(const Type &value)
+		{
+			emplace_node(end(), value);
+		}
+
+		void push_back(Type &&value)
+		{
+			emplace_node(end(), std::move(value));
+		}
+
+		void push_front(const Type &value)
+		{
+			emplace_node(begin(), value);
+		}
+
+		void push_front(Type &&value)
+		{
+			emplace_node(begin(), std::move(value));
+		}
+
+		iterator erase(const_iterator position)
+		{
+			node *n = position.n;
+			node *following = next(n);
+			// the node is moved down until it can be replaced by its only child
+			while(n->left != nullptr && n->right != nullptr)
+			{
+				rotate_up(n->left->priority > n->right->priority ? n->left : n->right);
+			}
+			node *child = n->left != nullptr ? n->left : n->right;
+			replace_child(n, child);
+			for(node *p = n->parent; p != &header; p = p->parent)
+			{
+				p->size--;
+			}
+			header.size--;
+			n->value().~Type();
+			deallocate(n);
+			return iterator(following);
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			while(first != last)
+			{
+				first = erase(first);
+			}
+			return iterator(last.n);
+		}
+
+		void pop_front()
+		{
+			erase(begin());
+		}
+
+		void pop_back()
+		{
+			erase(--end());
+		}
+
+		void clear()
+		{
+			destroy(root());
+			reset_header();
+			chunks.clear();
+			chunk_capacity = 0;
+			chunk_used = 0;
+			free_nodes = nullptr;
+		}
+
+		void swap(indexed_list &obj) noexcept
+		{
+			std::swap(header, obj.header);
+			if(header.left != nullptr)
+			{
+				header.left->parent = &header;
+			}
+			if(obj.header.left != nullptr)
+			{
+				obj.header.left->parent = &obj.header;
+			}
+			chunks.swap(obj.chunks);
+			std::swap(chunk_capacity, obj.chunk_capacity);
+			std::swap(chunk_used, obj.chunk_used);
+			std::swap(free_nodes, obj.free_nodes);
+			std::swap(allocated, obj.allocated);
+			std::swap(seed, obj.seed);
+		}
+
+		~indexed_list()
+		{
+			destroy(root());
+		}
+	};
+}
+
+namespace std
+{
+	template <class Type>
+	void swap(::aux::indexed_list<Type> &a, ::aux::indexed_list<Type> &b) noexcept
+	{
+		a.swap(b);
+	}
+}
+
+#endif
@@ -30,16 +30,18 @@ namespace aux
 			std::ptrdiff_t next;
 			std::ptrdiff_t previous;
 			bool assigned;
+			// changed when the element is erased, so old iterators to the slot can be detected
+			unsigned int generation;
 			union {
 				Type value;
 			};
 
-			element_type(std::ptrdiff_t previous, std::ptrdiff_t next) : previous(previous), next(next), assigned(false)
+			element_type(std::ptrdiff_t previous, std::ptrdiff_t next) : previous(previous), next(next), assigned(false), generation(0)
 			{
 
 			}
 
-			element_type(const element_type &obj) : assigned(obj.assigned), next(obj.next), previous(obj.previous)
+			element_type(const element_type &obj) : assigned(obj.assigned), generation(obj.generation), next(obj.next), previous(obj.previous)
 			{
 				if(assigned)
 				{
@@ -47,7 +49,7 @@ namespace aux
 				}
 			}
 
-			element_type(element_type &&obj) noexcept(noexcept(new(nullptr) Type(std::move(obj.value)))) : assigned(obj.assigned), next(obj.next), previous(obj.previous)
+			element_type(element_type &&obj) noexcept(noexcept(new(nullptr) Type(std::move(obj.value)))) : assigned(obj.assigned), generation(obj.generation), next(obj.next), previous(obj.previous)
 			{
 				if(assigned)
 				{
@@ -70,6 +72,7 @@ namespace aux
 						new (&value) Type(obj.value);
 					}
 					assigned = obj.assigned;
+					generation = obj.generation;
 					next = obj.next;
 					previous = obj.previous;
 				}
@@ -91,6 +94,7 @@ namespace aux
 						new (&value) Type(std::move(obj.value));
 					}
 					assigned = obj.assigned;
+					generation = obj.generation;
 					next = obj.next;
 					previous = obj.previous;
 				}
@@ -112,6 +116,7 @@ namespace aux
 		{
 			friend class linked_pool<Type>;
 			element_type *elem;
+			unsigned int generation;
 
 		public:
 			typedef std::ptrdiff_t difference_type;
@@ -120,12 +125,12 @@ namespace aux
 			typedef Type &reference;
 			typedef std::bidirectional_iterator_tag iterator_category;
 
-			iterator() noexcept : elem(nullptr)
+			iterator() noexcept : elem(nullptr), generation(0)
 			{
 
 			}
 
-			iterator(element_type *elem) noexcept : elem(elem)
+			iterator(element_type *elem) noexcept : elem(elem), generation(elem ? elem->generation : 0)
 			{
 
 			}
@@ -147,6 +152,7 @@ namespace aux
 					elem = nullptr;
 				}else{
 					elem += elem->next;
+					generation = elem->generation;
 				}
 				return *this;
 			}
@@ -165,6 +171,7 @@ namespace aux
 					elem = nullptr;
 				}else{
 					elem += elem->previous;
+					generation = elem->generation;
 				}
 				return *this;
 			}
@@ -448,6 +455,7 @@ namespace aux
 			element_type &elem = *pos.elem;
 			size_t index = unlink<&linked_pool::first_set, &linked_pool::last_set>(elem);
 			elem.assigned = false;
+			++elem.generation;
 			elem.value.~Type();
 			link<&linked_pool::first_unset, &linked_pool::last_unset>(elem, index);
 			--count;
@@ -591,6 +599,12 @@ namespace aux
 			return count;
 		}
 
+		// Whether the element at the position was not erased since the position was obtained
+		bool alive(const iterator &it) const
+		{
+			return it.elem == nullptr || (it.elem->assigned && it.elem->generation == it.generation);
+		}
+
 		void swap(linked_pool<Type> &obj)
 		{
 			std::swap(data, obj.data);
@@ -0,0 +1,120 @@
+#ifndef PARALLEL_SORT_H_INCLUDED
+#define PARALLEL_SORT_H_INCLUDED
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace aux
+{
+	namespace impl
+	{
+		// Runs the tasks on separate threads, or on the calling one if a thread cannot be started
+		inline void run_parallel(std::vector<std::function<void()>> &tasks)
+		{
+			std::vector<std::thread> workers;
+			workers.reserve(tasks.size());
+			std::exception_ptr error;
+			std::mutex lock;
+			auto run = [&](std::function<void()> &task)
+			{
+				try{
+					task();
+				}catch(...)
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					if(!error)
+					{
+						error = std::current_exception();
+					}
+				}
+			};
+			size_t started = 1;
+			try{
+				for(; started < tasks.size(); started++)
+				{
+					workers.emplace_back(run, std::ref(tasks[started]));
+				}
+			}catch(const std::system_error&)
+			{
+
+			}
+			run(tasks[0]);
+			for(size_t i = started; i < tasks.size(); i++)
+			{
+				run(tasks[i]);
+			}
+			for(auto &worker : workers)
+			{
+				worker.join();
+			}
+			if(error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+	// Sorts the chunks of the range on separate threads and then merges them.
+	// The comparison must be safe to call from multiple threads at once.
+	template <class Iterator, class Compare>
+	void parallel_sort(Iterator first, Iterator last, Compare comp, bool stable, size_t min_chunk = 32768)
+	{
+		size_t count = std::distance(first, last);
+		size_t chunks = std::min<size_t>(std::thread::hardware_concurrency(), count / min_chunk);
+		if(chunks < 2)
+		{
+			if(stable)
+			{
+				std::stable_sort(first, last, comp);
+			}else{
+				std::sort(first, last, comp);
+			}
+			return;
+		}
+
+		std::vector<Iterator> bounds;
+		for(size_t i = 0; i <= chunks; i++)
+		{
+			bounds.push_back(first + count * i / chunks);
+		}
+
+		std::vector<std::function<void()>> tasks;
+		for(size_t i = 0; i < chunks; i++)
+		{
+			Iterator begin = bounds[i], end = bounds[i + 1];
+			tasks.emplace_back([=]() mutable
+			{
+				if(stable)
+				{
+					std::stable_sort(begin, end, comp);
+				}else{
+					std::sort(begin, end, comp);
+				}
+			});
+		}
+		impl::run_parallel(tasks);
+
+		// the merges are stable, so the order of equal elements is kept in the whole range
+		for(size_t width = 1; width < chunks; width *= 2)
+		{
+			tasks.clear();
+			for(size_t i = 0; i + width < chunks; i += 2 * width)
+			{
+				Iterator begin = bounds[i], middle = bounds[i + width], end = bounds[std::min(i + 2 * width, chunks)];
+				tasks.emplace_back([=]() mutable
+				{
+					std::inplace_merge(begin, middle, end, comp);
+				});
+			}
+			impl::run_parallel(tasks);
+		}
+	}
+}
+
+#endif
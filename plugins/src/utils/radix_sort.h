@@ -0,0 +1,49 @@
+#ifndef RADIX_SORT_H_INCLUDED
+#define RADIX_SORT_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace aux
+{
+	// Stable LSD radix sort of positions by keys made of unsigned 32-bit parts, one byte per pass.
+	// The key of the position i is stored in keys[i * key_size], most significant part first.
+	inline void radix_sort(std::vector<size_t> &order, const std::vector<uint32_t> &keys, size_t key_size)
+	{
+		std::vector<size_t> buffer(order.size());
+		size_t counts[256];
+		for(size_t part = key_size; part-- > 0; )
+		{
+			for(unsigned int shift = 0; shift < 32; shift += 8)
+			{
+				std::fill(std::begin(counts), std::end(counts), 0);
+				for(size_t pos : order)
+				{
+					counts[(keys[pos * key_size + part] >> shift) & 0xFF]++;
+				}
+				if(counts[(keys[order[0] * key_size + part] >> shift) & 0xFF] == order.size())
+				{
+					// all keys have the same byte
+					continue;
+				}
+				size_t total = 0;
+				for(size_t &count : counts)
+				{
+					size_t next = total + count;
+					count = total;
+					total = next;
+				}
+				for(size_t pos : order)
+				{
+					buffer[counts[(keys[pos * key_size + part] >> shift) & 0xFF]++] = pos;
+				}
+				order.swap(buffer);
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,231 @@
+#ifndef REGION_ALLOCATOR_H_INCLUDED
+#define REGION_ALLOCATOR_H_INCLUDED
+
+#include <cstddef>
+#include <new>
+
+namespace aux
+{
+	// Bump allocator for short-lived objects. Memory is taken from large chunks,
+	// and a chunk is reused as a whole once all objects allocated in it are freed.
+	class region
+	{
+		struct chunk
+		{
+			region *owner;
+			size_t live;
+			unsigned char *top;
+			unsigned char *end;
+			chunk *prev;
+			chunk *next;
+
+			unsigned char *data()
+			{
+				return reinterpret_cast<unsigned char*>(this) + header_size;
+			}
+		};
+
+	public:
+		static constexpr size_t alignment = alignof(std::max_align_t);
+
+	private:
+		static constexpr size_t header_size = (sizeof(chunk) + alignment - 1) / alignment * alignment;
+		static constexpr size_t prefix_size = (sizeof(chunk*) + alignment - 1) / alignment * alignment;
+
+		size_t chunk_size;
+		size_t max_spare;
+		chunk *current = nullptr;
+		chunk *retired = nullptr;
+		chunk *spare = nullptr;
+		size_t spare_count = 0;
+
+		static void unlink(chunk *&list, chunk *c)
+		{
+			if(c->prev)
+			{
+				c->prev->next = c->next;
+			}else{
+				list = c->next;
+			}
+			if(c->next)
+			{
+				c->next->prev = c->prev;
+			}
+			c->prev = c->next = nullptr;
+		}
+
+		static void link(chunk *&list, chunk *c)
+		{
+			c->prev = nullptr;
+			c->next = list;
+			if(list)
+			{
+				list->prev = c;
+			}
+			list = c;
+		}
+
+		void next_chunk()
+		{
+			chunk *c;
+			if(spare)
+			{
+				c = spare;
+				unlink(spare, c);
+				--spare_count;
+			}else{
+				c = static_cast<chunk*>(::operator new(header_size + chunk_size));
+				c->owner = this;
+				c->end = c->data() + chunk_size;
+				c->prev = c->next = nullptr;
+			}
+			c->live = 0;
+			c->top = c->data();
+			if(current)
+			{
+				link(retired, current);
+			}
+			current = c;
+		}
+
+		void recycle(chunk *c)
+		{
+			unlink(retired, c);
+			if(spare_count < max_spare)
+			{
+				link(spare, c);
+				++spare_count;
+			}else{
+				::operator delete(c);
+			}
+		}
+
+		static void free_list(chunk *&list)
+		{
+			while(list)
+			{
+				chunk *c = list;
+				unlink(list, c);
+				if(c->live == 0)
+				{
+					::operator delete(c);
+				}else{
+					c->owner = nullptr;
+				}
+			}
+		}
+
+	public:
+		explicit region(size_t chunk_size = 16384, size_t max_spare = 4) : chunk_size(chunk_size), max_spare(max_spare)
+		{
+
+		}
+
+		region(const region&) = delete;
+		region &operator=(const region&) = delete;
+
+		void *allocate(size_t size)
+		{
+			size_t total = prefix_size + (size + alignment - 1) / alignment * alignment;
+			if(total > chunk_size / 8)
+			{
+				unsigned char *mem = static_cast<unsigned char*>(::operator new(total));
+				*reinterpret_cast<chunk**>(mem) = nullptr;
+				return mem + prefix_size;
+			}
+			if(!current || static_cast<size_t>(current->end - current->top) < total)
+			{
+				next_chunk();
+			}
+			unsigned char *mem = current->top;
+			current->top += total;
+			current->live++;
+			*reinterpret_cast<chunk**>(mem) = current;
+			return mem + prefix_size;
+		}
+
+		static void deallocate(void *ptr)
+		{
+			unsigned char *mem = static_cast<unsigned char*>(ptr) - prefix_size;
+			chunk *c = *reinterpret_cast<chunk**>(mem);
+			if(!c)
+			{
+				::operator delete(mem);
+				return;
+			}
+			if(--c->live == 0)
+			{
+				region *owner = c->owner;
+				if(!owner)
+				{
+					::operator delete(c);
+				}else if(c == owner->current)
+				{
+					c->top = c->data();
+				}else{
+					owner->recycle(c);
+				}
+			}
+		}
+
+		~region()
+		{
+			if(current)
+			{
+				link(retired, current);
+				current = nullptr;
+			}
+			free_list(retired);
+			free_list(spare);
+		}
+	};
+
+	template <class Type>
+	class region_allocator
+	{
+		static_assert(alignof(Type) <= region::alignment, "the type is over-aligned");
+
+		template <class Other>
+		friend class region_allocator;
+
+		region *owner;
+
+	public:
+		typedef Type value_type;
+
+		explicit region_allocator(region &owner) noexcept : owner(&owner)
+		{
+
+		}
+
+		template <class Other>
+		region_allocator(const region_allocator<Other> &obj) noexcept : owner(obj.owner)
+		{
+
+		}
+
+		Type *allocate(size_t n)
+		{
+			return static_cast<Type*>(owner->allocate(n * sizeof(Type)));
+		}
+
+		void deallocate(Type *ptr, size_t n) noexcept
+		{
+			region::deallocate(ptr);
+		}
+
+		template <class Other>
+		bool operator==(const region_allocator<Other> &obj) const noexcept
+		{
+			return owner == obj.owner;
+		}
+
+		template <class Other>
+		bool operator!=(const region_allocator<Other> &obj) const noexcept
+		{
+			return owner != obj.owner;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,556 @@
+#ifndef RING_BUFFER_H_INCLUDED
+#define RING_BUFFER_H_INCLUDED
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace aux
+{
+	// Double-ended sequence stored in a single circular array.
+	// Adding or removing an element at either end takes constant time, and the elements
+	// are accessed by their index like in std::vector. The capacity is always a power of two,
+	// so the physical position of an element is found by masking instead of division.
+	template <class Type>
+	class ring_buffer
+	{
+	public:
+		typedef Type value_type;
+		typedef Type &reference;
+		typedef const Type &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+	private:
+		static constexpr size_t min_capacity = 8;
+
+		std::allocator<Type> alloc;
+		Type *buffer = nullptr;
+		size_t mask = 0;
+		size_t head = 0;
+		size_t count = 0;
+
+		Type *slot(size_t index) const
+		{
+			return buffer + ((head + index) & mask);
+		}
+
+		// Moves the elements to a new array of the given capacity, starting at its beginning
+		void reallocate(size_t capacity)
+		{
+			Type *new_buffer = alloc.allocate(capacity);
+			for(size_t i = 0; i < count; i++)
+			{
+				Type *old = slot(i);
+				::new(static_cast<void*>(new_buffer + i)) Type(std::move(*old));
+				old->~Type();
+			}
+			if(buffer)
+			{
+				alloc.deallocate(buffer, mask + 1);
+			}
+			buffer = new_buffer;
+			mask = capacity - 1;
+			head = 0;
+		}
+
+		void grow()
+		{
+			if(count == capacity())
+			{
+				reallocate(capacity() == 0 ? min_capacity : capacity() * 2);
+			}
+		}
+
+		template <bool Const>
+		class basic_iterator
+		{
+			friend class ring_buffer;
+
+			template <bool OtherConst>
+			friend class basic_iterator;
+
+			typedef typename std::conditional<Const, const ring_buffer*, ring_buffer*>::type owner_type;
+
+			owner_type owner;
+			size_t index;
+
+			basic_iterator(owner_type owner, size_t index) : owner(owner), index(index)
+			{
+
+			}
+
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef typename ring_buffer::value_type value_type;
+			typedef typename ring_buffer::difference_type difference_type;
+			typedef typename std::conditional<Const, const Type*, Type*>::type pointer;
+			typedef typename std::conditional<Const, const Type&, Type&>::type reference;
+
+			basic_iterator() : owner(nullptr), index(0)
+			{
+
+			}
+
+			template <bool OtherConst, class = typename std::enable_if<Const && !OtherConst>::type>
+			basic_iterator(const basic_iterator<OtherConst> &it) : owner(it.owner), index(it.index)
+			{
+
+			}
+
+			reference operator*() const
+			{
+				return *owner->slot(index);
+			}
+
+			pointer operator->() const
+			{
+				return owner->slot(index);
+			}
+
+			reference operator[](difference_type offset) const
+			{
+				return *owner->slot(index + offset);
+			}
+
+			basic_iterator &operator++()
+			{
+				++index;
+				return *this;
+			}
+
+			basic_iterator operator++(int)
+			{
+				auto tmp = *this;
+				++index;
+				return tmp;
+			}
+
+			basic_iterator &operator--()
+			{
+				--index;
+				return *this;
+			}
+
+			basic_iterator operator--(int)
+			{
+				auto tmp = *this;
+				--index;
+				return tmp;
+			}
+
+			basic_iterator &operator+=(difference_type offset)
+			{
+				index += offset;
+				return *this;
+			}
+
+			basic_iterator &operator-=(difference_type offset)
+			{
+				index -= offset;
+				return *this;
+			}
+
+			basic_iterator operator+(difference_type offset) const
+			{
+				return basic_iterator(owner, index + offset);
+			}
+
+			friend basic_iterator operator+(difference_type offset, const basic_iterator &it)
+			{
+				return it + offset;
+			}
+
+			basic_iterator operator-(difference_type offset) const
+			{
+				return basic_iterator(owner, index - offset);
+			}
+
+			difference_type operator-(const basic_iterator &obj) const
+			{
+				return static_cast<difference_type>(index) - static_cast<difference_type>(obj.index);
+			}
+
+			bool operator==(const basic_iterator &obj) const
+			{
+				return owner == obj.owner && index == obj.index;
+			}
+
+			bool operator!=(const basic_iterator &obj) const
+			{
+				return !(*this == obj);
+			}
+
+			bool operator<(const basic_iterator &obj) const
+			{
+				return index < obj.index;
+			}
+
+			bool operator>(const basic_iterator &obj) const
+			{
+				return index > obj.index;
+			}
+
+			bool operator<=(const basic_iterator &obj) const
+			{
+				return index <= obj.index;
+			}
+
+			bool operator>=(const basic_iterator &obj) const
+			{
+				return index >= obj.index;
+			}
+		};
+
+	public:
+		typedef basic_iterator<false> iterator;
+		typedef basic_iterator<true> const_iterator;
+		typedef std::reverse_iterator<iterator> reverse_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+		ring_buffer() = default;
+
+		ring_buffer(const ring_buffer &obj)
+		{
+			if(obj.count > 0)
+			{
+				reserve(obj.count);
+				for(size_t i = 0; i < obj.count; i++)
+				{
+					::new(static_cast<void*>(buffer + i)) Type(*obj.slot(i));
+					++count;
+				}
+			}
+		}
+
+		ring_buffer(ring_buffer &&obj) noexcept : buffer(obj.buffer), mask(obj.mask), head(obj.head), count(obj.count)
+		{
+			obj.buffer = nullptr;
+			obj.mask = 0;
+			obj.head = 0;
+			obj.count = 0;
+		}
+
+		ring_buffer &operator=(const ring_buffer &obj)
+		{
+			if(this != &obj)
+			{
+				ring_buffer(obj).swap(*this);
+			}
+			return *this;
+		}
+
+		ring_buffer &operator=(ring_buffer &&obj) noexcept
+		{
+			if(this != &obj)
+			{
+				ring_buffer(std::move(obj)).swap(*this);
+			}
+			return *this;
+		}
+
+		~ring_buffer()
+		{
+			clear();
+			if(buffer)
+			{
+				alloc.deallocate(buffer, mask + 1);
+			}
+		}
+
+		void swap(ring_buffer &other) noexcept
+		{
+			std::swap(buffer, other.buffer);
+			std::swap(mask, other.mask);
+			std::swap(head, other.head);
+			std::swap(count, other.count);
+		}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		size_t capacity() const
+		{
+			return buffer ? mask + 1 : 0;
+		}
+
+		void reserve(size_t capacity)
+		{
+			if(capacity > this->capacity())
+			{
+				size_t new_capacity = min_capacity;
+				while(new_capacity < capacity)
+				{
+					new_capacity *= 2;
+				}
+				reallocate(new_capacity);
+			}
+		}
+
+		void clear()
+		{
+			while(count > 0)
+			{
+				pop_back();
+			}
+			head = 0;
+		}
+
+		Type &operator[](size_t index)
+		{
+			return *slot(index);
+		}
+
+		const Type &operator[](size_t index) const
+		{
+			return *slot(index);
+		}
+
+		Type &front()
+		{
+			return *slot(0);
+		}
+
+		const Type &front() const
+		{
+			return *slot(0);
+		}
+
+		Type &back()
+		{
+			return *slot(count - 1);
+		}
+
+		const Type &back() const
+		{
+			return *slot(count - 1);
+		}
+
+		template <class... Args>
+		Type &emplace_back(Args&&... args)
+		{
+			grow();
+			Type *ptr = slot(count);
+			::new(static_cast<void*>(ptr)) Type(std::forward<Args>(args)...);
+			++count;
+			return *ptr;
+		}
+
+		template <class... Args>
+		Type &emplace_front(Args&&... args)
+		{
+			grow();
+			size_t new_head = (head - 1) & mask;
+			Type *ptr = buffer + new_head;
+			::new(static_cast<void*>(ptr)) Type(std::forward<Args>(args)...);
+			head = new_head;
+			++count;
+			return *ptr;
+		}
+
+		void push_back(Type &&value)
+		{
+			emplace_back(std::move(value));
+		}
+
+		void push_back(const Type &value)
+		{
+			emplace_back(value);
+		}
+
+		void push_front(Type &&value)
+		{
+			emplace_front(std::move(value));
+		}
+
+		void push_front(const Type &value)
+		{
+			emplace_front(value);
+		}
+
+		void pop_back()
+		{
+			--count;
+			slot(count)->~Type();
+		}
+
+		void pop_front()
+		{
+			buffer[head].~Type();
+			head = (head + 1) & mask;
+			--count;
+		}
+
+		// Only the elements between the position and the nearer end are moved
+		iterator insert(const_iterator position, Type &&value)
+		{
+			size_t index = position.index;
+			if(index == count)
+			{
+				emplace_back(std::move(value));
+			}else if(index == 0)
+			{
+				emplace_front(std::move(value));
+			}else{
+				Type tmp(std::move(value));
+				// the array must not be moved while its elements are passed by reference
+				grow();
+				if(index < count - index)
+				{
+					emplace_front(std::move(*slot(0)));
+					for(size_t i = 1; i < index; i++)
+					{
+						*slot(i) = std::move(*slot(i + 1));
+					}
+				}else{
+					emplace_back(std::move(*slot(count - 1)));
+					for(size_t i = count - 2; i > index; i--)
+					{
+						*slot(i) = std::move(*slot(i - 1));
+					}
+				}
+				*slot(index) = std::move(tmp);
+			}
+			return iterator(this, index);
+		}
+
+		iterator insert(const_iterator position, const Type &value)
+		{
+			return insert(position, Type(value));
+		}
+
+		template <class InputIterator>
+		iterator insert(const_iterator position, InputIterator first, InputIterator last)
+		{
+			size_t index = position.index;
+			for(size_t i = index; first != last; ++first, ++i)
+			{
+				insert(const_iterator(this, i), Type(*first));
+			}
+			return iterator(this, index);
+		}
+
+		iterator erase(const_iterator position)
+		{
+			return erase(position, position + 1);
+		}
+
+		// Only the elements between the range and the nearer end are moved
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			size_t begin = first.index, end = last.index;
+			size_t removed = end - begin;
+			if(removed > 0)
+			{
+				if(begin < count - end)
+				{
+					for(size_t i = begin; i > 0; i--)
+					{
+						*slot(i - 1 + removed) = std::move(*slot(i - 1));
+					}
+					for(size_t i = 0; i < removed; i++)
+					{
+						pop_front();
+					}
+				}else{
+					for(size_t i = end; i < count; i++)
+					{
+						*slot(i - removed) = std::move(*slot(i));
+					}
+					for(size_t i = 0; i < removed; i++)
+					{
+						pop_back();
+					}
+				}
+			}
+			return iterator(this, begin);
+		}
+
+		void resize(size_t new_size)
+		{
+			reserve(new_size);
+			while(count > new_size)
+			{
+				pop_back();
+			}
+			while(count < new_size)
+			{
+				emplace_back();
+			}
+		}
+
+		void resize(size_t new_size, const Type &value)
+		{
+			reserve(new_size);
+			while(count > new_size)
+			{
+				pop_back();
+			}
+			while(count < new_size)
+			{
+				emplace_back(value);
+			}
+		}
+
+		iterator begin()
+		{
+			return iterator(this, 0);
+		}
+
+		iterator end()
+		{
+			return iterator(this, count);
+		}
+
+		const_iterator begin() const
+		{
+			return const_iterator(this, 0);
+		}
+
+		const_iterator end() const
+		{
+			return const_iterator(this, count);
+		}
+
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		reverse_iterator rbegin()
+		{
+			return reverse_iterator(end());
+		}
+
+		reverse_iterator rend()
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rbegin() const
+		{
+			return const_reverse_iterator(end());
+		}
+
+		const_reverse_iterator rend() const
+		{
+			return const_reverse_iterator(begin());
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,763 @@
+#ifndef ROARING_BITMAP_H_INCLUDED
+#define ROARING_BITMAP_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace aux
+{
+	namespace bits
+	{
+		inline unsigned popcount(uint64_t x)
+		{
+#ifdef __GNUC__
+			return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+			x = x - ((x >> 1) & 0x5555555555555555ull);
+			x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+			x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+			return static_cast<unsigned>((x * 0x0101010101010101ull) >> 56);
+#endif
+		}
+
+		// The index of the lowest set bit; x must not be 0
+		inline unsigned lowest(uint64_t x)
+		{
+#ifdef __GNUC__
+			return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+			return popcount((x & (0 - x)) - 1);
+#endif
+		}
+
+		// The index of the highest set bit; x must not be 0
+		inline unsigned highest(uint64_t x)
+		{
+#ifdef __GNUC__
+			return 63 - static_cast<unsigned>(__builtin_clzll(x));
+#else
+			x |= x >> 1;
+			x |= x >> 2;
+			x |= x >> 4;
+			x |= x >> 8;
+			x |= x >> 16;
+			x |= x >> 32;
+			return popcount(x) - 1;
+#endif
+		}
+	}
+
+	// Set of 32-bit integers, split into chunks by the upper 16 bits of the values.
+	// A chunk with few elements stores their lower 16 bits in a sorted array,
+	// and a dense chunk uses a bitmap of 65536 bits instead, so a member costs at most 2 bytes.
+	// Set operations between bitmaps process whole 64-bit words in loops simple enough to be vectorized.
+	class roaring_bitmap
+	{
+	public:
+		typedef uint32_t value_type;
+		typedef uint32_t reference;
+		typedef uint32_t const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		enum class set_op
+		{
+			unite,
+			intersect,
+			subtract,
+			exclude
+		};
+
+	private:
+		static constexpr size_t array_limit = 4096;
+		static constexpr size_t bitmap_words = 65536 / 64;
+
+		struct chunk
+		{
+			uint16_t key;
+			uint32_t count = 0;
+			// the elements are in the array unless the bitmap is allocated
+			std::vector<uint16_t> array;
+			std::vector<uint64_t> words;
+
+			chunk(uint16_t key) : key(key)
+			{
+
+			}
+
+			bool is_bitmap() const
+			{
+				return !words.empty();
+			}
+
+			bool contains(uint16_t low) const
+			{
+				if(is_bitmap())
+				{
+					return (words[low >> 6] >> (low & 63)) & 1;
+				}
+				return std::binary_search(array.begin(), array.end(), low);
+			}
+
+			bool add(uint16_t low)
+			{
+				if(is_bitmap())
+				{
+					uint64_t &word = words[low >> 6];
+					uint64_t bit = uint64_t(1) << (low & 63);
+					if(word & bit)
+					{
+						return false;
+					}
+					word |= bit;
+				}else{
+					auto it = std::lower_bound(array.begin(), array.end(), low);
+					if(it != array.end() && *it == low)
+					{
+						return false;
+					}
+					array.insert(it, low);
+				}
+				++count;
+				if(!is_bitmap() && count > array_limit)
+				{
+					to_bitmap();
+				}
+				return true;
+			}
+
+			// Adds the values from low up to (but excluding) high, returning how many were not present
+			size_t add_range(uint32_t low, uint32_t high)
+			{
+				if(!is_bitmap() && count + (high - low) <= array_limit)
+				{
+					size_t added = 0;
+					for(uint32_t value = low; value < high; value++)
+					{
+						if(add(static_cast<uint16_t>(value)))
+						{
+							++added;
+						}
+					}
+					return added;
+				}
+				if(!is_bitmap())
+				{
+					to_bitmap();
+				}
+				size_t first = low >> 6, last = (high - 1) >> 6;
+				uint64_t first_mask = ~uint64_t(0) << (low & 63);
+				uint64_t last_mask = ~uint64_t(0) >> (63 - ((high - 1) & 63));
+				size_t before = 0, after = 0;
+				for(size_t i = first; i <= last; i++)
+				{
+					uint64_t mask = ~uint64_t(0);
+					if(i == first) mask &= first_mask;
+					if(i == last) mask &= last_mask;
+					before += bits::popcount(words[i]);
+					words[i] |= mask;
+					after += bits::popcount(words[i]);
+				}
+				count += static_cast<uint32_t>(after - before);
+				return after - before;
+			}
+
+			bool remove(uint16_t low)
+			{
+				if(is_bitmap())
+				{
+					uint64_t &word = words[low >> 6];
+					uint64_t bit = uint64_t(1) << (low & 63);
+					if(!(word & bit))
+					{
+						return false;
+					}
+					word &= ~bit;
+				}else{
+					auto it = std::lower_bound(array.begin(), array.end(), low);
+					if(it == array.end() || *it != low)
+					{
+						return false;
+					}
+					array.erase(it);
+				}
+				--count;
+				if(is_bitmap() && count <= array_limit)
+				{
+					to_array();
+				}
+				return true;
+			}
+
+			void to_bitmap()
+			{
+				words.assign(bitmap_words, 0);
+				for(uint16_t low : array)
+				{
+					words[low >> 6] |= uint64_t(1) << (low & 63);
+				}
+				std::vector<uint16_t>().swap(array);
+			}
+
+			void to_array()
+			{
+				array.clear();
+				array.reserve(count);
+				for(size_t i = 0; i < bitmap_words; i++)
+				{
+					uint64_t word = words[i];
+					while(word)
+					{
+						array.push_back(static_cast<uint16_t>(i * 64 + bits::lowest(word)));
+						word &= word - 1;
+					}
+				}
+				std::vector<uint64_t>().swap(words);
+			}
+
+			// Picks the smaller representation after the elements were replaced
+			void normalize()
+			{
+				if(is_bitmap())
+				{
+					if(count <= array_limit)
+					{
+						to_array();
+					}
+				}else if(count > array_limit)
+				{
+					to_bitmap();
+				}
+			}
+
+			// The smallest position not below low, or (size_t)-1
+			size_t next(uint32_t low) const
+			{
+				if(is_bitmap())
+				{
+					for(size_t i = low >> 6; i < bitmap_words; i++)
+					{
+						uint64_t word = words[i];
+						if(i == (low >> 6))
+						{
+							word &= ~uint64_t(0) << (low & 63);
+						}
+						if(word)
+						{
+							return i * 64 + bits::lowest(word);
+						}
+					}
+					return -1;
+				}
+				size_t index = std::lower_bound(array.begin(), array.end(), low) - array.begin();
+				return index < array.size() ? index : -1;
+			}
+
+			// The largest position not above low, or (size_t)-1
+			size_t previous(uint32_t low) const
+			{
+				if(is_bitmap())
+				{
+					for(size_t i = (low >> 6) + 1; i > 0; i--)
+					{
+						uint64_t word = words[i - 1];
+						if(i - 1 == (low >> 6) && (low & 63) != 63)
+						{
+							word &= (uint64_t(1) << ((low & 63) + 1)) - 1;
+						}
+						if(word)
+						{
+							return (i - 1) * 64 + bits::highest(word);
+						}
+					}
+					return -1;
+				}
+				size_t index = std::upper_bound(array.begin(), array.end(), low) - array.begin();
+				return index > 0 ? index - 1 : -1;
+			}
+
+			// Positions are array indices, or bit indices in a bitmap
+			size_t first() const
+			{
+				return next(0);
+			}
+
+			size_t last() const
+			{
+				return previous(65535);
+			}
+
+			size_t after(size_t position) const
+			{
+				if(is_bitmap())
+				{
+					return position < 65535 ? next(static_cast<uint32_t>(position + 1)) : -1;
+				}
+				return position + 1 < array.size() ? position + 1 : -1;
+			}
+
+			size_t before(size_t position) const
+			{
+				if(is_bitmap())
+				{
+					return position > 0 ? previous(static_cast<uint32_t>(position - 1)) : -1;
+				}
+				return position > 0 ? position - 1 : -1;
+			}
+
+			uint16_t at(size_t position) const
+			{
+				return is_bitmap() ? static_cast<uint16_t>(position) : array[position];
+			}
+
+			size_t memory_size() const
+			{
+				return array.capacity() * sizeof(uint16_t) + words.capacity() * sizeof(uint64_t);
+			}
+		};
+
+		std::vector<chunk> chunks;
+		size_t total = 0;
+
+		// The index of the first chunk whose key is not below the key
+		size_t chunk_index(uint16_t key) const
+		{
+			return std::lower_bound(chunks.begin(), chunks.end(), key, [](const chunk &c, uint16_t key)
+			{
+				return c.key < key;
+			}) - chunks.begin();
+		}
+
+		static void fill_words(const chunk &c, uint64_t *words)
+		{
+			if(c.is_bitmap())
+			{
+				std::copy(c.words.begin(), c.words.end(), words);
+			}else{
+				std::fill(words, words + bitmap_words, 0);
+				for(uint16_t low : c.array)
+				{
+					words[low >> 6] |= uint64_t(1) << (low & 63);
+				}
+			}
+		}
+
+		static chunk combine(const chunk &a, const chunk &b, set_op op)
+		{
+			chunk result(a.key);
+			if(!a.is_bitmap() && !b.is_bitmap())
+			{
+				auto out = std::back_inserter(result.array);
+				switch(op)
+				{
+					case set_op::unite:
+						std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+						break;
+					case set_op::intersect:
+						std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+						break;
+					case set_op::subtract:
+						std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+						break;
+					case set_op::exclude:
+						std::set_symmetric_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+						break;
+				}
+				result.count = static_cast<uint32_t>(result.array.size());
+				result.normalize();
+				return result;
+			}
+			if((op == set_op::intersect || op == set_op::subtract) && !a.is_bitmap())
+			{
+				// testing the elements of a small array is cheaper than building its bitmap
+				bool keep = op == set_op::subtract;
+				for(uint16_t low : a.array)
+				{
+					if(b.contains(low) != keep)
+					{
+						result.array.push_back(low);
+					}
+				}
+				result.count = static_cast<uint32_t>(result.array.size());
+				return result;
+			}
+			if(op == set_op::intersect && !b.is_bitmap())
+			{
+				for(uint16_t low : b.array)
+				{
+					if(a.contains(low))
+					{
+						result.array.push_back(low);
+					}
+				}
+				result.count = static_cast<uint32_t>(result.array.size());
+				return result;
+			}
+
+			std::vector<uint64_t> left, right;
+			const uint64_t *x, *y;
+			if(a.is_bitmap())
+			{
+				x = a.words.data();
+			}else{
+				left.resize(bitmap_words);
+				fill_words(a, left.data());
+				x = left.data();
+			}
+			if(b.is_bitmap())
+			{
+				y = b.words.data();
+			}else{
+				right.resize(bitmap_words);
+				fill_words(b, right.data());
+				y = right.data();
+			}
+			result.words.resize(bitmap_words);
+			uint64_t *z = result.words.data();
+			switch(op)
+			{
+				case set_op::unite:
+					for(size_t i = 0; i < bitmap_words; i++)
+					{
+						z[i] = x[i] | y[i];
+					}
+					break;
+				case set_op::intersect:
+					for(size_t i = 0; i < bitmap_words; i++)
+					{
+						z[i] = x[i] & y[i];
+					}
+					break;
+				case set_op::subtract:
+					for(size_t i = 0; i < bitmap_words; i++)
+					{
+						z[i] = x[i] & ~y[i];
+					}
+					break;
+				case set_op::exclude:
+					for(size_t i = 0; i < bitmap_words; i++)
+					{
+						z[i] = x[i] ^ y[i];
+					}
+					break;
+			}
+			uint32_t count = 0;
+			for(size_t i = 0; i < bitmap_words; i++)
+			{
+				count += bits::popcount(z[i]);
+			}
+			result.count = count;
+			result.normalize();
+			return result;
+		}
+
+		static size_t intersect_count(const chunk &a, const chunk &b)
+		{
+			if(a.is_bitmap() && b.is_bitmap())
+			{
+				const uint64_t *x = a.words.data(), *y = b.words.data();
+				size_t count = 0;
+				for(size_t i = 0; i < bitmap_words; i++)
+				{
+					count += bits::popcount(x[i] & y[i]);
+				}
+				return count;
+			}
+			const chunk &small = a.is_bitmap() ? b : a;
+			const chunk &other = a.is_bitmap() ? a : b;
+			size_t count = 0;
+			for(uint16_t low : small.array)
+			{
+				if(other.contains(low))
+				{
+					++count;
+				}
+			}
+			return count;
+		}
+
+	public:
+		class const_iterator
+		{
+			friend class roaring_bitmap;
+
+			const roaring_bitmap *owner;
+			size_t index;
+			size_t position;
+
+			const_iterator(const roaring_bitmap *owner, size_t index, size_t position) : owner(owner), index(index), position(position)
+			{
+
+			}
+
+		public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef uint32_t value_type;
+			typedef ptrdiff_t difference_type;
+			typedef const uint32_t *pointer;
+			typedef uint32_t reference;
+
+			const_iterator() : owner(nullptr), index(0), position(0)
+			{
+
+			}
+
+			uint32_t operator*() const
+			{
+				const chunk &c = owner->chunks[index];
+				return (static_cast<uint32_t>(c.key) << 16) | c.at(position);
+			}
+
+			const_iterator &operator++()
+			{
+				position = owner->chunks[index].after(position);
+				if(position == static_cast<size_t>(-1))
+				{
+					++index;
+					position = index < owner->chunks.size() ? owner->chunks[index].first() : 0;
+				}
+				return *this;
+			}
+
+			const_iterator operator++(int)
+			{
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			const_iterator &operator--()
+			{
+				if(index < owner->chunks.size())
+				{
+					position = owner->chunks[index].before(position);
+					if(position != static_cast<size_t>(-1))
+					{
+						return *this;
+					}
+				}
+				--index;
+				position = owner->chunks[index].last();
+				return *this;
+			}
+
+			const_iterator operator--(int)
+			{
+				auto tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			bool operator==(const const_iterator &obj) const
+			{
+				return owner == obj.owner && index == obj.index && position == obj.position;
+			}
+
+			bool operator!=(const const_iterator &obj) const
+			{
+				return !(*this == obj);
+			}
+		};
+
+		typedef const_iterator iterator;
+
+		size_t size() const
+		{
+			return total;
+		}
+
+		bool empty() const
+		{
+			return total == 0;
+		}
+
+		void clear()
+		{
+			chunks.clear();
+			total = 0;
+		}
+
+		bool contains(uint32_t value) const
+		{
+			uint16_t key = static_cast<uint16_t>(value >> 16);
+			size_t index = chunk_index(key);
+			return index < chunks.size() && chunks[index].key == key && chunks[index].contains(static_cast<uint16_t>(value));
+		}
+
+		bool add(uint32_t value)
+		{
+			uint16_t key = static_cast<uint16_t>(value >> 16);
+			size_t index = chunk_index(key);
+			if(index == chunks.size() || chunks[index].key != key)
+			{
+				chunks.emplace(chunks.begin() + index, key);
+			}
+			if(chunks[index].add(static_cast<uint16_t>(value)))
+			{
+				++total;
+				return true;
+			}
+			return false;
+		}
+
+		bool remove(uint32_t value)
+		{
+			uint16_t key = static_cast<uint16_t>(value >> 16);
+			size_t index = chunk_index(key);
+			if(index < chunks.size() && chunks[index].key == key && chunks[index].remove(static_cast<uint16_t>(value)))
+			{
+				--total;
+				if(chunks[index].count == 0)
+				{
+					chunks.erase(chunks.begin() + index);
+				}
+				return true;
+			}
+			return false;
+		}
+
+		// Adds all values from begin up to (but excluding) end.
+		// Whole words are filled at once, but every chunk covered by more than 4096 values
+		// becomes an 8 KiB bitmap, so the full range of values takes 512 MiB.
+		size_t add_range(uint32_t begin, uint32_t end)
+		{
+			size_t added = 0;
+			uint64_t value = begin;
+			while(value < end)
+			{
+				uint16_t key = static_cast<uint16_t>(value >> 16);
+				size_t index = chunk_index(key);
+				if(index == chunks.size() || chunks[index].key != key)
+				{
+					chunks.emplace(chunks.begin() + index, key);
+				}
+				uint64_t chunk_end = std::min<uint64_t>(end, (static_cast<uint64_t>(key) + 1) << 16);
+				added += chunks[index].add_range(static_cast<uint32_t>(value & 0xFFFF), static_cast<uint32_t>(chunk_end - (static_cast<uint64_t>(key) << 16)));
+				value = chunk_end;
+			}
+			total += added;
+			return added;
+		}
+
+		// The first element not below the value
+		const_iterator lower_bound(uint32_t value) const
+		{
+			uint16_t key = static_cast<uint16_t>(value >> 16);
+			size_t index = chunk_index(key);
+			if(index < chunks.size())
+			{
+				if(chunks[index].key == key)
+				{
+					size_t position = chunks[index].next(value & 0xFFFF);
+					if(position != static_cast<size_t>(-1))
+					{
+						return const_iterator(this, index, position);
+					}
+					++index;
+					if(index == chunks.size())
+					{
+						return end();
+					}
+				}
+				return const_iterator(this, index, chunks[index].first());
+			}
+			return end();
+		}
+
+		const_iterator begin() const
+		{
+			return chunks.empty() ? end() : const_iterator(this, 0, chunks[0].first());
+		}
+
+		const_iterator end() const
+		{
+			return const_iterator(this, chunks.size(), 0);
+		}
+
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		// Combines the elements of two sets by a set operation, one pair of chunks at a time
+		static roaring_bitmap combine(const roaring_bitmap &a, const roaring_bitmap &b, set_op op)
+		{
+			roaring_bitmap result;
+			bool keep_a = op != set_op::intersect;
+			bool keep_b = op == set_op::unite || op == set_op::exclude;
+			auto it = a.chunks.begin(), jt = b.chunks.begin();
+			while(it != a.chunks.end() || jt != b.chunks.end())
+			{
+				if(jt == b.chunks.end() || (it != a.chunks.end() && it->key < jt->key))
+				{
+					if(keep_a)
+					{
+						result.chunks.push_back(*it);
+						result.total += it->count;
+					}
+					++it;
+				}else if(it == a.chunks.end() || jt->key < it->key)
+				{
+					if(keep_b)
+					{
+						result.chunks.push_back(*jt);
+						result.total += jt->count;
+					}
+					++jt;
+				}else{
+					chunk c = combine(*it, *jt, op);
+					if(c.count > 0)
+					{
+						result.total += c.count;
+						result.chunks.push_back(std::move(c));
+					}
+					++it;
+					++jt;
+				}
+			}
+			return result;
+		}
+
+		// The size of the intersection, without producing it
+		static size_t intersect_count(const roaring_bitmap &a, const roaring_bitmap &b)
+		{
+			size_t count = 0;
+			auto it = a.chunks.begin(), jt = b.chunks.begin();
+			while(it != a.chunks.end() && jt != b.chunks.end())
+			{
+				if(it->key < jt->key)
+				{
+					++it;
+				}else if(jt->key < it->key)
+				{
+					++jt;
+				}else{
+					count += intersect_count(*it, *jt);
+					++it;
+					++jt;
+				}
+			}
+			return count;
+		}
+
+		size_t memory_size() const
+		{
+			size_t size = chunks.capacity() * sizeof(chunk);
+			for(const auto &c : chunks)
+			{
+				size += c.memory_size();
+			}
+			return size;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,418 @@
+#ifndef SLOT_MAP_POOL_H_INCLUDED
+#define SLOT_MAP_POOL_H_INCLUDED
+
+#include "fixes/linux.h"
+#include "sdk/amx/amx.h"
+#include <memory>
+#include <vector>
+#include <stdexcept>
+
+namespace aux
+{
+	template <class Type, size_t IndexBits>
+	class slot_map_pool;
+
+	// Stores the id of the object in the pool that owns it, so that it can be obtained without a lookup
+	class slot_map_hook
+	{
+		template <class Type, size_t IndexBits>
+		friend class slot_map_pool;
+
+		cell _slot_id = 0;
+
+	public:
+		slot_map_hook() = default;
+
+		slot_map_hook(const slot_map_hook&) noexcept
+		{
+
+		}
+
+		slot_map_hook &operator=(const slot_map_hook&) noexcept
+		{
+			return *this;
+		}
+	};
+
+	// Usage of a pool; the bytes are only an estimate
+	struct pool_stats
+	{
+		size_t live = 0;
+		size_t peak = 0;
+		size_t allocations = 0;
+		size_t frees = 0;
+		size_t bytes = 0;
+	};
+
+	namespace impl
+	{
+		inline unsigned int next_slot_map_seed()
+		{
+			static unsigned int seed = 0;
+			return seed++;
+		}
+	}
+
+	// The id of an object consists of its slot index and the generation of the slot.
+	// The generation is changed every time a slot is freed, so stale ids are rejected.
+	// Free slots are reused in FIFO order, so a slot has to be freed max_generation times
+	// before its generation wraps around and an old id could become valid again.
+	template <class Type, size_t IndexBits = 22>
+	class slot_map_pool
+	{
+		static_assert(IndexBits > 0 && IndexBits < sizeof(cell) * 8 - 2, "invalid number of index bits");
+
+		static constexpr ucell index_mask = (static_cast<ucell>(1) << IndexBits) - 1;
+		static constexpr ucell max_generation = (static_cast<ucell>(1) << (sizeof(cell) * 8 - 1 - IndexBits)) - 1;
+		static constexpr ucell free_bit = static_cast<ucell>(1) << (sizeof(cell) * 8 - 1);
+		static constexpr size_t npos = static_cast<size_t>(-1);
+
+		struct slot
+		{
+			std::shared_ptr<Type> value;
+			ucell id;
+			size_t next_free;
+		};
+
+		std::vector<slot> slots;
+		size_t free_head = npos;
+		size_t free_tail = npos;
+		size_t count = 0;
+		unsigned int seed = impl::next_slot_map_seed();
+		size_t peak = 0;
+		size_t allocations = 0;
+		size_t frees = 0;
+
+		static slot_map_hook &hook(const Type *value)
+		{
+			return const_cast<slot_map_hook&>(static_cast<const slot_map_hook&>(*value));
+		}
+
+		const slot *find_slot(cell id) const
+		{
+			size_t index = static_cast<ucell>(id) & index_mask;
+			if(index < slots.size())
+			{
+				const slot &s = slots[index];
+				if(s.id == static_cast<ucell>(id))
+				{
+					return &s;
+				}
+			}
+			return nullptr;
+		}
+
+		slot *find_slot(cell id)
+		{
+			return const_cast<slot*>(static_cast<const slot_map_pool*>(this)->find_slot(id));
+		}
+
+		slot *find_slot(const Type *value)
+		{
+			if(value == nullptr)
+			{
+				return nullptr;
+			}
+			slot *s = find_slot(hook(value)._slot_id);
+			if(s != nullptr && s->value.get() == value)
+			{
+				return s;
+			}
+			return nullptr;
+		}
+
+		const slot *find_slot(const Type *value) const
+		{
+			return const_cast<slot_map_pool*>(this)->find_slot(value);
+		}
+
+		size_t allocate_slot()
+		{
+			size_t index;
+			if(free_head != npos)
+			{
+				index = free_head;
+				free_head = slots[index].next_free;
+				if(free_head == npos)
+				{
+					free_tail = npos;
+				}
+				slots[index].id &= ~free_bit;
+			}else{
+				index = slots.size();
+				if(index > index_mask)
+				{
+					throw std::length_error("the maximum number of objects in a pool was reached");
+				}
+				ucell generation = (seed * 37 + index) % max_generation + 1;
+				slots.push_back(slot{nullptr, (generation << IndexBits) | static_cast<ucell>(index), npos});
+			}
+			return index;
+		}
+
+		void free_slot(size_t index)
+		{
+			slot &s = slots[index];
+			// the generation is never 0, so no id is 0
+			ucell generation = (s.id >> IndexBits) & max_generation;
+			generation = generation == max_generation ? 1 : generation + 1;
+			s.id = free_bit | (generation << IndexBits) | static_cast<ucell>(index);
+			s.next_free = npos;
+			if(free_tail != npos)
+			{
+				slots[free_tail].next_free = index;
+			}else{
+				free_head = index;
+			}
+			free_tail = index;
+		}
+
+		std::shared_ptr<Type> release_slot(slot &s)
+		{
+			std::shared_ptr<Type> orig(std::move(s.value));
+			hook(orig.get())._slot_id = 0;
+			free_slot(static_cast<ucell>(s.id) & index_mask);
+			--count;
+			++frees;
+			return orig;
+		}
+
+	public:
+		const std::shared_ptr<Type> &add(std::shared_ptr<Type> &&value)
+		{
+			size_t index = allocate_slot();
+			slot &s = slots[index];
+			hook(value.get())._slot_id = static_cast<cell>(s.id);
+			s.value = std::move(value);
+			++count;
+			++allocations;
+			if(count > peak)
+			{
+				peak = count;
+			}
+			return s.value;
+		}
+
+		const std::shared_ptr<Type> &add()
+		{
+			return add(std::make_shared<Type>());
+		}
+
+		const std::shared_ptr<Type> &add(Type&& value)
+		{
+			return add(std::make_shared<Type>(std::move(value)));
+		}
+
+		template <class... Args>
+		const std::shared_ptr<Type> &emplace(Args &&... args)
+		{
+			return add(std::make_shared<Type>(std::forward<Args>(args)...));
+		}
+
+		template <class NewType, class... Args>
+		const std::shared_ptr<Type> &emplace_derived(Args &&... args)
+		{
+			return add(std::make_shared<NewType>(std::forward<Args>(args)...));
+		}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		bool remove(Type *value)
+		{
+			slot *s = find_slot(value);
+			if(s != nullptr)
+			{
+				// the object is destroyed only after the slot is freed
+				auto orig = release_slot(*s);
+				return true;
+			}
+			return false;
+		}
+
+		bool remove_by_id(cell id)
+		{
+			slot *s = find_slot(id);
+			if(s != nullptr)
+			{
+				auto orig = release_slot(*s);
+				return true;
+			}
+			return false;
+		}
+
+		std::shared_ptr<Type> extract(Type *value)
+		{
+			slot *s = find_slot(value);
+			if(s != nullptr)
+			{
+				return release_slot(*s);
+			}
+			return {};
+		}
+
+		// Puts another object in the slot of an existing one, keeping its id
+		std::shared_ptr<Type> replace(Type *value, std::shared_ptr<Type> &&new_value)
+		{
+			slot *s = find_slot(value);
+			if(s != nullptr)
+			{
+				std::shared_ptr<Type> orig(std::move(s->value));
+				hook(orig.get())._slot_id = 0;
+				hook(new_value.get())._slot_id = static_cast<cell>(s->id);
+				s->value = std::move(new_value);
+				return orig;
+			}
+			return {};
+		}
+
+		void clear()
+		{
+			auto tmp = std::move(slots);
+			slots.clear();
+			free_head = free_tail = npos;
+			frees += count;
+			count = 0;
+			seed = impl::next_slot_map_seed();
+			for(auto &s : tmp)
+			{
+				if(s.value)
+				{
+					hook(s.value.get())._slot_id = 0;
+				}
+			}
+		}
+
+		bool get_by_id(cell id, Type *&value) const
+		{
+			const slot *s = find_slot(id);
+			if(s != nullptr)
+			{
+				value = s->value.get();
+				return true;
+			}
+			value = nullptr;
+			return false;
+		}
+
+		bool get_by_id(cell id, const Type *&value) const
+		{
+			const slot *s = find_slot(id);
+			if(s != nullptr)
+			{
+				value = s->value.get();
+				return true;
+			}
+			value = nullptr;
+			return false;
+		}
+
+		bool get_by_id(cell id, std::shared_ptr<Type> &value) const
+		{
+			const slot *s = find_slot(id);
+			if(s != nullptr)
+			{
+				value = s->value;
+				return true;
+			}
+			return false;
+		}
+
+		cell get_id(const Type *value) const
+		{
+			if(value == nullptr)
+			{
+				return 0;
+			}
+			return hook(value)._slot_id;
+		}
+
+		cell get_id(const std::shared_ptr<Type> &value) const
+		{
+			return get_id(value.get());
+		}
+
+		bool contains(const Type *value) const
+		{
+			return find_slot(value) != nullptr;
+		}
+
+		std::shared_ptr<Type> get(Type *value) const
+		{
+			const slot *s = find_slot(value);
+			if(s != nullptr)
+			{
+				return s->value;
+			}
+			return {};
+		}
+
+		template <class Func>
+		void for_each(Func func) const
+		{
+			for(const auto &s : slots)
+			{
+				if(!(s.id & free_bit))
+				{
+					func(s.value);
+				}
+			}
+		}
+
+		// The function returns the number of bytes owned by an object in addition to its size
+		template <class Func>
+		pool_stats get_stats(Func measure) const
+		{
+			pool_stats stats;
+			stats.live = count;
+			stats.peak = peak;
+			stats.allocations = allocations;
+			stats.frees = frees;
+			stats.bytes = slots.capacity() * sizeof(slot);
+			for_each([&](const std::shared_ptr<Type> &value)
+			{
+				stats.bytes += sizeof(Type) + measure(*value);
+			});
+			return stats;
+		}
+
+		void reset_stats()
+		{
+			peak = count;
+			allocations = 0;
+			frees = 0;
+		}
+
+		slot_map_pool() = default;
+
+		slot_map_pool(slot_map_pool<Type, IndexBits> &&obj) : slots(std::move(obj.slots)), free_head(obj.free_head), free_tail(obj.free_tail), count(obj.count), seed(obj.seed), peak(obj.peak), allocations(obj.allocations), frees(obj.frees)
+		{
+			obj.slots.clear();
+			obj.free_head = obj.free_tail = npos;
+			obj.count = 0;
+		}
+
+		slot_map_pool<Type, IndexBits> &operator=(slot_map_pool<Type, IndexBits> &&obj)
+		{
+			if(this != &obj)
+			{
+				slots = std::move(obj.slots);
+				free_head = obj.free_head;
+				free_tail = obj.free_tail;
+				count = obj.count;
+				seed = obj.seed;
+				peak = obj.peak;
+				allocations = obj.allocations;
+				frees = obj.frees;
+				obj.slots.clear();
+				obj.free_head = obj.free_tail = npos;
+				obj.count = 0;
+			}
+			return *this;
+		}
+	};
+}
+
+#endif